@@ -1,8 +1,17 @@
 require "benzo"
 
+# native apriori extension (build with "ruby extconf.rb && make" in
+# lib/apriori/ruby); without it the apriori executable is used
+begin
+	require_relative "../lib/apriori/ruby/apriori_ext"
+rescue LoadError
+end
+
 class AR
 	attr_accessor :args
 	def initialize(minsup=10,confidence=80)
+		@minsup = minsup
+		@confidence = confidence
 		@args = {}
 		@args["-tr"] = true
 		@args["-s" + minsup.to_s] = true if minsup != nil
@@ -15,6 +24,10 @@ class AR
 	end
 
 	def generate_association_rules(infile, outfile)
+		if defined?(Apriori)
+			return generate_association_rules_native(infile)
+		end
+
 		@args[infile] = true
 		@args[outfile] = true
 		puts ""
@@ -37,7 +50,34 @@ class AR
 		pruned_rules = prune_association_rules(outfile, labels)
 
 		# sort rules in descending order of confidence
-		sorted_rules = pruned_rules.sort {|a,b| b["confidence"].to_f <=> a["confidence"].to_f}
+		sorted_rules = pruned_rules.sort {|a,b| b["confidence"] <=> a["confidence"]}
+	end
+
+	# mine the rules in-process with the native extension: the rules
+	# are passed to a block as item names and numbers, so there is no
+	# output file to write and no rule text to parse
+	private
+	def generate_association_rules_native(infile)
+		labels = extract_class_labels(infile)
+		transactions = File.readlines(infile).map { |line| line.split(" ") }
+		validrules = []
+		actualsize = 0
+		Apriori.rules(transactions, @minsup, @confidence, 1) do |head, body, supp, conf|
+			actualsize = actualsize + 1
+
+			# keep rules with antecedents and a valid class label
+			if labels.has_key?(head) == true and body.empty? != true
+				rules = {}
+				rules["rule"] = head + " <- " + body.join(" ")
+				rules["support"] = supp
+				rules["confidence"] = conf
+				validrules.push(rules)
+			end
+		end
+
+		puts "Total number of rules from apriori: " + actualsize.to_s
+		puts "Total valid rules: " + validrules.size.to_s
+		validrules.sort {|a,b| b["confidence"] <=> a["confidence"]}
 	end
 
 	private
@@ -68,8 +108,9 @@ class AR
 				# ignore rules that do not have antecedents
 				if tokens[0].strip.end_with?("<-") != true
 					rules["rule"] = tokens[0]
-					rules["support"] = tokens[1]
-					rules["confidence"] = tokens[2]
+					# numbers as in the native path (Float)
+					rules["support"] = tokens[1].to_f
+					rules["confidence"] = tokens[2].to_f
 					validrules.push(rules)
 				end
 			end
@@ -143,13 +143,14 @@ typedef struct {                /* --- apriori execution data --- */
   int    mode;                  /* processing mode */
   TATREE *tatree;               /* transaction tree */
   ISTREE *istree;               /* item set tree (for counting) */
+  TIDIDX *tidx;                 /* vertical index (bitmaps) */
   int    *map;                  /* identifier map for filtering */
+  clock_t time;                 /* timer for output measurements */
 } APRIORI;                      /* (apriori execution data) */
 
 /*----------------------------------------------------------------------
   Constants
 ----------------------------------------------------------------------*/
-#if !defined NOMAIN && !defined QUIET
 /* --- error messages --- */
 static const char *errmsgs[] = {
   /* E_NONE      0 */  "no error",
@@ -172,6 +173,10 @@ static const char *errmsgs[] = {
   /* E_SIGLVL  -17 */  "invalid significance level/p-value %g",
   /*           -18 */  "unknown error"
 };
+
+#if !defined NOMAIN && !defined APRIACC
+/* --- evaluation measure characters (index is RE_* code) --- */
+static const char mchars[] = "xocdlaqverznpytighfms";
 #endif
 
 /*----------------------------------------------------------------------
@@ -197,34 +202,46 @@ static int cleanup (APRIORI *data)
     if (data->map)    free(data->map);
     if (data->istree) ist_delete(data->istree);
     if (data->tatree) tat_delete(data->tatree, 0);
+    if (data->tidx)   tix_delete(data->tidx);
   }                             /* free all allocated memory */
   return -1;                    /* return an error indicator */
 }  /* cleanup() */
 
 /*--------------------------------------------------------------------*/
 
-int apriori (TABAG *tabag, int target, int mode, int supp, int smax,
-             double conf, int eval, int agg, double thresh,
-             double minimp, int prune, double filter, int dir,
-             ISREPORT *report)
-{                               /* --- apriori algorithm */
+static int search (APRIORI *a, TABAG *tabag, int target, int mode,
+                   int supp, int smax, double conf, int eval, int agg,
+                   double thresh, double minimp, int prune,
+                   double filter, int dir, ISREPORT *report)
+{                               /* --- build the item set tree */
   int     i, k, n;              /* loop variables, buffers */
   int     size, max;            /* current/maximal item set size */
-  int     frq, body, head;      /* frequency of an item set */
   clock_t t, tt, tc, x;         /* timers for measurements */
-  APRIORI a = { 0, NULL, NULL, NULL };  /* apriori execution data */
+  #ifdef BENCH                  /* if benchmark version, */
+  clock_t ts = 0;               /* sum of the counting times */
+  #endif
 
-  assert(tabag && report);      /* check the function arguments */
-  a.mode = mode;                /* note the processing mode */
+  /* --- create vertical index --- */
+  if ((mode & APR_BITMAP)       /* if bitmap counting is allowed, */
+  &&  (tbg_itemcnt(tabag) <= APR_BMAPMAX)   /* there are few items */
+  &&  (tbg_extent(tabag)  >= APR_BMAPLEN *(double)tbg_cnt(tabag))) {
+    t = clock();                /* and the transactions are long */
+    XMSG(stderr, "building item bitmaps ... ");
+    a->tidx = tix_create(tabag, TIX_BITMAP);
+    if (a->tidx) {              /* create bitmaps for all items */
+      XMSG(stderr, "[%d word(s)]", tix_words(a->tidx));
+      XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t)); }
+    else XMSG(stderr, "failed, using horizontal counting.\n");
+  }                             /* (fall back to normal counting) */
 
   /* --- create transaction tree --- */
   tt = 0;                       /* init. the tree construction time */
-  if (mode & APR_TATREE) {      /* if to use a transaction tree */
+  if ((mode & APR_TATREE) && !a->tidx) { /* if to use a trans. tree */
     t = clock();                /* start the timer for construction */
     XMSG(stderr, "building transaction tree ... ");
-    a.tatree = tat_create(tabag);  /* create a transaction tree */
-    if (!a.tatree) return cleanup(&a);
-    XMSG(stderr, "[%d node(s)]", tat_size(a.tatree));
+    a->tatree = tat_create(tabag); /* create a transaction tree */
+    if (!a->tatree) return cleanup(a);
+    XMSG(stderr, "[%d node(s)]", tat_size(a->tatree));
     XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
     tt = clock() -t;            /* note the time for the construction */
   }                             /* of the transaction tree */
@@ -235,42 +252,41 @@ int apriori (TABAG *tabag, int target, int mode, int supp, int smax,
   ||  dir)                      /* if individual counters needed, */
     mode &= ~IST_PERFECT;       /* remove perfect extension pruning */
   t = clock(); tc = 0;          /* start the timer for the search */
-  a.istree = ist_create(tbg_base(tabag), mode, supp, smax, conf);
-  if (!a.istree) return cleanup(&a);
+  a->istree = ist_create(tbg_base(tabag), mode, supp, smax, conf);
+  if (!a->istree) return cleanup(a);
   max = isr_max(report);        /* create an apriori item set tree */
   if ((k = tbg_max(tabag)) < max) max = k;
-  ist_setsize(a.istree, isr_min(report), max, dir);
-  if ((eval & ~IST_INVBXS) <= RE_NONE) prune = INT_MIN;
-  ist_seteval(a.istree, eval, agg, thresh, minimp, prune);
-  eval &= ~IST_INVBXS;          /* configure apriori item set tree */
+  ist_setsize(a->istree, isr_min(report), max, dir);
+  ist_seteval(a->istree, eval, agg, thresh, minimp, prune);
 
   /* --- check item subsets --- */
   XMSG(stderr, "checking subsets of size 1");
   n = tbg_itemcnt(tabag);       /* create an item filter map */
-  a.map = (int*)malloc(n *sizeof(int));
-  if (!a.map) return cleanup(&a);
+  a->map = (int*)malloc(n *sizeof(int));
+  if (!a->map) return cleanup(a);
   for (i = n; 1; ) {            /* traverse the item set sizes */
-    size = ist_height(a.istree);/* get the current item set size */
+    size = ist_height(a->istree);  /* get the current item set size */
     if (size >= max) break;     /* abort if maximal size is reached */
     if ((filter != 0)           /* if to filter w.r.t. item usage */
-    && ((i = ist_check(a.istree, a.map)) <= size))
+    && ((i = ist_check(a->istree, a->map)) <= size))
       break;                    /* check which items are still used */
     if (mode & APR_POST)        /* if a-posteriori pruning requested, */
-      ist_prune(a.istree);      /* prune infrequent item sets */
-    k = ist_addlvl(a.istree);   /* add a level to the item set tree */
-    if (k < 0) return cleanup(&a);
+      ist_prune(a->istree);     /* prune infrequent item sets */
+    k = ist_addlvl(a->istree);  /* add a level to the item set tree */
+    if (k < 0) return cleanup(a);
     if (k > 0) break;           /* if no level was added, abort */
-    if (((filter < 0)           /* if to filter w.r.t. item usage */
+    if (!a->tidx                /* if not counting with bitmaps */
+    &&  (((filter < 0)          /* and to filter w.r.t. item usage */
     &&   (i < -filter *n))      /* and enough items were removed */
     ||  ((filter > 0)           /* or counting time is long enough */
-    &&   (i < n) && (i *(double)tt < filter *n *tc))) {
+    &&   (i < n) && (i *(double)tt < filter *n *tc)))) {
       n = i;                    /* note the new number of items */
       x = clock();              /* start the timer for filtering */
-      if (a.tatree) {           /* if a transaction tree was created */
-        if (tat_filter(a.tatree, size+1, a.map, 0) != 0)
-          return cleanup(&a); } /* filter the transaction tree */
+      if (a->tatree) {          /* if a transaction tree was created */
+        if (tat_filter(a->tatree, size+1, a->map, 0) != 0)
+          return cleanup(a); }  /* filter the transaction tree */
       else {                    /* if there is only a transaction bag */
-        tbg_filter(tabag, size+1, a.map, 0);
+        tbg_filter(tabag, size+1, a->map, 0);
         tbg_sort  (tabag, 0,0); /* remove unnecessary items and */
         tbg_reduce(tabag, 0);   /* transactions and reduce */
       }                         /* transactions to unique ones */
@@ -279,66 +295,115 @@ int apriori (TABAG *tabag, int target, int mode, int supp, int smax,
     ++size;                     /* increment the item set size */
     XMSG(stderr, " %d", size);  /* print the current item set size */
     x = clock();                /* start the timer for counting */
-    if (a.tatree) ist_countx(a.istree, a.tatree);
-    else          ist_countb(a.istree, tabag);
-    ist_commit(a.istree);       /* count the transaction tree/bag */
+    if      (a->tidx) {         /* if bitmaps are available */
+      if (ist_countv(a->istree, a->tidx) != 0)
+        return cleanup(a); }    /* count with bitmap intersections */
+    else if (a->tatree) ist_countx(a->istree, a->tatree);
+    else                ist_countb(a->istree, tabag);
+    ist_commit(a->istree);      /* count the transaction tree/bag */
     tc = clock() -x;            /* compute the new counting time */
+    #ifdef BENCH                /* if benchmark version, */
+    ts += tc;                   /* sum the counting times */
+    #endif
   }
-  free(a.map); a.map = NULL;    /* delete filter map and trans. tree */
-  if (!(mode & APR_NOCLEAN) && a.tatree) {
-    tat_delete(a.tatree, 0); a.tatree = NULL; }
+  free(a->map); a->map = NULL;  /* delete filter map and trans. tree */
+  if (!(mode & APR_NOCLEAN) && a->tatree) {
+    tat_delete(a->tatree, 0); a->tatree = NULL; }
+  if (!(mode & APR_NOCLEAN) && a->tidx) {
+    tix_delete(a->tidx);      a->tidx   = NULL; }
   XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  #ifdef BENCH                  /* if benchmark version, */
+  printf("time for counting passes   : %.2fs\n",
+         ts /(double)CLOCKS_PER_SEC);
+  #endif                        /* print the counting time */
+  return size;                  /* return the maximal set size */
+}  /* search() */
+
+/*--------------------------------------------------------------------*/
+
+static int output (APRIORI *a, int target, int mode, int size,
+                   int eval, double thresh, double minimp,
+                   int prune, int dir, ISREPORT *report)
+{                               /* --- filter and report item sets */
+  int     k;                    /* buffer for the set/rule size */
+  int     frq, body, head;      /* frequency of an item set */
 
   /* --- filter found item sets --- */
   if ((prune >  INT_MIN)        /* if to filter with evaluation */
   &&  (prune <= 0)) {           /* (backward and weak forward) */
-    t = clock();                /* start the timer for filtering */
+    a->time = clock();          /* start the timer for filtering */
     XMSG(stderr, "filtering with evaluation ... ");
-    ist_filter(a.istree,prune); /* mark non-qualifying item sets */
-    XMSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
+    ist_filter(a->istree,prune);/* mark non-qualifying item sets */
+    XMSG(stderr, "done [%.2fs].\n", SEC_SINCE(a->time));
   }                             /* filter with evaluation */
   if (target & (ISR_CLOSED|ISR_MAXIMAL|ISR_GENERA)) {
-    t = clock();                /* start the timer for filtering */
+    a->time = clock();          /* start the timer for filtering */
     XMSG(stderr, "filtering for %s item sets ... ",
          (target == ISR_GENERA) ? "generator" :
          (target == ISR_CLOSED) ? "closed" : "maximal");
-    ist_clomax(a.istree, target | ((prune > INT_MIN) ? IST_SAFE : 0));
-    XMSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
+    ist_clomax(a->istree, target | ((prune > INT_MIN) ? IST_SAFE : 0));
+    XMSG(stderr, "[%ld check(s), %ld avoided] ",
+         ist_chkcnt(a->istree), ist_avdcnt(a->istree));
+    XMSG(stderr, "done [%.2fs].\n", SEC_SINCE(a->time));
   }                             /* filter closed/maximal/generators */
 
   /* --- report item sets/rules --- */
-  t = clock();                  /* start the output timer */
+  a->time = clock();            /* start the output timer */
   XMSG(stderr, "writing %s ... ", isr_name(report));
-  ist_init(a.istree);           /* initialize the extraction */
+  ist_init(a->istree);          /* initialize the extraction */
   if (target == ISR_RULE) {     /* if to find association rules */
-    a.map = (int*)malloc((size+1) *sizeof(int));
-    if (!a.map) return cleanup(&a);  /* create an item set buffer */
+    a->map = (int*)malloc((size+1) *sizeof(int));
+    if (!a->map) return cleanup(a); /* create an item set buffer */
     while (1) {                 /* extract assoc. rules from tree */
-      k = ist_rule(a.istree, a.map, &frq, &body, &head, &thresh);
+      k = ist_rule(a->istree, a->map, &frq, &body, &head, &thresh);
       if (k < 0) break;         /* get the next association rule */
-      isr_rule(report, a.map, k, frq, body, head, thresh);
+      isr_rule(report, a->map, k, frq, body, head, thresh);
     }                           /* report the extracted ass. rule */
-    free(a.map); a.map = NULL;} /* delete the item set buffer */
+    isr_topout(report);         /* report the best rules if collected */
+    free(a->map); a->map = NULL; }   /* delete the item set buffer */
   else if (dir) {               /* if to find frequent item sets */
-    a.map = (int*)malloc((size+1) *sizeof(int));
-    if (!a.map) return cleanup(&a);   /* create an item set buffer */
+    a->map = (int*)malloc((size+1) *sizeof(int));
+    if (!a->map) return cleanup(a); /* create an item set buffer */
     while (1) {                 /* extract item sets from the tree */
-      k = ist_set(a.istree, a.map, &frq, &thresh);
+      k = ist_set(a->istree, a->map, &frq, &thresh);
       if (k < 0) break;         /* get the next frequent item set */
-      isr_direct(report, a.map, k, frq, thresh, thresh);
+      isr_direct(report, a->map, k, frq, thresh, thresh);
     }                           /* report the extracted item set */
-    free(a.map); a.map = NULL;} /* delete the item set buffer */
+    free(a->map); a->map = NULL; }   /* delete the item set buffer */
   else {                        /* if not to sort item sets by size */
     if     ((eval == IST_LDRATIO)  /* if to compute add. evaluation */
     &&     (minimp <= -INFINITY))  /* but no min. improvement req. */
-      isr_seteval(report, isr_logrto,  NULL,   +1,           thresh);
+      isr_seteval(report, isr_logrto,  NULL,      +1,        thresh);
     else if (eval >  IST_NONE)  /* set the add. evaluation function */
-      isr_seteval(report, ist_evalx, a.istree, re_dir(eval), thresh);
-    ist_report(a.istree,report);/* recursively report the item sets */
+      isr_seteval(report, ist_evalx, a->istree, re_dir(eval), thresh);
+    ist_report(a->istree, report); /* recursively report item sets */
   }  /* if (target == ISR_RULE) .. else if (dir) .. else .. */
   XMSG(stderr, "[%ld %s(s)]", isr_repcnt(report),
                (target == ISR_RULE) ? "rule" : "set");
-  XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(a->time));
+  return 0;                     /* return 'ok' */
+}  /* output() */
+
+/*--------------------------------------------------------------------*/
+
+int apriori (TABAG *tabag, int target, int mode, int supp, int smax,
+             double conf, int eval, int agg, double thresh,
+             double minimp, int prune, double filter, int dir,
+             ISREPORT *report)
+{                               /* --- apriori algorithm */
+  int     size;                 /* maximal item set size */
+  APRIORI a = { 0, NULL, NULL, NULL, NULL, 0 }; /* exec. data */
+
+  assert(tabag && report);      /* check the function arguments */
+  a.mode = mode;                /* note the processing mode */
+  if ((eval & ~IST_INVBXS) <= RE_NONE) prune = INT_MIN;
+  size = search(&a, tabag, target, mode, supp, smax, conf, eval, agg,
+                thresh, minimp, prune, filter, dir, report);
+  if (size < 0) return -1;      /* build the item set tree */
+  eval &= ~IST_INVBXS;          /* and report the item sets/rules */
+  if (output(&a, target, mode, size, eval, thresh, minimp,
+             prune, dir, report) != 0)
+    return -1;                  /* (memory is freed on error) */
   #ifdef BENCH                  /* if benchmark version, */
   ist_stats(a.istree);          /* show the search statistics */
   #endif                        /* (especially memory usage) */
@@ -347,6 +412,130 @@ int apriori (TABAG *tabag, int target, int mode, int supp, int smax,
   return 0;                     /* return 'ok' */
 }  /* apriori() */
 
+/*--------------------------------------------------------------------*/
+
+int apr_sweep (TABAG *tabag, int target, int mode, const int *supps,
+               const double *confs, int cnt, int smax, int eval,
+               int agg, double thresh, double minimp, int prune,
+               double filter, int dir, ISREPORT **reps)
+{                               /* --- apriori with param. sweep */
+  int     i;                    /* loop variable */
+  int     size;                 /* maximal item set size */
+  int     supp;                 /* minimum support    (over settings) */
+  double  conf;                 /* minimum confidence (over settings) */
+  clock_t t;                    /* timer for measurements */
+  APRIORI a = { 0, NULL, NULL, NULL, NULL, 0 }; /* exec. data */
+
+  assert(tabag && supps && confs && (cnt > 0) && reps);
+  a.mode = mode;                /* note the processing mode */
+  supp = supps[0]; conf = confs[0];
+  for (i = 1; i < cnt; i++) {   /* find the smallest thresholds */
+    if (supps[i] < supp) supp = supps[i];
+    if (confs[i] < conf) conf = confs[i];
+  }                             /* (mine once for all settings) */
+  if ((eval & ~IST_INVBXS) <= RE_NONE) prune = INT_MIN;
+  t = clock();                  /* start the timer for the search */
+  size = search(&a, tabag, target, mode, supp, smax, conf, eval, agg,
+                thresh, minimp, prune, filter, dir, reps[0]);
+  if (size < 0) return -1;      /* build the item set tree */
+  t = clock() -t;               /* note the time for the search */
+  eval &= ~IST_INVBXS;          /* and report the item sets/rules */
+  for (i = 0; i < cnt; i++) {   /* for each of the settings */
+    ist_setsupp(a.istree, supps[i], smax, confs[i]);
+    if (output(&a, target, mode, size, eval, thresh, minimp,
+               prune, dir, reps[i]) != 0)
+      return -1;                /* set the thresholds and report */
+  }                             /* the qualifying item sets/rules */
+  #ifdef BENCH                  /* if benchmark version, */
+  ist_stats(a.istree);          /* show the search statistics */
+  #endif                        /* (especially memory usage) */
+  if (!(mode & APR_NOCLEAN)) {  /* delete the apriori item set tree */
+    ist_delete(a.istree); a.istree = NULL; }
+  XMSG(stderr, "[%d setting(s), search time %.2fs, ", cnt,
+               t /(double)CLOCKS_PER_SEC);
+  XMSG(stderr, "at most %.2fs of search time saved]\n",
+               (cnt-1) *(t /(double)CLOCKS_PER_SEC));
+  return 0;                     /* return 'ok' */
+}  /* apr_sweep() */
+
+/* The search is carried out only once with the lowest thresholds,    */
+/* so separate runs for the other settings would take at most as long */
+/* as this search (and less with higher thresholds). Hence the saved  */
+/* search time is only an upper bound, while the reading and          */
+/* preprocessing (see main()) would be repeated in full.              */
+
+/*----------------------------------------------------------------------
+  Apriori Algorithm (with in-memory transactions)
+----------------------------------------------------------------------*/
+
+int apr_mem (CCHAR **items, int n, int target, double supp,
+             double conf, int eval, double thresh, int min, int max,
+             ISREPOFN *repofn, void *data)
+{                               /* --- apriori on item name arrays */
+  int      i, k, w;             /* loop variable, buffers */
+  int      mode;                /* search mode */
+  double   filter = 0.01;       /* item usage filtering parameter */
+  ITEMBASE *base;               /* item base for the item names */
+  TABAG    *bag;                /* transaction bag to mine */
+  ISREPORT *rep;                /* item set reporter (no file) */
+
+  assert(items && (n >= 0) && repofn); /* check the arguments */
+  base = ib_create(0, 0);       /* create an item base */
+  if (!base) return E_NOMEM;    /* to manage the items */
+  bag = tbg_create(base);       /* create a transaction bag */
+  if (!bag) { ib_delete(base); return E_NOMEM; }
+  for (i = 0; i < n; i++) {     /* traverse the transactions */
+    ib_clear(base);             /* clear the transaction buffer */
+    for ( ; *items; items++)    /* and add the items of the trans. */
+      if (ib_add2ta(base, *items) < 0) break;
+    if (*items++) { tbg_delete(bag, 1); return E_NOMEM; }
+    ib_finta(base, 1);          /* finalize the transaction and */
+    if (tbg_add(bag, NULL) != 0) {  /* add it to the bag */
+      tbg_delete(bag, 1); return E_NOMEM; }
+  }                             /* (items list ends with NULL) */
+  k = ib_cnt(base);             /* get the number of items */
+  w = tbg_wgt(bag);             /* and the total transaction weight */
+  if ((k <= 0) || (n <= 0)) { tbg_delete(bag, 1); return E_NOITEMS; }
+  mode = APP_BODY|IST_PERFECT|APR_TATREE|APR_BITMAP;
+  if (target < ISR_RULE) {      /* remove rule specific settings */
+    mode |= APP_BOTH; conf = 100; }
+  supp    = (supp >= 0) ? 0.01 *supp *w : -supp;
+  conf   *= 0.01;               /* transform support and confidence */
+  thresh *= 0.01;               /* and the evaluation threshold */
+  k = (int)ceil((mode & APP_HEAD) ? supp : supp *conf);
+  k = tbg_recode(bag, k, -1, -1, 2);
+  if (k <= 0) {                 /* recode items and transactions */
+    tbg_delete(bag, 1); return (k < 0) ? E_NOMEM : E_NOITEMS; }
+  if (eval <= RE_NONE)          /* remove items of short transactions */
+    tbg_filter(bag, min, NULL, 0);   /* if it does not affect */
+  else filter = 0;              /* the evaluation (suppress later */
+  tbg_itsort(bag, +1, 0);       /* filtering otherwise), sort items */
+  tbg_sort  (bag, +1, 0);       /* and transactions and reduce */
+  tbg_reduce(bag, 0);           /* transactions to unique ones */
+  rep = isr_create(base, 0, -1, "", " ", " <- ");
+  if (!rep) { tbg_delete(bag, 1); return E_NOMEM; }
+  isr_setsize(rep, min, max);   /* create an item set reporter */
+  isr_setrepo(rep, repofn, data);     /* and set the size range */
+  isr_open(rep, NULL, NULL);    /* and the reporting function */
+  k = apriori(bag, target, mode, (int)ceil(supp), w, conf, eval,
+              IST_NONE, thresh, -INFINITY, INT_MIN, filter, 0, rep);
+  if (k == 0) k = (int)isr_repcnt(rep);  /* execute apriori */
+  isr_delete(rep, 0);           /* delete the item set reporter */
+  tbg_delete(bag, 1);           /* and the transaction bag */
+  return (k < 0) ? E_NOMEM : k; /* return the number of sets/rules */
+}  /* apr_mem() */
+
+/*--------------------------------------------------------------------*/
+
+const char* apr_errmsg (int err)
+{                               /* --- get an error message */
+  int k = 1-(int)(sizeof(errmsgs)/sizeof(char*));
+
+  if (err > 0) err = 0;         /* check and adapt the error code */
+  if (err < k) err = k;         /* (codes returned by apr_mem()) */
+  return errmsgs[-err];         /* return the message (format) */
+}  /* apr_errmsg() */
+
 /*----------------------------------------------------------------------
   Main Functions
 ----------------------------------------------------------------------*/
@@ -748,11 +937,30 @@ int main (int argc, char *argv[])
   int     prune    = INT_MIN;   /* (min. size for) evaluation pruning */
   int     sort     = 2;         /* flag for item sorting and recoding */
   double  filter   = 0.01;      /* item usage filtering parameter */
-  int     mode     = APP_BODY|IST_PERFECT|APR_TATREE;  /* search mode */
+  int     mode     = APP_BODY|IST_PERFECT  /* search mode */
+                   | APR_TATREE|APR_BITMAP;
   int     dir      = 0;         /* direction for size sorting */
   int     mtar     = 0;         /* mode for transaction reading */
   int     mrep     = 0;         /* mode for item set reporting */
   int     stats    = 0;         /* flag for item set statistics */
+  long    obuf     = 0;         /* size of output buffer (in kB) */
+  int     async    = 0;         /* flag for asynchronous writing */
+  int     topn     = 0;         /* number of best rules to keep */
+  int     topm     = 'c';       /* measure for selecting the rules */
+  int     shards   = 0;         /* number of output shards */
+  int     shkey    = ISR_SHHEAD;/* key for assigning shards */
+  int     rdthd    = 1;         /* number of threads for reading */
+  int     rdbuf    = 0;         /* number of read-ahead buffers */
+  CCHAR   *sweep   = NULL;      /* list of support/conf. settings */
+  int     cnt      = 1;         /* number of parameter settings */
+  double  *ssupp   = &supp;     /* minimum supports    of settings */
+  double  *sconf   = &conf;     /* minimum confidences of settings */
+  int     *supps   = NULL;      /* absolute minimum supports */
+  ISREPORT **reps  = &report;   /* item set reporters of settings */
+  CCHAR   **names  = &fn_out;   /* output file names  of settings */
+  char    *buf;                 /* buffer for the output file names */
+  void    *swp     = NULL;      /* memory block for parameter sweep */
+  double  tprep    = 0;         /* time for reading/preprocessing */
   clock_t t;                    /* timers for measurements */
 
   #ifndef QUIET                 /* if not quiet version */
@@ -790,6 +998,11 @@ int main (int argc, char *argv[])
                     "(default: none)\n");
     printf("-d#      threshold for add. evaluation measure    "
                     "(default: %g%%)\n", thresh);
+    printf("-N#      keep only the best # association rules   "
+                    "(default: all)\n");
+    printf("-K#      measure for selecting the best rules     "
+                    "(default: %c)\n", topm);
+    printf("         (same identifiers as for option -e)\n");
     printf("-i#      least improvement of evaluation measure  "
                     "(default: no limit)\n");
     printf("         (not applicable with evaluation averaging, "
@@ -814,10 +1027,29 @@ int main (int argc, char *argv[])
                     "(default: prune)\n");
     printf("-y       a-posteriori pruning of infrequent item sets\n");
     printf("-T       do not organize transactions as a prefix tree\n");
+    printf("-B       do not count with item bitmaps "
+                    "(default: if <= %d items and\n", APR_BMAPMAX);
+    printf("         avg. transaction size >= %d)\n", APR_BMAPLEN);
     printf("-Z       print item set statistics "
                     "(number of item sets per size)\n");
     printf("-g       write item names in scanable form "
                     "(quote certain characters)\n");
+    printf("-O       write item sets/rules in binary format "
+                    "(see repbin)\n");
+    printf("-j#      size of the output buffer in kB          "
+                    "(default: 64)\n");
+    printf("-A       write output asynchronously "
+                    "(separate thread)\n");
+    printf("-P#      distribute the output over # shard files "
+                    "(default: 1)\n");
+    printf("         (outfile is a manifest, the shards are "
+                     "outfile.0, outfile.1 etc.)\n");
+    printf("-H       assign rules to shards by a hash value "
+                    "(default: by head)\n");
+    printf("-W#      parameter sweep: list of settings "
+                    "supp[:conf],... (one search)\n");
+    printf("         (outfile is a name stem, the outputs are "
+                     "outfile.s<supp>c<conf>)\n");
     printf("-h#      record header  for output                "
                     "(default: \"%s\")\n", hdr);
     printf("-k#      item separator for output                "
@@ -831,6 +1063,14 @@ int main (int argc, char *argv[])
     printf("         (< 0: descending, > 0: ascending order)\n");
     printf("-w       integer transaction weight in last field "
                     "(default: only items)\n");
+    printf("-M       merge duplicate transactions on reading  "
+                    "(less memory)\n");
+    printf("-R#      number of threads for reading the input  "
+                    "(default: %d)\n", rdthd);
+    printf("         (and for recoding and sorting the items)\n");
+    printf("-L#      number of read-ahead buffers (%dMB each)  "
+                    "(default: none)\n", TRD_RINGSIZE >> 20);
+    printf("         (separate thread, for pipes/compressed input)\n");
     printf("-r#      record/transaction separators            "
                     "(default: \"\\n\")\n");
     printf("-f#      field /item        separators            "
@@ -851,7 +1091,7 @@ int main (int argc, char *argv[])
     return 0;                   /* print a usage message */
   }                             /* and abort the program */
   #endif  /* #ifndef QUIET */
-  /* free option characters: j[A-Z]\[CIST] */
+  /* free option characters: [A-Z]\[ABCHIKLMNOPRSTWZ] */
 
   /* --- evaluate arguments --- */
   for (i = 1; i < argc; i++) {  /* traverse the arguments */
@@ -871,6 +1111,8 @@ int main (int argc, char *argv[])
           case 'e': eval   = (*s) ? *s++ : 0;       break;
           case 'a': agg    = (*s) ? *s++ : 0;       break;
           case 'd': thresh =      strtod(s, &s);    break;
+          case 'N': topn   = (int)strtol(s, &s, 0); break;
+          case 'K': topm   = (*s) ? *s++ : 0;       break;
           case 'i': minimp =      strtod(s, &s);    break;
           case 'z': invbxs = IST_INVBXS;            break;
           case 'p': prune  = (int)strtol(s, &s, 0); break;
@@ -879,14 +1121,24 @@ int main (int argc, char *argv[])
           case 'x': mode  &= ~IST_PERFECT;          break;
           case 'y': mode  |=  APR_POST;             break;
           case 'T': mode  &= ~APR_TATREE;           break;
+          case 'B': mode  &= ~APR_BITMAP;           break;
           case 'Z': stats  = 1;                     break;
-          case 'g': mrep   = ISR_SCAN;              break;
+          case 'g': mrep  |= ISR_SCAN;              break;
+          case 'O': mrep  |= ISR_BINARY;            break;
+          case 'j': obuf   =      strtol(s, &s, 0); break;
+          case 'A': async  = 1;                     break;
+          case 'P': shards = (int)strtol(s, &s, 0); break;
+          case 'H': shkey  = ISR_SHHASH;            break;
+          case 'W': optarg = &sweep;                break;
           case 'h': optarg = &hdr;                  break;
           case 'k': optarg = &sep;                  break;
           case 'I': optarg = &imp;                  break;
           case 'v': optarg = &format;               break;
           case 'l': dir    = (int)strtol(s, &s, 0); break;
           case 'w': mtar  |= TA_WEIGHT;             break;
+          case 'M': mtar  |= TA_MERGE;              break;
+          case 'R': rdthd  = (int)strtol(s, &s, 0); break;
+          case 'L': rdbuf  = (int)strtol(s, &s, 0); break;
           case 'r': optarg = &recseps;              break;
           case 'f': optarg = &fldseps;              break;
           case 'b': optarg = &blanks;               break;
@@ -946,6 +1198,9 @@ int main (int argc, char *argv[])
     case 'b': eval = IST_LDRATIO;            break;
     default : error(E_MEASURE, (char)eval);  break;
   }  /* free: j k u w x */
+  if (!topm || !(s = strchr(mchars, topm)))
+    error(E_MEASURE, (char)topm);   /* translate the measure for */
+  topm = (int)(s -mchars);      /* selecting the best rules */
   switch (agg) {                /* check and translate agg. mode */
     case 'x': agg = IST_NONE;                break;
     case 'm': agg = IST_MIN;                 break;
@@ -966,12 +1221,45 @@ int main (int argc, char *argv[])
   }                             /* select absolute/relative support */
   MSG(stderr, "\n");            /* terminate the startup message */
 
+  /* --- parse parameter sweep --- */
+  if (sweep && (!fn_out || !*fn_out)) {
+    MSG(stderr, "warning: parameter sweep needs an output file\n");
+    sweep = NULL;               /* the output files are named */
+  }                             /* after the given output file */
+  if (sweep) {                  /* if a parameter sweep is requested */
+    for (s = (char*)sweep; *s; s++) if (*s == ',') cnt++;
+    k   = (int)strlen(fn_out) +64;  /* count the settings and */
+    swp = malloc((size_t)cnt *(2*sizeof(double) +sizeof(ISREPORT*)
+                 +sizeof(CCHAR*) +sizeof(int) +(size_t)k));
+    if (!swp) error(E_NOMEM);   /* allocate memory for the settings */
+    ssupp = (double*)swp;       sconf = ssupp +cnt;
+    reps  = (ISREPORT**)(sconf +cnt);
+    names = (CCHAR**)(reps +cnt);
+    supps = (int*)(names +cnt); buf   = (char*)(supps +cnt);
+    for (s = (char*)sweep, i = 0; i < cnt; i++) {
+      ssupp[i] = strtod(s, &s); /* traverse the settings */
+      sconf[i] = (*s == ':') ? strtod(s+1, &s) : conf;
+      if (*s && (*s++ != ',')) error(E_OPTARG);
+      if (ssupp[i] > 100) error(E_SUPPORT, ssupp[i]);
+      if ((sconf[i] < 0) || (sconf[i] > 100))
+        error(E_CONF, sconf[i]);/* check support and confidence */
+      if (target < ISR_RULE) sconf[i] = 100;
+      names[i] = buf;           /* build the output file name */
+      buf += sprintf(buf, "%s.s%g", fn_out, ssupp[i]);
+      if (target == ISR_RULE) buf += sprintf(buf, "c%g", sconf[i]);
+      reps[i] = NULL; buf++;    /* clear the item set reporter */
+    }                           /* (created after reading) */
+  }
+
   /* --- read item appearance indicators --- */
   ibase = ib_create(0, 0);      /* create an item base */
   if (!ibase) error(E_NOMEM);   /* to manage the items */
   tread = trd_create();         /* create a transaction reader */
   if (!tread) error(E_NOMEM);   /* and configure the characters */
   trd_allchs(tread, recseps, fldseps, blanks, "", comment);
+  if ((rdbuf > 0)               /* set the read-ahead buffers */
+  &&  (trd_prefetch(tread, rdbuf, TRD_RINGSIZE) != 0))
+    MSG(stderr, "warning: read-ahead thread not available\n");
   if (fn_app) {                 /* if item appearances are given */
     t = clock();                /* start timer, open input file */
     if (trd_open(tread, NULL, fn_app) != 0)
@@ -992,7 +1280,7 @@ int main (int argc, char *argv[])
   if (trd_open(tread, NULL, fn_inp) != 0)
     error(E_FOPEN, trd_name(tread));
   MSG(stderr, "reading %s ... ", trd_name(tread));
-  k = tbg_read(tabag, tread, mtar);
+  k = tbg_readpar(tabag, tread, mtar, rdthd);
   if (k < 0)                    /* read the transaction database */
     error(-k, tbg_errmsg(tabag, NULL, 0));
   trd_delete(tread, 1);         /* close the input file and */
@@ -1003,12 +1291,19 @@ int main (int argc, char *argv[])
   MSG(stderr, "[%d item(s), %d", k, n);
   if (w != n) MSG(stderr, "/%d", w);
   MSG(stderr, " transaction(s)] done [%.2fs].", SEC_SINCE(t));
+  tprep += SEC_SINCE(t);        /* sum the preprocessing time */
   if ((k <= 0) || (n <= 0))     /* check for at least one item */
     error(E_NOITEMS);           /* and at least one transaction */
   MSG(stderr, "\n");            /* terminate the log message */
-  supp    =       (supp >= 0) ? 0.01 *supp *w : -supp;
+  for (i = cnt; --i >= 0; ) {   /* traverse the parameter settings */
+    ssupp[i] = (ssupp[i] >= 0) ? 0.01 *ssupp[i] *w : -ssupp[i];
+    sconf[i] *= 0.01;           /* transform support and confidence */
+    if (!sweep) continue;       /* if to sweep over settings, */
+    supps[i] = (int)ceil(ssupp[i]);     /* get absolute support */
+    if ((i == cnt-1) || (ssupp[i] < supp)) supp = ssupp[i];
+    if ((i == cnt-1) || (sconf[i] < conf)) conf = sconf[i];
+  }                             /* mine with the smallest thresholds */
   smax    = floor((smax >= 0) ? 0.01 *smax *w : -smax);
-  conf   *= 0.01;               /* transform support and confidence */
   thresh *= 0.01;               /* and the eval. measure parameters */
   if (minimp > -INFINITY) minimp *= 0.01;
 
@@ -1016,10 +1311,11 @@ int main (int argc, char *argv[])
   t = clock();                  /* start timer, print log message */
   MSG(stderr, "filtering, sorting and recoding items ... ");
   k = (int)ceil((mode & APP_HEAD) ? supp : supp *conf);
-  k = tbg_recode(tabag, k, -1, -1, sort);
+  k = tbg_recodepar(tabag, k, -1, -1, sort, rdthd);
   if (k <  0) error(E_NOMEM);   /* recode items and transactions */
   if (k <= 0) error(E_NOITEMS); /* and check the number of items */
   MSG(stderr, "[%d item(s)] done [%.2fs].\n", k, SEC_SINCE(t));
+  tprep += SEC_SINCE(t);        /* sum the preprocessing time */
 
   /* --- sort and reduce transactions --- */
   t = clock();                  /* start timer, print log message */
@@ -1028,30 +1324,66 @@ int main (int argc, char *argv[])
   ||  (eval == IST_LDRATIO))    /* if it does not affect evaluation */
     tbg_filter(tabag, min, NULL, 0);
   else filter = 0;              /* suppress later filtering if nec. */
-  tbg_itsort(tabag, +1, 0);     /* sort items in transactions and */
+  tbg_itsortpar(tabag, +1, 0, rdthd); /* sort items in transactions */
   tbg_sort  (tabag, +1, 0);     /* sort the trans. lexicographically */
   n = tbg_reduce(tabag, 0);     /* reduce transactions to unique ones */
   MSG(stderr, "[%d", n); if (w != n) MSG(stderr, "/%d", w);
   MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
+  tprep += SEC_SINCE(t);        /* sum the preprocessing time */
 
   /* --- execute apriori algorithm --- */
   if (eval == IST_LDRATIO) mrep |= ISR_LOGS;
-  report = isr_create(ibase, mrep, -1, hdr, sep, imp);
-  if (!report) error(E_NOMEM);  /* create an item set reporter */
-  isr_setfmt (report, format);  /* and configure it: set mode, */
-  isr_setsize(report, min, max);/* info. format and size range */
-  if (isr_open(report, NULL, fn_out) != 0)
-    error(E_FOPEN, isr_name(report)); /* open the output file */
-  k = apriori(tabag, target, mode|APR_NOCLEAN|APR_VERBOSE,
-              (int)ceil(supp), (int)smax, conf, eval|invbxs,
-              agg, thresh, minimp, prune, filter, dir, report);
-  if (k) error(E_NOMEM);        /* execute the apriori algorithm */
-  if (stats)                    /* if requested, */
-    isr_prstats(report,stdout); /* print item set statistics */
-  if (isr_close(report) != 0)   /* close the output file */
-    error(E_FWRITE, isr_name(report));
+  if ((shards > 1) && (!fn_out || !*fn_out)) {
+    MSG(stderr, "warning: sharded output needs an output file\n");
+    shards = 0;                 /* shards need a proper file name */
+  }                             /* (they are named after it) */
+  for (i = 0; i < cnt; i++) {   /* traverse the parameter settings */
+    reps[i] = isr_create(ibase, mrep, -1, hdr, sep, imp);
+    if (!reps[i]) error(E_NOMEM);   /* create an item set reporter */
+    isr_setfmt (reps[i], format);   /* and configure it: set mode, */
+    isr_setsize(reps[i], min, max); /* info. format and size range */
+    if (((obuf > 0) || async)   /* set the write buffer size */
+    &&  ((k = isr_setbuf(reps[i], (size_t)obuf *1024, async)) != 0)) {
+      if (k < 0) error(E_NOMEM);/* (and asynchronous writing) */
+      if (i <= 0) MSG(stderr, "warning: asynchronous writing "
+                              "not available\n"); }
+    if ((topn > 0) && (target == ISR_RULE)
+    &&  (isr_settopn(reps[i], topn, re_function(topm),
+                     re_dir(topm)) != 0))
+      error(E_NOMEM);           /* keep only the best rules */
+    if ((shards > 1)            /* distribute the output */
+    &&  (isr_setshard(reps[i], shards,
+                      (target == ISR_RULE) ? shkey : ISR_SHHASH) != 0))
+      error(E_NOMEM);           /* over several shard files */
+    if (isr_open(reps[i], NULL, names[i]) != 0)
+      error(E_FOPEN, isr_name(reps[i]));   /* open the output file */
+    report = reps[0];           /* note the first reporter */
+  }                             /* (deleted by CLEANUP on error) */
+  if (sweep)                    /* mine once, report for each setting */
+    k = apr_sweep(tabag, target, mode|APR_NOCLEAN|APR_VERBOSE,
+                  supps, sconf, cnt, (int)smax, eval|invbxs,
+                  agg, thresh, minimp, prune, filter, dir, reps);
+  else                          /* execute the apriori algorithm */
+    k = apriori(tabag, target, mode|APR_NOCLEAN|APR_VERBOSE,
+                (int)ceil(supp), (int)smax, conf, eval|invbxs,
+                agg, thresh, minimp, prune, filter, dir, report);
+  if (k) error(E_NOMEM);        /* check for an error */
+  if (sweep)                    /* the input was read only once */
+    MSG(stderr, "[about %.2fs of reading/preprocessing saved]\n",
+                (cnt-1) *tprep);
+  for (i = 0; i < cnt; i++) {   /* traverse the reporters */
+    if (isr_close(reps[i]) != 0)/* close the output files */
+      error(E_FWRITE, isr_name(reps[i]));
+    if (!stats) continue;       /* if requested, print item set */
+    if (sweep) printf("%s:\n", isr_name(reps[i]));
+    isr_prstats(reps[i], stdout);  /* and output statistics */
+  }
 
   /* --- clean up --- */
+  #ifndef NDEBUG                /* if debug version */
+  while (--cnt > 0) isr_delete(reps[cnt], 0);
+  if (swp) free(swp);           /* delete the additional reporters */
+  #endif                        /* and the parameter settings */
   CLEANUP;                      /* clean up memory and close files */
   SHOWMEM;                      /* show (final) memory usage */
   return 0;                     /* return 'ok' */
@@ -15,6 +15,9 @@
 #define APR_VERBOSE   INT_MIN   /* verbose message output */
 #define APR_TATREE    (IST_PERFECT << 4)  /* use transaction tree */
 #define APR_POST      (APR_TATREE  << 1)  /* use a-posteriori pruning */
+#define APR_BITMAP    (APR_POST    << 2)  /* use bitmaps if few items */
+#define APR_BMAPMAX   256       /* max. number of items for bitmaps */
+#define APR_BMAPLEN   32        /* min. avg. trans. size for bitmaps */
 #ifdef NDEBUG
 #define APR_NOCLEAN   (APR_POST    << 1)
 #else
@@ -28,4 +31,13 @@ extern int apriori (TABAG *tabag, int target, int mode, int supp,
                     int smax, double conf, int eval, int aggm,
                     double minval, double minimp, int prune,
                     double filter, int dir, ISREPORT *rep);
+extern int apr_sweep (TABAG *tabag, int target, int mode,
+                      const int *supps, const double *confs, int cnt,
+                      int smax, int eval, int aggm, double minval,
+                      double minimp, int prune, double filter,
+                      int dir, ISREPORT **reps);
+extern int apr_mem (CCHAR **items, int n, int target, double supp,
+                    double conf, int eval, double thresh,
+                    int min, int max, ISREPOFN *repofn, void *data);
+extern const char* apr_errmsg (int err);
 #endif
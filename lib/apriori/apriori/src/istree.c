@@ -99,6 +99,7 @@
 ----------------------------------------------------------------------*/
 #define LN_2        0.69314718055994530942  /* ln(2) */
 #define BLKSIZE     32          /* block size for level array */
+#define BATCH       256         /* max. number of rule candidates */
 #define F_HDONLY    INT_MIN     /* flag for head only item in path */
 #define F_SKIP      INT_MIN     /* flag for subtree skipping */
 #define ITEMOF(n)   ((int)((n)->item & ~F_HDONLY))
@@ -108,6 +109,22 @@
 #define ITEMAT(n,i) (((n)->offset >= 0) ? (n)->offset +(i) \
                                         : (n)->cnts[(n)->size +(i)])
 
+/* --- search methods for identifier maps (negative offsets) --- */
+#define IST_MAPLIN  -1          /* linear search (merge with trans.) */
+#define IST_MAPVEC  -2          /* linear search without early exit */
+#define IST_MAPBIN  -3          /* galloping/branchless bin. search */
+#define IST_MAPEYT  -4          /* search in an Eytzinger layout */
+
+#ifndef TH_MAPVEC               /* maximal map size for SIMD search */
+#define TH_MAPVEC   16
+#endif
+#ifndef TH_MAPBIN               /* minimal map size for binary search */
+#define TH_MAPBIN   256
+#endif
+#ifndef TH_MAPEYT               /* minimal map size for Eytzinger */
+#define TH_MAPEYT   INT_MAX     /* (disabled by default, since the */
+#endif                          /* layout doubles the node size) */
+
 #ifdef ALIGN8                   /* if aligned 64 bit architecture, */
 #define PAD(x)      ((x) & 1)   /* pad to an even number, */
 #else                           /* otherwise (32 bit) */
@@ -122,23 +139,22 @@
 
 static int search (int id, ISTNODE **chn, int n)
 {                               /* --- find a child node (index) */
-  int i, k, x;                  /* left and middle index */
+  int     i, k;                 /* remaining range, half range */
+  ISTNODE **p;                  /* to traverse the child nodes */
 
   assert(chn && (n > 0));       /* check the function arguments */
-  for (i = 0; i < n; ) {        /* while the range is not empty */
-    k = (i+n) >> 1;             /* get index of the middle element */
-    x = ITEMOF(chn[k]);         /* compare the item identifier */
-    if      (id > x) i = k+1;   /* to the middle element and */
-    else if (id < x) n = k;     /* adapt the range boundaries */
-    else return k;              /* if there is an exact match, */
-  }                             /* return the child node index */
-  return -1-i;                  /* return the insertion position */
+  for (p = chn, i = n; i > 1; i -= k) {
+    k = i >> 1;                 /* halve the search range and */
+    p = (ITEMOF(p[k]) < id) ? p+k : p;
+  }                             /* move the start without branching */
+  i = (int)(p -chn) +((ITEMOF(*p) < id) ? 1 : 0);
+  return ((i < n) && (ITEMOF(chn[i]) == id)) ? i : -1-i;
 }  /* search() */
 
 /*--------------------------------------------------------------------*/
 
-static int getsupp (ISTNODE *node, int *items, int n)
-{                               /* --- get support of an item set */
+static int* getcnt (ISTNODE *node, int *items, int n)
+{                               /* --- get counter of an item set */
   int     i, k;                 /* array indices, number of children */
   int     *map;                 /* item identifier map */
   ISTNODE **chn;                /* child node array */
@@ -147,29 +163,37 @@ static int getsupp (ISTNODE *node, int *items, int n)
   &&    (n >= 0) && (items || (n <= 0)));
   while (--n > 0) {             /* follow the set/path from the node */
     k = CHILDCNT(node);         /* if there are no children, */
-    if (k <= 0) return F_SKIP;  /* the support is less than minsupp */
+    if (k <= 0) return NULL;    /* the item set is not in the tree */
     if (node->offset >= 0) {    /* if a pure array is used */
       chn = (ISTNODE**)(node->cnts +node->size +PAD(node->size));
       i = *items++ -ITEMOF(chn[0]); /* compute the child array index, */
-      if (i >= k) return F_SKIP; }  /* abort if child does not exist */
+      if (i >= k) return NULL; }    /* abort if child does not exist */
     else {                      /* if an identifier map is used */
       chn = (ISTNODE**)(node->cnts +node->size +node->size);
       i = search(*items++, chn, k);
     }                           /* search for the proper index */
-    if (i < 0) return F_SKIP;   /* abort if index is out of range */
+    if (i < 0) return NULL;     /* abort if index is out of range */
     node = chn[i];              /* go to the corresponding child */
-    if (!node) return F_SKIP;   /* if the child does not exists, */
-  }                             /* the support is less than minsupp */
+    if (!node) return NULL;     /* if the child does not exists, */
+  }                             /* the item set is not in the tree */
   if (node->offset >= 0) {      /* if a pure array is used, */
     i = *items -node->offset;   /* compute the counter index */
-    if (i >= node->size) return F_SKIP; }
+    if (i >= node->size) return NULL; }
   else {                        /* if an identifier map is used */
     map = node->cnts +(k = node->size);
     i   = int_bsearch(*items, map, k);
   }                             /* search for the proper index */
-  if (i < 0) return F_SKIP;     /* abort if index is out of range */
-  return node->cnts[i];         /* return the item set support */
-}  /* getsupp() */
+  if (i < 0) return NULL;       /* abort if index is out of range */
+  return node->cnts +i;         /* return the item set counter */
+}  /* getcnt() */
+
+/*--------------------------------------------------------------------*/
+
+static int getsupp (ISTNODE *node, int *items, int n)
+{                               /* --- get support of an item set */
+  int *c = getcnt(node, items, n);  /* get the item set counter */
+  return (c) ? *c : F_SKIP;     /* and return the support */
+}  /* getsupp() */              /* (less than minsupp if not found) */
 
 /*----------------------------------------------------------------------
   Counting Functions
@@ -178,8 +202,9 @@ static int getsupp (ISTNODE *node, int *items, int n)
 static void count (ISTNODE *node,
                    const int *items, int n, int wgt, int min)
 {                               /* --- count transaction recursively */
-  int     i, k, o;              /* array index, offset, map size */
+  int     i, k, o, x, e;        /* array index, offset, map size */
   int     *map;                 /* item identifier map */
+  int     *eyt, *rank;          /* Eytzinger layout and rank map */
   ISTNODE **chn;                /* array of child nodes */
 
   assert(node                   /* check the function arguments */
@@ -212,16 +237,43 @@ static void count (ISTNODE *node,
       while ((n > 0) && (*items < o)) {
         n--; items++; }         /* skip items before first counter */
       o   = map[k-1];           /* get the last item with a counter */
-      for (i = 0; --n >= 0; ) { /* traverse the transaction's items */
-        if (*items > o) return; /* if beyond last item, abort */
-        #ifdef IST_BSEARCH      /* if to use a binary search */
-        i = int_bsearch(*items++, map, k);
-        if (i >= 0) node->cnts[i] += wgt;
-        #else                   /* if to use a linear search */
-        while (*items > map[i]) i++;
-        if (*items++ == map[i]) node->cnts[i] += wgt;
-        #endif                  /* if the corresp. counter exists, */
-      } }                       /* add the transaction weight to it */
+      switch (node->offset) {   /* evaluate the search method */
+        case IST_MAPEYT:        /* if to use an Eytzinger layout */
+          eyt = map +k;         /* get the layout and the rank map */
+          for (rank = eyt +k+1; --n >= 0; ) {
+            if (*items > o) return;   /* if beyond last item, abort */
+            i = int_esearch(*items, eyt, k);
+            if (eyt[i] == *items++) node->cnts[rank[i]] += wgt;
+          } break;              /* if the corresp. counter exists, */
+        case IST_MAPBIN:        /* if to use a galloping search */
+          for (i = 0; --n >= 0; ) {
+            if (*items > o) return;   /* if beyond last item, abort */
+            for (x = 1; (i+x <= k) && (map[i+x-1] < *items); x += x);
+            e  = (i+x < k) ? i+x : k; /* find a range containing */
+            i += x >> 1;        /* the item by doubling the step size */
+            x  = int_bsearch(*items++, map+i, e-i);
+            if (x < 0) i -= x+1;/* do a binary search in this range */
+            else node->cnts[i += x] += wgt;
+          } break;              /* if the corresp. counter exists, */
+        case IST_MAPVEC:        /* if to use a SIMD linear search */
+          for (i = 0; --n >= 0; ) {
+            if (*items > o) return;   /* if beyond last item, abort */
+            x = int_lsearch(*items++, map+i, k-i);
+            if (x < 0) i -= x+1;      /* search in remaining map */
+            else node->cnts[i += x] += wgt;
+          } break;              /* if the corresp. counter exists, */
+        default:                /* if to merge with the transaction */
+          for (i = 0; --n >= 0; ) {
+            if (*items > o) return;   /* if beyond last item, abort */
+            #ifdef IST_BSEARCH  /* if to use a binary search */
+            i = int_bsearch(*items++, map, k);
+            if (i >= 0) node->cnts[i] += wgt;
+            #else               /* if to use a linear search */
+            while (*items > map[i]) i++;
+            if (*items++ == map[i]) node->cnts[i] += wgt;
+            #endif              /* if the corresp. counter exists, */
+          } break;              /* add the transaction weight to it */
+      } }
     else if (node->chcnt > 0) { /* if there are child nodes */
       chn = (ISTNODE**)(node->cnts +node->size +node->size);
       o   = ITEMOF(chn[0]);     /* get the child node array */
@@ -245,6 +297,63 @@ static void count (ISTNODE *node,
   }
 }  /* count() */
 
+/*--------------------------------------------------------------------*/
+
+static int wsupp (const TIDIDX *idx, const unsigned int *b,
+                  const unsigned int *x, int lo, int hi)
+{                               /* --- support of bitmap conjunction */
+  int i, k, s, t;               /* loop variables, support */
+  const unsigned int *p;        /* to traverse the weight planes */
+
+  assert(idx && x && (lo <= hi));
+  s = 0;                        /* initialize the support */
+  if (idx->unit) {              /* if all transactions have weight 1 */
+    if (!b) for (i = lo; i < hi; i++) s += tix_bitcnt(x[i]);
+    else    for (i = lo; i < hi; i++) s += tix_bitcnt(x[i] & b[i]);
+    return s;                   /* simply count the set bits */
+  }                             /* in the conjunction */
+  for (p = idx->wpls, k = 0; k < idx->wpcnt; p += idx->words, k++) {
+    t = 0;                      /* traverse the weight planes */
+    if (!b) for (i = lo; i < hi; i++) t += tix_bitcnt(x[i]      & p[i]);
+    else    for (i = lo; i < hi; i++) t += tix_bitcnt(x[i]&b[i] & p[i]);
+    s += t << k;                /* sum the set bits per plane and */
+  }                             /* weight them with the plane value */
+  return s;                     /* return the weighted support */
+}  /* wsupp() */
+
+/*--------------------------------------------------------------------*/
+
+static void countv (ISTNODE *node, const TIDIDX *idx,
+                    const unsigned int *b, int lo, int hi,
+                    unsigned int *buf)
+{                               /* --- count with bitmaps recursively */
+  int     i, k, n, l, h;        /* loop variables, word range */
+  const unsigned int *x;        /* bitmap of the current item */
+  ISTNODE **chn;                /* array of child nodes */
+
+  assert(node && idx && buf);   /* check the function arguments */
+  if (node->chcnt == 0) {       /* if this is a new node (leaf), */
+    for (i = node->size; --i >= 0; )  /* count all item sets */
+      node->cnts[i] += wsupp(idx, b, tix_bitmap(idx, ITEMAT(node, i)),
+                             lo, hi);
+    return;                     /* add the support of the conjunction */
+  }                             /* of the path with each counter item */
+  if (node->chcnt < 0) return;  /* skip subtrees marked as irrelevant */
+  chn = (ISTNODE**)(node->cnts +node->size
+      + ((node->offset >= 0) ? PAD(node->size) : node->size));
+  for (n = node->chcnt, i = 0; i < n; i++) {
+    if (!chn[i]) continue;      /* traverse the existing children */
+    x = tix_bitmap(idx, ITEMOF(chn[i]));
+    for (l = h = lo, k = lo; k < hi; k++) {
+      buf[k] = (b) ? b[k] & x[k] : x[k];
+      if (!buf[k]) continue;    /* intersect the path bitmap */
+      if (l >= h) l = k;        /* with the bitmap of the child item */
+      h = k+1;                  /* and determine the range */
+    }                           /* of non-zero words */
+    if (h > l) countv(chn[i], idx, buf, l, h, buf +idx->words);
+  }                             /* count the child recursively */
+}  /* countv() */
+
 /*--------------------------------------------------------------------*/
 #ifdef TATCOMPACT
 
@@ -445,7 +554,6 @@ static double evaluate (ISTREE *ist, ISTNODE *node, int index)
   int       *path;              /* path to follow for body support */
   ISTNODE   *curr;              /* to traverse the nodes on the path */
   ISTNODE   **chn;              /* child node array */
-  RULEVALFN *refn;              /* rule evaluation function */
   double    val, sum;           /* (aggregated) value of measure */
 
   assert(ist && node);          /* check the function arguments */
@@ -466,7 +574,6 @@ static double evaluate (ISTREE *ist, ISTNODE *node, int index)
   }                             /* determine the item index */
   supp = COUNT(node->cnts[index]);
   base = COUNT(ist->wgt);       /* get item set and base support */
-  refn = re_function(ist->eval);/* get the evaluation function */
   if (ist->agg == IST_EQS) {    /* if to split into equal size sets */
     path = ist->buf+ist->maxht; /* initialize the path/item array */
     *--path = item; n = 1;      /* for the support retrieval */
@@ -482,7 +589,8 @@ static double evaluate (ISTREE *ist, ISTNODE *node, int index)
     body = COUNT(curr->cnts[i]);/* get body and head support of split */
     head = COUNT(getsupp(ist->lvls[0], path, n));
     return (!ist->invbxs || (supp *(double)base > head *(double)body))
-         ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+         ? re_eval(ist->eval, supp, body, head, base, ist->cache, -1)
+         : (ist->dir < 0) ? 1 : 0;
   }                             /* compute and return evaluation */
   head = COUNT(ist->lvls[0]->cnts[item]);
   if (curr->offset >= 0)        /* if a pure array is used */
@@ -492,7 +600,8 @@ static double evaluate (ISTREE *ist, ISTNODE *node, int index)
     body = COUNT(curr->cnts[int_bsearch(ITEMOF(node), path, n)]);
   }                             /* find index and get body support */
   sum = (!ist->invbxs || (supp *(double)base > head *(double)body))
-      ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+      ? re_eval(ist->eval, supp, body, head, base, ist->cache, -1)
+      : (ist->dir < 0) ? 1 : 0;
   if (ist->agg <= IST_FIRST) {  /* compute the first measure value */
     if ((ist->minimp <= -INFINITY) || rec)
       return sum;               /* check whether to return it */
@@ -506,7 +615,8 @@ static double evaluate (ISTREE *ist, ISTNODE *node, int index)
     head = COUNT(ist->lvls[0]->cnts[item]);
     body = COUNT(getsupp(curr, path, n));
     val  = (!ist->invbxs || (supp *(double)base > head *(double)body))
-         ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+         ? re_eval(ist->eval, supp, body, head, base, ist->cache, -1)
+         : (ist->dir < 0) ? 1 : 0;
     if      (ist->agg == IST_MIN) {
       if       (val <  sum)                { sum = val; i = n; }
       else if ((val == sum) && (body > b)) { b = body;  i = n; } }
@@ -566,10 +676,20 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   ist->map  = (int*)     malloc(cnt *sizeof(int));
   if (!ist->map)  { free(ist->buf);
                     free(ist->lvls); free(ist); return NULL; }
+  ist->rval = (double*)  malloc(BATCH *(sizeof(double)+6*sizeof(int)));
+  if (!ist->rval) { free(ist->map);  free(ist->buf);
+                    free(ist->lvls); free(ist); return NULL; }
+  ist->ridx  = (int*)(ist->rval +BATCH);
+  ist->ritem = ist->ridx  +BATCH; /* organize the buffer */
+  ist->rsupp = ist->ritem +BATCH; /* for rule candidates */
+  ist->rbody = ist->rsupp +BATCH;
+  ist->rhead = ist->rbody +BATCH;
+  ist->rtmp  = ist->rhead +BATCH;
+  ist->cache = NULL;            /* (created by ist_seteval()) */
   n = cnt +PAD(cnt);            /* compute the array size */
   ist->lvls[0] = ist->curr =    /* allocate a root node */
   root = (ISTNODE*)calloc(1, sizeof(ISTNODE) +(n-1) *sizeof(int));
-  if (!root)      { free(ist->map);  free(ist->buf);
+  if (!root)      { free(ist->rval); free(ist->map);  free(ist->buf);
                     free(ist->lvls); free(ist); return NULL; }
 
   /* --- initialize structures --- */
@@ -578,21 +698,12 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   ist->wgt    = ib_getwgt(base);
   ist->maxht  = BLKSIZE;
   ist->height = 1;
-  ist->rule   = (supp > 0)         ? supp : 1;
-  ist->smax   = (smax > ist->rule) ? smax : ist->rule;
-  if (!(mode & APP_HEAD)) supp = (int)ceil(conf *supp);
-  ist->supp   = (supp > 0)         ? supp : 1;
-  ist->conf   = conf *(1.0-DBL_EPSILON);
-  /* Multiplying the minimum confidence with (1.0-DBL_EPSILON) takes */
-  /* care of rounding errors. For example, a minimum confidence of   */
-  /* 0.8 (or 80%) cannot be coded accurately with a double precision */
-  /* floating point number. It is rather stored as a slightly larger */
-  /* number, which can lead to missing rules. To prevent this, the   */
-  /* confidence is made smaller by the largest possible factor < 1.  */
+  ist->chkcnt = ist->avdcnt = 0;/* clear the filter check counters */
   #ifdef BENCH                  /* if benchmark version */
   ist->ndcnt  = 1;   ist->ndprn = ist->mapsz = 0;
   ist->sccnt  = ist->scnec = cnt; ist->scprn = 0;
   ist->cpcnt  = ist->cpnec =      ist->cpprn = 0;
+  memset(ist->mapcnt, 0, sizeof(ist->mapcnt));
   #endif                        /* initialize the benchmark variables */
   ist_setsize(ist, 1, 1, 1);    /* init. the extraction variables */
   ist_seteval(ist, IST_NONE, IST_NONE, 1, -INFINITY, INT_MAX);
@@ -602,6 +713,7 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   root->size   = cnt;           /* initialize the root node */
   while (--cnt >= 0)            /* copy the item frequencies */
     root->cnts[cnt] = ib_getfrq(base, cnt);
+  ist_setsupp(ist, supp, smax, conf);   /* set the thresholds */
   return ist;                   /* return created item set tree */
 }  /* ist_create() */
 
@@ -620,6 +732,8 @@ void ist_delete (ISTREE *ist)
   free(ist->lvls);              /* the level array, */
   free(ist->map);               /* the identifier map, */
   free(ist->buf);               /* the path buffer, */
+  free(ist->rval);              /* the rule candidate buffer, */
+  if (ist->cache) re_delete(ist->cache);   /* the Fisher cache, */
   free(ist);                    /* and the tree body */
 }  /* ist_delete() */
 
@@ -673,6 +787,21 @@ void ist_countx (ISTREE *ist, const TATREE *tree)
 
 /*--------------------------------------------------------------------*/
 
+int ist_countv (ISTREE *ist, const TIDIDX *idx)
+{                               /* --- count with a vertical index */
+  unsigned int *buf;            /* buffer for the path bitmaps */
+
+  assert(ist && idx);           /* check the function arguments */
+  buf = (unsigned int*)malloc((size_t)ist->height
+                             *(size_t)idx->words *sizeof(unsigned int));
+  if (!buf) return -1;          /* create a buffer for path bitmaps */
+  countv(ist->lvls[0], idx, NULL, 0, idx->words, buf);
+  free(buf);                    /* recursively count the item sets */
+  return 0;                     /* and delete the path buffer */
+}  /* ist_countv() */
+
+/*--------------------------------------------------------------------*/
+
 void ist_commit (ISTREE *ist)
 {                               /* --- commit transaction counting */
   int     i;                    /* loop variable, counter index */
@@ -842,6 +971,7 @@ void ist_prune (ISTREE *ist)
 static ISTNODE* child (ISTREE *ist, ISTNODE *node, int index, int spx)
 {                               /* --- create child node (extend set) */
   int     i, k, n, m;           /* loop variables, counters */
+  int     o;                    /* search method for an id. map */
   ISTNODE *curr;                /* to traverse the path to the root */
   int     item;                 /* item identifier */
   int     *set;                 /* next (partial) item set to check */
@@ -911,6 +1041,17 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, int index, int spx)
   ist->ndcnt++;                 /* count the node to be created */
   #endif
 
+  /* --- choose search method --- */
+  o = IST_MAPLIN;               /* default: merge with transaction */
+  if (n != k) {                 /* if to use an identifier map */
+    if      (n >= TH_MAPEYT) { o = IST_MAPEYT; k += n+n+2; }
+    else if (n >= TH_MAPBIN)   o = IST_MAPBIN;
+    else if (n <= TH_MAPVEC)   o = IST_MAPVEC;
+    #ifdef BENCH                /* if benchmark version, */
+    ist->mapcnt[-1-o]++;        /* count the nodes per method */
+    #endif                      /* (an Eytzinger layout and a rank */
+  }                             /* map are stored after the id. map) */
+
   /* --- create child --- */
   curr = (ISTNODE*)malloc(sizeof(ISTNODE) +(k+PAD(k)-1) *sizeof(int));
   if (!curr) return (ISTNODE*)-1;  /* create a child node */
@@ -923,9 +1064,11 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, int index, int spx)
     for (i = 0; i < n; i++) curr->cnts[i] = F_SKIP;
     for (i = 0; i < m; i++) curr->cnts[ist->map[i] -k] = 0; }
   else {                        /* if to use an identifier map, */
-    curr->offset = -1;          /* use negative offset as indicator */
+    curr->offset = o;           /* use negative offset as indicator */
     memset(curr->cnts, 0, n *sizeof(int));
     memcpy(curr->cnts +n, ist->map, n *sizeof(int));
+    if (o == IST_MAPEYT)        /* build an Eytzinger layout */
+      int_eytzinger(curr->cnts +n+n, curr->cnts +n+n+n+1, ist->map, n);
   }                             /* clear counters, copy item id. map */
   return curr;                  /* return pointer to created child */
 }  /* child() */
@@ -1073,6 +1216,8 @@ int ist_addlvl (ISTREE *ist)
     node = (ISTNODE*)realloc(node,sizeof(ISTNODE)+i+n*sizeof(ISTNODE*));
     if (!node) { cleanup(ist); return -1; }
     node->chcnt = n;            /* add a child array to the node */
+    if (node->offset == IST_MAPEYT)  /* the child array replaces */
+      node->offset = IST_MAPBIN;     /* the Eytzinger layout */
     #ifdef BENCH                /* if benchmark version, */
     ist->cpcnt += n;            /* sum the number of child pointers */
     #endif
@@ -1310,17 +1455,24 @@ static void clear (ISTNODE *node, int *items, int n, int supp)
 
 /*--------------------------------------------------------------------*/
 
+static void mark (ISTNODE *node, int *items, int n, int supp)
+{                               /* --- mark a non-closed item set */
+  int *c = getcnt(node, items, n);  /* get the item set counter */
+  if (c && (COUNT(*c) <= supp)) /* if the support is not larger, */
+    *c |= F_SKIP;               /* mark the item set */
+}  /* mark() */
+
+/*--------------------------------------------------------------------*/
+
 void ist_clomax (ISTREE *ist, int target)
 {                               /* --- filter for closed/maximal sets */
   int     i, k, n, h;           /* loop variables, buffers */
-  int     item;                 /* buffer for an item */
   int     supp;                 /* minimum support for a superset */
-  int     *map;                 /* item identifier map */
   int     *path;                /* path to access superset support */
   ISTNODE *node, *curr;         /* to traverse the nodes */
-  ISTNODE **chn;                /* child node array */
 
   assert(ist);                  /* check the function argument */
+  ist->chkcnt = ist->avdcnt = 0;/* clear the check counters */
 
   /* --- safe filtering --- */
   if (target & IST_SAFE) {      /* if to filter in a safe way */
@@ -1373,7 +1525,9 @@ void ist_clomax (ISTREE *ist, int target)
           *--path = ITEMAT(node, i);
           *--path = ITEMOF(node);   /* initialize the path */
           n = 1;                /* with the last two items */
+          ist->avdcnt += h;     /* count the possible checks */
           for (curr = node->parent; curr; curr = curr->parent) {
+            ist->chkcnt++;      /* count the subset check */
             if (getsupp(curr, path+1, n) <= supp) break;
             *--path = ITEMOF(curr); ++n;
           }                     /* try to find a qualifying subset */
@@ -1381,8 +1535,9 @@ void ist_clomax (ISTREE *ist, int target)
         }                       /* if on the path to the root */
       }                         /* a subset could be found */
     }                           /* that has the same support, */
-    return;                     /* the set is not a generator */
-  }                             /* abort when filtering finishes */
+    ist->avdcnt -= ist->chkcnt; /* the set is not a generator; */
+    return;                     /* compute the avoided checks */
+  }                             /* and abort the function */
 
   /* --- check empty set --- */
   supp = (target & IST_MAXIMAL) ? ist->supp : ist->wgt;
@@ -1391,63 +1546,42 @@ void ist_clomax (ISTREE *ist, int target)
     if (node->cnts[i] >= supp) { ist->wgt |= F_SKIP; break; }
 
   /* --- process intermediate levels --- */
-  supp = INT_MAX;               /* set default support filter (max.) */
+  for (n = 0, node = ist->lvls[0], i = node->size; --i >= 0; )
+    n += (node->cnts[i] >= ist->supp);  /* count frequent items */
   for (h = 0; h < ist->height-1; h++) {   /* traverse the tree levels */
     for (node = ist->lvls[h]; node; node = node->succ) {
       for (i = node->size; --i >= 0; ) {  /* traverse the nodes */
-        if (node->cnts[i] < ist->supp) {  /* check for min. support */
-          node->cnts[i] |= F_SKIP; continue; }
-        item = ITEMAT(node, i); /* get item and min. superset support */
-        supp = (target & IST_MAXIMAL) ? ist->supp : node->cnts[i];
-
-        /* -- check supersets in child -- */
-        n = CHILDCNT(node);     /* get the number of children */
-        if (n > 0) {            /* if there are child nodes */
-          if (node->offset >= 0) { /* if pure array is used */
-            chn  = (ISTNODE**)(node->cnts +node->size +PAD(node->size));
-            k    = item -ITEMOF(chn[0]);
-            curr = ((k < 0) || (k >= n)) ? NULL : chn[k]; }
-          else {                /* if an identifier map is used */
-            chn  = (ISTNODE**)(node->cnts +node->size +node->size);
-            k    = search(item, chn, n);
-            curr = (k < 0) ? NULL : chn[k];
-          }                     /* get child node for current item */
-          if (curr) {           /* if the child node exists */
-            for (k = curr->size; --k >= 0; )
-              if (curr->cnts[k] >= supp) break;
-            if (k >= 0) { node->cnts[i] |= F_SKIP; continue; }
-          }                     /* if a superset in the tail has */
-        }                       /* sufficient support, mark set */
-
-        /* -- check other supersets -- */
+        if (node->cnts[i] < ist->supp)    /* mark infrequent sets */
+          node->cnts[i] |= F_SKIP;        /* (and count the checks */
+        else ist->avdcnt += n-h-1;        /* for all extensions) */
+      }                         /* (a set with h+1 items has n-h-1 */
+    }                           /* possible one item supersets) */
+    for (node = ist->lvls[h+1]; node; node = node->succ) {
+      for (i = node->size; --i >= 0; ) {  /* traverse the supersets */
+        supp = node->cnts[i];   /* (sets with h+2 items) */
+        if (supp < ist->supp) continue;   /* skip infrequent sets */
+        if (target & IST_MAXIMAL) supp = INT_MAX;
+        curr = node->parent;    /* get parent of the current node */
         path = ist->buf +ist->maxht;
-        *--path = item;         /* init. the path for lookups and */
-        n = 1;                  /* traverse the path to the root */
-        for (curr = node; curr; curr = curr->parent) {
-          if (curr->offset >= 0) {   /* if a pure array is used */
-            k = *path -curr->offset; /* get index of current item */
-            if (k > curr->size) k = curr->size;
-            while (--k >= 0) {  /* traverse the preceding items */
-              path[-1] = curr->offset +k;
-              if (getsupp(curr, path-1, n+1) >= supp) break;
-            } }                 /* if a superset qualifies, abort */
-          else {                /* if an identifier map is used */
-            map = curr->cnts +(k = curr->size);
-            k   = int_bsearch(*path, map, k);
-            if (k < 0) k = -1-k;/* get index of current item */
-            while (--k >= 0) {  /* traverse the preceding items */
-              path[-1] = curr->cnts[curr->size +k];
-              if (getsupp(curr, path-1, n+1) >= supp) break;
-            }                   /* if a superset qualifies, abort */
-          }
-          if (k >= 0) break;    /* if a superset found, abort search */
-          if (path <= ist->buf) { curr = NULL; break; }
-          *--path = ITEMOF(curr); n++;
-        }                       /* extend the item set suffix/path */
-        if (curr) node->cnts[i] |= F_SKIP;
-      }                         /* if frequent/equal support superset */
-    }                           /* was found, the current item set */
-  }                             /* is not closed/maximal, resp. */
+        *--path = ITEMAT(node, i);  /* mark the subset without */
+        mark(curr, path, 1, supp);  /* the item of the node */
+        *--path = ITEMOF(node);     /* mark the subset without */
+        mark(curr, path, 1, supp);  /* the item at the index */
+        for (k = 1; curr->parent; curr = curr->parent) {
+          mark(curr->parent, path, ++k, supp);
+          *--path = ITEMOF(curr);
+        }                       /* climb up the tree and mark */
+        ist->chkcnt += h+2;     /* all h+2 subsets with h+1 items */
+      }                         /* that do not have a larger support */
+    }                           /* (closed) or all subsets (maximal), */
+  }                             /* as they are not closed/maximal */
+  ist->avdcnt -= ist->chkcnt;   /* compute the number of checks */
+  if (ist->avdcnt < 0) ist->avdcnt = 0; /* that were avoided */
+  /* Instead of looking up all possible supersets of a frequent item */
+  /* set (one item more, n-h-1 lookups for a set with h+1 items), the */
+  /* frequent sets on the next level mark their subsets. This needs  */
+  /* only lookups for supersets that actually exist in the tree and  */
+  /* qualify, which are usually much fewer (most candidates fail).   */
 
   /* --- process deepest level --- */
   for (node = ist->lvls[h]; node; node = node->succ)
@@ -1470,6 +1604,36 @@ void ist_setsize (ISTREE *ist, int min, int max, int order)
 
 /*--------------------------------------------------------------------*/
 
+void ist_setsupp (ISTREE *ist, int supp, int smax, double conf)
+{                               /* --- set support and confidence */
+  int     i, h;                 /* loop variables */
+  ISTNODE *node;                /* to traverse the nodes */
+
+  assert(ist && (supp >= 0) && (conf >= 0) && (conf <= 1));
+  ist->rule = (supp > 0)         ? supp : 1;
+  ist->smax = (smax > ist->rule) ? smax : ist->rule;
+  if (!(ist->mode & APP_HEAD)) supp = (int)ceil(conf *supp);
+  ist->supp = (supp > 0)         ? supp : 1;
+  ist->conf = conf *(1.0-DBL_EPSILON);
+  /* Multiplying the minimum confidence with (1.0-DBL_EPSILON) takes */
+  /* care of rounding errors. For example, a minimum confidence of   */
+  /* 0.8 (or 80%) cannot be coded accurately with a double precision */
+  /* floating point number. It is rather stored as a slightly larger */
+  /* number, which can lead to missing rules. To prevent this, the   */
+  /* confidence is made smaller by the largest possible factor < 1.  */
+  ist_clear(ist);               /* clear all filter markers */
+  if (ist->eval <= IST_NONE) return;
+  for (h = ist->height; --h >= ist->prune-1; ) {
+    for (node = ist->lvls[h]; node; node = node->succ)
+      for (i = node->size; --i >= 0; )
+        if ((node->cnts[i] < ist->supp)
+        ||  (ist->dir *evaluate(ist, node, i) < ist->thresh))
+          node->cnts[i] |= F_SKIP;
+  }                             /* redo the marking of ist_commit() */
+}  /* ist_setsupp() */          /* (forward pruning with evaluation) */
+
+/*--------------------------------------------------------------------*/
+
 void ist_seteval (ISTREE *ist, int eval, int agg,
                   double thresh, double minimp, int prune)
 {                               /* --- set additional evaluation */
@@ -1483,7 +1647,10 @@ void ist_seteval (ISTREE *ist, int eval, int agg,
   ist->thresh = ist->dir *thresh;
   ist->minimp = minimp;         /* note the evaluation parameters */
   ist->prune  = (prune <= 0) ? INT_MAX : (prune > 1) ? prune : 2;
-}  /* ist_seteval() */
+  if ((ist->eval >= RE_FETPROB) && (ist->eval <= RE_FETSUPP)
+  &&  !ist->cache)              /* create a cache for Fisher's test */
+    ist->cache = re_create();   /* (if this fails, the values are */
+}  /* ist_seteval() */          /* computed directly) */
 
 /*--------------------------------------------------------------------*/
 
@@ -1495,6 +1662,7 @@ void ist_init (ISTREE *ist)
   ist->node  = ist->lvls[(ist->size > 0) ? ist->size -1 : 0];
   ist->index = ist->item = -1;  /* initialize the */
   ist->head  = NULL;            /* extraction variables */
+  ist->rcnt  = ist->rpos = 0;   /* and clear the rule candidates */
 }  /* ist_init() */
 
 /*--------------------------------------------------------------------*/
@@ -1580,35 +1748,19 @@ int ist_set (ISTREE *ist, int *set, int *supp, double *eval)
 
 /*--------------------------------------------------------------------*/
 
-int ist_rule (ISTREE *ist, int *rule,
-              int *supp, int *body, int *head, double *eval)
-{                               /* --- extract next association rule */
-  int       i;                  /* loop variable */
-  int       item;               /* an item identifier */
-  ISTNODE   *node;              /* current item set node */
-  ISTNODE   *parent;            /* parent of the item set node */
-  int       *map, n;            /* identifier map and its size */
-  int       s_set;              /* support of set  (body & head) */
-  int       s_body;             /* support of body (antecedent) */
-  int       s_head;             /* support of head (consequent) */
-  int       s_base;             /* base support (number of trans.) */
-  double    val;                /* value of evaluation measure */
-  int       app;                /* appearance flag of head item */
-  RULEVALFN *refn;              /* rule evaluation function */
-
-  assert(ist && rule);          /* check the function arguments */
-  if (ist->size == 0)           /* if at the empty item set, */
-    ist->size += ist->order;    /* go to the next item set size */
-  if ((ist->size < ist->minsz)  /* if the item set is too small */
-  ||  (ist->size > ist->maxsz)) /* or too large (number of items), */
-    return -1;                  /* abort the function */
+static int collect (ISTREE *ist)
+{                               /* --- collect rule candidates */
+  int     n;                    /* number of rule candidates */
+  int     item;                 /* an item identifier */
+  ISTNODE *node;                /* current item set node */
+  ISTNODE *parent;              /* parent of the item set node */
+  int     *map, k;              /* identifier map and its size */
+  int     s_set;                /* support of set  (body & head) */
+  int     s_body;               /* support of body (antecedent) */
+  int     app;                  /* appearance flag of head item */
 
-  /* --- find rule --- */
-  s_base = COUNT(ist->wgt);     /* get the base support and */
-  node   = ist->node;           /* the current item set node */
-  refn   = ((ist->eval > IST_NONE) && (ist->eval < IST_LDRATIO))
-         ? re_function(ist->eval) : (RULEVALFN*)0;
-  while (1) {                   /* search for a rule */
+  node = ist->node;             /* get the current item set node */
+  for (n = 0; n < BATCH; ) {    /* collect rule candidates */
     if (ist->item >= 0) {       /* --- select next item subset */
       *--ist->path = ist->item; /* add previous head to the path and */
       ist->item = ITEMOF(ist->head);       /* get the next head item */
@@ -1617,6 +1769,8 @@ int ist_rule (ISTREE *ist, int *rule,
         ist->item = -1;         /* clear the head item to trigger the */
     }                           /* selection of a new item set */
     if (ist->item < 0) {        /* --- select next item set */
+      if ((n > 0) && (ist->index+1 >= node->size))
+        break;                  /* candidates must be from one node */
       if (++ist->index >= node->size){/* if all subsets have been */
         node = node->succ;      /* processed, go to the successor */
         if (!node) {            /* if at the end of a level, */
@@ -1647,45 +1801,110 @@ int ist_rule (ISTREE *ist, int *rule,
     ||  (s_set > ist->smax)) {  /* or larger than the maximum, */
       ist->item = -1; continue; }   /* go to the next item set */
     parent = node->parent;      /* get the parent node */
-    n = (int)(ist->buf +ist->maxht -ist->path);
-    if (n > 0)                  /* if there is a path, use it */
-      s_body = COUNT(getsupp(ist->head, ist->path, n));
+    k = (int)(ist->buf +ist->maxht -ist->path);
+    if (k > 0)                  /* if there is a path, use it */
+      s_body = COUNT(getsupp(ist->head, ist->path, k));
     else if (!parent)           /* if there is no parent (root node), */
       s_body = COUNT(ist->wgt); /* get the total trans. weight */
     else if (parent->offset >= 0)  /* if a pure array is used */
       s_body = COUNT(parent->cnts[ITEMOF(node) -parent->offset]);
     else {                      /* if an identifier map is used */
-      map = parent->cnts +(n = parent->size);
-      s_body = COUNT(parent->cnts[int_bsearch(ITEMOF(node), map, n)]);
+      map = parent->cnts +(k = parent->size);
+      s_body = COUNT(parent->cnts[int_bsearch(ITEMOF(node), map, k)]);
     }                           /* find array index and get support */
     if ((s_body < ist->rule)    /* if the body support is too low */
     ||  (s_set  < s_body *ist->conf))       /* or the confidence, */
       continue;                 /* go to the next item (sub)set */
-    s_head = COUNT(ist->lvls[0]->cnts[ist->item]);
-    if (!refn) {                /* if no add. eval. measure given, */
-      val = 0; break; }         /* abort the loop (select the rule) */
-    val = (!ist->invbxs         /* compute add. evaluation measure */
-       || (s_set *(double)s_base > s_head *(double)s_body))
-        ? refn(s_set, s_body, s_head, s_base) : (ist->dir < 0) ? 1 : 0;
-    if (ist->dir *val >= ist->thresh)
+    ist->ridx [n] = ist->index; /* note the item set and head item */
+    ist->ritem[n] = ist->item;  /* and the supports of the rule */
+    ist->rsupp[n] = s_set;
+    ist->rbody[n] = s_body;
+    ist->rhead[n] = COUNT(ist->lvls[0]->cnts[ist->item]);
+    n++;                        /* count the rule candidate */
+  }
+  return n;                     /* return the number of candidates */
+}  /* collect() */
+
+/*--------------------------------------------------------------------*/
+
+static void evalcnd (ISTREE *ist, int n)
+{                               /* --- evaluate rule candidates */
+  int i;                        /* loop variable */
+  int base;                     /* base support (number of trans.) */
+  int *body;                    /* body supports for evaluation */
+
+  if ((ist->eval <= IST_NONE)   /* if no add. eval. measure given, */
+  ||  (ist->eval >= IST_LDRATIO)) {   /* all candidates are rules */
+    for (i = 0; i < n; i++) ist->rval[i] = 0;
+    return;                     /* set the evaluations to zero */
+  }                             /* and abort the function */
+  base = COUNT(ist->wgt);       /* get the base support */
+  body = ist->rbody;            /* and the body supports */
+  if (ist->invbxs) {            /* if to invalidate below exp. supp. */
+    for (body = ist->rtmp, i = 0; i < n; i++)
+      body[i] = (ist->rsupp[i] *(double)base
+              >  ist->rhead[i] *(double)ist->rbody[i])
+              ?  ist->rbody[i] : 0;
+  }                             /* (body support 0 is evaluated fast) */
+  re_batch(ist->eval, ist->rsupp, body, ist->rhead, base, ist->rval, n,
+           ist->cache, (ist->dir < 0) ? -ist->thresh : -1);
+                                /* evaluate all candidates at once */
+                                /* (p-value sums are aborted at the */
+                                /* threshold, as only passing values */
+                                /* are needed) */
+  if (body != ist->rbody) {     /* if some candidates were invalid, */
+    for (i = 0; i < n; i++)     /* set their evaluation to a value */
+      if (body[i] <= 0) ist->rval[i] = (ist->dir < 0) ? 1 : 0;
+  }                             /* that passes only trivial thresh. */
+}  /* evalcnd() */
+
+/*--------------------------------------------------------------------*/
+
+int ist_rule (ISTREE *ist, int *rule,
+              int *supp, int *body, int *head, double *eval)
+{                               /* --- extract next association rule */
+  int     i, k;                 /* loop variable, candidate index */
+  int     item;                 /* an item identifier */
+  ISTNODE *node;                /* current item set node */
+
+  assert(ist && rule);          /* check the function arguments */
+  if (ist->size == 0)           /* if at the empty item set, */
+    ist->size += ist->order;    /* go to the next item set size */
+  if ((ist->size < ist->minsz)  /* if the item set is too small */
+  ||  (ist->size > ist->maxsz)) /* or too large (number of items), */
+    return -1;                  /* abort the function */
+
+  /* --- find rule --- */
+  while (1) {                   /* search for a rule */
+    if (ist->rpos >= ist->rcnt) {  /* if all candidates are used, */
+      ist->rpos = 0;            /* collect candidates from one node */
+      ist->rcnt = collect(ist); /* and evaluate them in one batch */
+      if (ist->rcnt <= 0) {     /* if there are no more candidates, */
+        ist->rcnt = 0; return -1; }       /* abort the function */
+      evalcnd(ist, ist->rcnt);  /* compute the evaluation measure */
+    }                           /* for all collected candidates */
+    k = ist->rpos++;            /* get the next rule candidate */
+    if ((ist->eval <= IST_NONE) || (ist->eval >= IST_LDRATIO)
+    ||  (ist->dir *ist->rval[k] >= ist->thresh))
       break;                    /* if the evaluation is high enough, */
   }  /* while (1) */            /* abort the loop (select the rule) */
-  if (supp) *supp = s_set;      /* store the rule support values */
-  if (body) *body = s_body;     /* (whole rule and only body) */
-  if (head) *head = s_head;     /* store the head item support, */
-  if (eval) *eval = val;        /* the value of the add. measure */
+  if (supp) *supp = ist->rsupp[k]; /* store the rule support values */
+  if (body) *body = ist->rbody[k]; /* (whole rule and only body) */
+  if (head) *head = ist->rhead[k]; /* store the head item support, */
+  if (eval) *eval = ist->rval[k];  /* the value of the add. measure */
 
   /* --- build rule --- */
-  item = ITEMAT(node, ist->index);
+  node = ist->node;             /* get the node of the candidates */
+  item = ITEMAT(node, ist->ridx[k]);
   i    = ist->size;             /* get the current item and */
-  if (item != ist->item)        /* if this item is not the head, */
+  if (item != ist->ritem[k])    /* if this item is not the head, */
     rule[--i] = item;           /* add it to the rule body */
   while (node->parent) {        /* traverse the path to the root */
-    if (ITEMOF(node) != ist->item)
+    if (ITEMOF(node) != ist->ritem[k])
       rule[--i] = ITEMOF(node); /* add all items on this path */
     node = node->parent;        /* to the rule body */
   }                             /* (except the head of the rule) */
-  rule[0] = ist->item;          /* set the head of the rule, */
+  rule[0] = ist->ritem[k];      /* set the head of the rule, */
   return ist->size;             /* return the rule size */
 }  /* ist_rule() */
 
@@ -1806,6 +2025,10 @@ void ist_stats (ISTREE *ist)
   printf("number of child pointers   : %d\n", ist->cpcnt);
   printf("necessary child pointers   : %d\n", ist->cpnec);
   printf("pruned    child pointers   : %d\n", ist->cpprn);
+  printf("id. maps with merge search : %d\n", ist->mapcnt[0]);
+  printf("id. maps with SIMD search  : %d\n", ist->mapcnt[1]);
+  printf("id. maps with binary search: %d\n", ist->mapcnt[2]);
+  printf("id. maps with Eytzinger    : %d\n", ist->mapcnt[3]);
 }  /* ist_stats() */
 
 #endif
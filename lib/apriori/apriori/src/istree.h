@@ -118,6 +118,18 @@ typedef struct {                /* --- item set tree --- */
   int      *path;               /* current path / (partial) item set */
   int      hdonly;              /* head only item in current set */
   int      *map;                /* to create identifier maps */
+  int      rcnt;                /* number of rule candidates */
+  int      rpos;                /* index of next rule candidate */
+  double   *rval;               /* evaluations of rule candidates */
+  int      *ridx;               /* item set indices of candidates */
+  int      *ritem;              /* head items of rule candidates */
+  int      *rsupp;              /* supports of rule candidates */
+  int      *rbody;              /* body supports of rule candidates */
+  int      *rhead;              /* head supports of rule candidates */
+  int      *rtmp;               /* buffer for evaluation (body supp.) */
+  RECACHE  *cache;             /* cache for Fisher's exact test */
+  long     chkcnt;              /* number of subset/superset checks */
+  long     avdcnt;              /* number of avoided checks */
 #ifdef BENCH                    /* if benchmark version */
   int      ndcnt;               /* number of item set tree nodes */
   int      ndprn;               /* number of pruned tree nodes */
@@ -128,6 +140,7 @@ typedef struct {                /* --- item set tree --- */
   int      cpcnt;               /* number of created child pointers */
   int      cpnec;               /* number of necessary child pointers */
   int      cpprn;               /* number of pruned child pointers */
+  int      mapcnt[4];           /* number of id. maps per method */
 #endif
 } ISTREE;                       /* (item set tree) */
 
@@ -146,6 +159,7 @@ extern void    ist_countb  (ISTREE *ist, const TABAG  *bag);
 #ifdef TATREEFN
 extern void    ist_countx  (ISTREE *ist, const TATREE *tree);
 #endif
+extern int     ist_countv  (ISTREE *ist, const TIDIDX *idx);
 extern void    ist_commit  (ISTREE *ist);
 extern int     ist_check   (ISTREE *ist, int *marks);
 extern void    ist_prune   (ISTREE *ist);
@@ -155,6 +169,8 @@ extern int     ist_height  (ISTREE *ist);
 extern int     ist_getwgt  (ISTREE *ist);
 extern int     ist_setwgt  (ISTREE *ist, int wgt);
 extern int     ist_incwgt  (ISTREE *ist, int wgt);
+extern long    ist_chkcnt  (ISTREE *ist);
+extern long    ist_avdcnt  (ISTREE *ist);
 
 extern void    ist_up      (ISTREE *ist, int root);
 extern int     ist_down    (ISTREE *ist, int item);
@@ -166,6 +182,8 @@ extern void    ist_clear   (ISTREE *ist);
 extern void    ist_filter  (ISTREE *ist, int size);
 extern void    ist_clomax  (ISTREE *ist, int target);
 extern void    ist_setsize (ISTREE *ist, int min, int max, int order);
+extern void    ist_setsupp (ISTREE *ist, int supp, int smax,
+                            double conf);
 extern void    ist_seteval (ISTREE *ist, int eval, int agg,
                             double thresh, double minimp, int prune);
 
@@ -194,5 +212,7 @@ extern void    ist_show    (ISTREE *ist);
 #define ist_getwgt(t)      ((t)->wgt & ~INT_MIN)
 #define ist_setwgt(t,n)    ((t)->wgt = (n))
 #define ist_incwgt(t,n)    ((t)->wgt = ((t)->wgt & ~INT_MIN) +(n))
+#define ist_chkcnt(t)      ((t)->chkcnt)
+#define ist_avdcnt(t)      ((t)->avdcnt)
 
 #endif
@@ -0,0 +1,698 @@
+/*----------------------------------------------------------------------
+  File    : rulesort.c
+  Contents: sort association rules/item sets by their measures
+            (external merge sort with bounded memory)
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+#ifdef RS_THREADS
+#include <pthread.h>
+#endif
+#include "repbin.h"
+#include "error.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define PRGNAME     "rulesort"
+#define DESCRIPTION "sort association rules/item sets by their measures"
+#define VERSION     "version 1.0 (2026.10.18)         " \
+                    "(c) 2026        agent"
+
+/* --- error codes --- */
+#define E_NONE        0         /* no error */
+#define E_NOMEM     (-1)        /* not enough memory */
+#define E_FOPEN     (-2)        /* cannot open file */
+#define E_FREAD     (-3)        /* read error on file */
+#define E_FWRITE    (-4)        /* write error on file */
+#define E_OPTION    (-5)        /* unknown option */
+#define E_OPTARG    (-6)        /* missing option argument */
+#define E_ARGCNT    (-7)        /* too few/many arguments */
+#define E_KEYS      (-8)        /* invalid sort key specification */
+#define E_TMPFILE   (-9)        /* cannot create temporary file */
+
+#define MAXKEY      16          /* maximum number of sort keys */
+#define MAXFLD      64          /* maximum number of numeric fields */
+#define MAXMERGE    128         /* maximum number of runs to merge */
+#define BS_LINE     1024        /* initial size of the line buffer */
+#define ALIGN(n)    (((n) +7) & ~(size_t)7)  /* align to 8 bytes */
+
+#ifndef QUIET                   /* if not quiet version, */
+#define MSG         fprintf     /* print messages */
+#else                           /* if quiet version, */
+#define MSG(...)                /* suppress messages */
+#endif
+
+#define SEC_SINCE(t)  ((clock()-(t)) /(double)CLOCKS_PER_SEC)
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- a set/rule record --- */
+  long     id;                  /* position in the input */
+  int      len;                 /* length of the text (with '\n') */
+  double   keys[1];             /* sort keys (followed by the text) */
+} RSREC;                        /* (set/rule record) */
+
+typedef struct {                /* --- a sorted run --- */
+  char     *mem;                /* memory for the records */
+  size_t   size;                /* size of the record memory */
+  size_t   used;                /* used part of the record memory */
+  RSREC    **recs;              /* array of records in the run */
+  size_t   cnt;                 /* number of records */
+  size_t   max;                 /* size of the record array */
+  FILE     *file;               /* temporary file for the run */
+  int      err;                 /* error code of sorting/writing */
+  #ifdef RS_THREADS             /* if multithreaded run generation */
+  pthread_t thread;             /* thread sorting and writing the run */
+  int      busy;                /* whether the thread is running */
+  #endif
+} RSRUN;                        /* (sorted run) */
+
+typedef struct {                /* --- a run reader --- */
+  FILE     *file;               /* temporary file of the run */
+  RSREC    *rec;                /* buffer for the current record */
+  size_t   size;                /* size of the record buffer */
+  int      done;                /* whether the run is exhausted */
+} RSIN;                         /* (run reader) */
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+#if !defined QUIET
+/* --- error messages --- */
+static const char *errmsgs[] = {
+  /* E_NONE      0 */  "no error",
+  /* E_NOMEM    -1 */  "not enough memory",
+  /* E_FOPEN    -2 */  "cannot open file %s",
+  /* E_FREAD    -3 */  "read error on file %s",
+  /* E_FWRITE   -4 */  "write error on file %s",
+  /* E_OPTION   -5 */  "unknown option -%c",
+  /* E_OPTARG   -6 */  "missing option argument",
+  /* E_ARGCNT   -7 */  "wrong number of arguments",
+  /* E_KEYS     -8 */  "invalid sort key specification %s",
+  /* E_TMPFILE  -9 */  "cannot create temporary file",
+  /*          -10 */  "unknown error"
+};
+#endif
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+#ifndef QUIET
+static const char *prgname;     /* program name for error messages */
+#endif
+static int    keycnt = 0;       /* number of sort keys */
+static int    keyfld[MAXKEY];   /* numeric field indices of the keys */
+static int    keydir[MAXKEY];   /* directions of the keys */
+static int    eval    = 0;      /* whether to print the evaluation */
+static FILE   *in     = NULL;   /* input  file (text) */
+static RBREAD *rbread = NULL;   /* input  file (binary) */
+static FILE   *out    = NULL;   /* output file */
+static RSRUN  *runs   = NULL;   /* in-memory runs */
+static int    runcnt  = 0;      /* number of in-memory runs */
+static FILE   *tmps[MAXMERGE];  /* temporary files of written runs */
+static int    tmplvl[MAXMERGE]; /* merge levels of written runs */
+static int    tmpcnt  = 0;      /* number of written runs */
+static long   mrgcnt  = 0;      /* number of intermediate merges */
+static RSIN   rdrs[MAXMERGE];   /* run readers for merging */
+static char   *line   = NULL;   /* buffer for an input line */
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static int keys (const char *s)
+{                               /* --- parse a sort key list */
+  int  k;                       /* field index */
+  char *e;                      /* end of a field index */
+
+  for (keycnt = 0; *s; ) {      /* traverse the key list */
+    if (keycnt >= MAXKEY) return -1;
+    k = (int)strtol(s, &e, 10); /* get the next field index */
+    if ((e == s) || (k == 0) || (abs(k) > MAXFLD)) return -1;
+    keydir[keycnt]   = (k < 0) ? -1 : +1;
+    keyfld[keycnt++] = abs(k)-1;/* note direction and field index */
+    s = e; if (*s == ',') s++;  /* skip a separating comma */
+  }
+  return (keycnt > 0) ? 0 : -1; /* return an error indicator */
+}  /* keys() */
+
+/*--------------------------------------------------------------------*/
+
+static void setkeys (double *dst, const double *vals, int n)
+{                               /* --- set the sort keys of a record */
+  int    i;                     /* loop variable */
+  double v;                     /* value of a numeric field */
+
+  for (i = 0; i < keycnt; i++){ /* traverse the sort keys */
+    v = (keyfld[i] < n) ? keydir[i] *vals[keyfld[i]] : -INFINITY;
+    dst[i] = (isnan(v)) ? -INFINITY : v;
+  }                             /* store the keys as "larger first", */
+}  /* setkeys() */              /* missing values sort last */
+
+/*--------------------------------------------------------------------*/
+
+static int fields (const char *s, const char *info, double *vals)
+{                               /* --- get numeric fields of a line */
+  int  n = 0;                   /* number of fields */
+  char *e;                      /* end of a number */
+
+  s = strstr(s, info);          /* find the information part */
+  if (!s) return 0;             /* (skip the items of the set/rule) */
+  for (s += strlen(info); *s && (n < MAXFLD); ) {
+    if (((*s >= '0') && (*s <= '9'))
+    ||  (((*s == '-') || (*s == '+') || (*s == '.'))
+    &&   (s[1] >= '0') && (s[1] <= '9'))) {
+      vals[n] = strtod(s, &e);  /* if a number starts here, */
+      if (e > s) { n++; s = e; continue; }
+    }                           /* convert it and skip it */
+    s++;                        /* otherwise skip the character */
+  }
+  return n;                     /* return the number of fields */
+}  /* fields() */
+
+/* Fields are counted from the start of the information part, that */
+/* is, after the first occurrence of the information separator. As */
+/* item names cannot contain field separators, the first occurrence */
+/* of " (" or "," (for -v",%3S,%3C") reliably ends the items.       */
+
+/*--------------------------------------------------------------------*/
+
+static int rdline (FILE *file, size_t *size)
+{                               /* --- read a line of a text file */
+  size_t n = 0, k;              /* number of read characters */
+  char   *p;                    /* buffer for reallocation */
+
+  while (fgets(line +n, (int)(*size -n), file)) {
+    n += k = strlen(line +n);   /* read (the rest of) a line */
+    if ((n > 0) && (line[n-1] == '\n')) return (int)n;
+    if (n +1 < *size) break;    /* check for a complete line */
+    p = (char*)realloc(line, *size += *size);
+    if (!p) return -2;          /* enlarge the line buffer */
+    line = p;                   /* and continue reading */
+  }
+  if (ferror(file)) return -3;  /* check for a read error */
+  if (n <= 0) return -1;        /* check for end of file */
+  line[n++] = '\n'; line[n] = 0;/* terminate the last line */
+  return (int)n;                /* return the line length */
+}  /* rdline() */
+
+/*--------------------------------------------------------------------*/
+
+static int binline (RBREAD *rbr, const char *sep, const char *imp,
+                    size_t *size, double *vals)
+{                               /* --- format a binary set/rule */
+  int    i, k, n;               /* loop variable, number of items */
+  size_t len;                   /* length of an item name */
+  char   *p;                    /* buffer for reallocation */
+
+  k = rbr_size(rbr);            /* get the number of items */
+  for (n = i = 0; i < k; i++) { /* traverse the items */
+    len = strlen(rbr_name(rbr, rbr_items(rbr)[i])) +strlen(imp) +96;
+    if (n +len >= *size) {      /* if the line buffer is too small */
+      p = (char*)realloc(line, *size = *size +*size +len);
+      if (!p) return -2;        /* enlarge the line buffer */
+      line = p;                 /* (items, separators, numbers) */
+    }
+    if ((i > 1) || ((i > 0) && !rbr_isrule(rbr)))
+      n += sprintf(line+n, "%s", sep);  /* add a separator */
+    n += sprintf(line+n, "%s", rbr_name(rbr, rbr_items(rbr)[i]));
+    if ((i <= 0) && rbr_isrule(rbr))    /* add the item name and */
+      n += sprintf(line+n, "%s", imp);  /* the imp. sign after */
+  }                             /* the rule head (even if the body */
+                                /* of the rule is empty) */
+  if (n +128 >= (int)*size) {   /* ensure room for the numbers */
+    p = (char*)realloc(line, *size += 128);
+    if (!p) return -2;          /* enlarge the line buffer */
+    line = p;                   /* and set the new buffer */
+  }
+  vals[0] = rbr_supp(rbr);      /* collect the measures: support, */
+  vals[1] = rbr_body(rbr);      /* body and head support, */
+  vals[2] = rbr_head(rbr);      /* confidence, lift and evaluation */
+  vals[3] = (vals[1] > 0) ? vals[0] /vals[1] : 0;
+  vals[4] = ((vals[2] > 0) && (rbr_total(rbr) > 0))
+          ? vals[3] /(vals[2] /rbr_total(rbr)) : 0;
+  vals[5] = rbr_eval(rbr);
+  n += sprintf(line+n, " (%.16g", vals[0]);
+  if (rbr_isrule(rbr))          /* print the support (and the */
+    n += sprintf(line+n, ", %.16g, %.16g", vals[1], vals[2]);
+  if (eval && rbr_haseval(rbr)) /* body/head support for rules) */
+    n += sprintf(line+n, ", %.16g", vals[5]);
+  n += sprintf(line+n, ")\n");  /* print the evaluation (if any) */
+  return n;                     /* return the line length */
+}  /* binline() */
+
+/* For binary input the fields are fixed: 1 support, 2 body support, */
+/* 3 head support, 4 confidence, 5 lift, and 6 evaluation. The text */
+/* output has the same format as the output of the program repbin.  */
+
+/*----------------------------------------------------------------------
+  Run Functions
+----------------------------------------------------------------------*/
+
+static int reccmp (const void *p1, const void *p2)
+{                               /* --- compare two records */
+  int         i;                /* loop variable */
+  const RSREC *a = *(RSREC* const*)p1;
+  const RSREC *b = *(RSREC* const*)p2;
+
+  for (i = 0; i < keycnt; i++) {/* traverse the sort keys */
+    if (a->keys[i] > b->keys[i]) return -1;
+    if (a->keys[i] < b->keys[i]) return +1;
+  }                             /* larger keys come first, ties */
+  return (a->id < b->id) ? -1 : (a->id > b->id) ? +1 : 0;
+}  /* reccmp() */               /* keep the input order */
+
+/*--------------------------------------------------------------------*/
+
+static int runadd (RSRUN *run, long id, const char *text, int len,
+                   const double *vals, int n)
+{                               /* --- add a record to a run */
+  size_t z;                     /* size of the record */
+  RSREC  *r;                    /* new record */
+
+  z = ALIGN(offsetof(RSREC, keys) +(size_t)keycnt *sizeof(double)
+           +(size_t)len);       /* compute the record size */
+  if ((run->used +z > run->size) || (run->cnt >= run->max))
+    return (run->cnt > 0) ? 1 : -1;   /* check for a full run */
+  r = (RSREC*)(run->mem +run->used);
+  run->used += z;               /* get memory for the record */
+  r->id = id; r->len = len;     /* store position and length, */
+  setkeys(r->keys, vals, n);    /* the sort keys, and the text */
+  memcpy(r->keys +keycnt, text, (size_t)len);
+  run->recs[run->cnt++] = r;    /* add the record to the run */
+  return 0;                     /* return 'ok' */
+}  /* runadd() */
+
+/*--------------------------------------------------------------------*/
+
+static void* runsort (void *data)
+{                               /* --- sort and write a run */
+  size_t i, z;                  /* loop variable, record size */
+  RSRUN  *run = (RSRUN*)data;   /* run to sort and write */
+
+  qsort(run->recs, run->cnt, sizeof(RSREC*), reccmp);
+  run->file = tmpfile();        /* sort the records of the run */
+  if (!run->file) { run->err = E_TMPFILE; return NULL; }
+  for (i = 0; i < run->cnt; i++) {
+    z = offsetof(RSREC, keys) +(size_t)keycnt *sizeof(double)
+      + (size_t)run->recs[i]->len;
+    if (fwrite(run->recs[i], 1, z, run->file) != z) {
+      run->err = E_FWRITE; return NULL; }
+  }                             /* write the records to the file */
+  if (fflush(run->file) != 0) { run->err = E_FWRITE; return NULL; }
+  rewind(run->file);            /* prepare the file for reading */
+  return NULL;                  /* return a dummy result */
+}  /* runsort() */
+
+/*--------------------------------------------------------------------*/
+
+static int compact (void);      /* (merges written runs, see below) */
+
+static int runend (RSRUN *run)
+{                               /* --- finish a written run */
+  int r;                        /* result of merging runs */
+
+  #ifdef RS_THREADS             /* if multithreaded run generation */
+  if (run->busy) {              /* wait for the sorting thread */
+    pthread_join(run->thread, NULL); run->busy = 0; }
+  #endif
+  if (!run->file && !run->err)  /* check for a written run */
+    return 0;                   /* (or a failed attempt) */
+  run->cnt = run->used = 0;     /* clear the run for reuse */
+  if (run->err) return run->err;/* check for an error */
+  if ((tmpcnt >= MAXMERGE)      /* if too many runs are open, */
+  &&  ((r = compact()) != 0))   /* merge some of them first */
+    return r;                   /* (limits the number of files) */
+  tmplvl[tmpcnt]   = 0;         /* add the file of the run */
+  tmps[tmpcnt++] = run->file;   /* as a run of the lowest level */
+  run->file = NULL;             /* (not yet merged with other runs) */
+  return 0;                     /* return 'ok' */
+}  /* runend() */
+
+/*--------------------------------------------------------------------*/
+
+static int runwrite (RSRUN *run)
+{                               /* --- sort and write a full run */
+  run->err = 0;                 /* clear the error indicator */
+  #ifdef RS_THREADS             /* if multithreaded run generation */
+  if (runcnt > 1) {             /* if there are several runs, */
+    run->busy = 1;              /* sort and write in a new thread */
+    if (pthread_create(&run->thread, NULL, runsort, run) == 0)
+      return 0;                 /* (on failure sort and write */
+    run->busy = 0;              /* the run in the main thread) */
+  }
+  #endif
+  runsort(run);                 /* sort and write the run */
+  return runend(run);           /* and add it to the written runs */
+}  /* runwrite() */
+
+/*----------------------------------------------------------------------
+  Merge Functions
+----------------------------------------------------------------------*/
+
+static int rdrnext (RSIN *rdr)
+{                               /* --- read the next record of a run */
+  size_t z, n;                  /* size of the record header */
+  int    len;                   /* length of the record text */
+  RSREC  *r;                    /* buffer for reallocation */
+
+  z = offsetof(RSREC, keys) +(size_t)keycnt *sizeof(double);
+  n = fread(rdr->rec, 1, z, rdr->file);
+  if (n == 0) { rdr->done = 1; return feof(rdr->file) ? 0 : -1; }
+  if (n != z) return -1;        /* read the record header */
+  len = rdr->rec->len;          /* get the length of the text */
+  if (z +(size_t)len > rdr->size) {
+    r = (RSREC*)realloc(rdr->rec, rdr->size = z +(size_t)len);
+    if (!r) return -2;          /* enlarge the record buffer */
+    rdr->rec = r;               /* and set the new buffer */
+  }
+  n = fread(rdr->rec->keys +keycnt, 1, (size_t)len, rdr->file);
+  return (n == (size_t)len) ? 0 : -1;
+}  /* rdrnext() */              /* read the record text */
+
+/*--------------------------------------------------------------------*/
+
+static int beats (int a, int b)
+{                               /* --- compare two run readers */
+  if (rdrs[a].done) return 0;   /* an exhausted run always loses, */
+  if (rdrs[b].done) return 1;   /* otherwise compare the records */
+  return reccmp(&rdrs[a].rec, &rdrs[b].rec) < 0;
+}  /* beats() */
+
+/*--------------------------------------------------------------------*/
+
+static int merge (FILE **files, int k, FILE *out, int full)
+{                               /* --- merge sorted runs */
+  int    i, w, t, r;            /* loop variables, winner, result */
+  int    *tree, *win;           /* loser tree and winner buffer */
+  size_t z, n;                  /* size of the record header/output */
+
+  assert(files && (k > 0) && (k <= MAXMERGE) && out);
+  tree = (int*)malloc((size_t)(k+k) *2 *sizeof(int));
+  if (!tree) return E_NOMEM;    /* create the loser tree */
+  win  = tree +k+k;             /* and get the winner buffer */
+  z    = offsetof(RSREC, keys) +(size_t)keycnt *sizeof(double);
+  for (i = 0; i < k; i++) {     /* traverse the runs */
+    rdrs[i].file = files[i];    /* and read the first records */
+    rdrs[i].done = 0;           /* (the run readers are reused) */
+    if (!rdrs[i].rec) {         /* if there is no record buffer */
+      rdrs[i].size = z +BS_LINE;
+      rdrs[i].rec  = (RSREC*)malloc(rdrs[i].size);
+      if (!rdrs[i].rec) { free(tree); return E_NOMEM; }
+    }                           /* create a record buffer */
+    r = rdrnext(rdrs +i);       /* read the first record */
+    if (r) { free(tree); return (r < -1) ? E_NOMEM : E_FREAD; }
+  }
+  for (i = 0; i < k; i++)       /* the runs are the leaves */
+    win[k+i] = i;               /* of the tree (nodes k to 2k-1) */
+  for (i = k; --i > 0; ) {      /* play the initial matches */
+    w = win[i+i]; t = win[i+i+1];
+    if (beats(t, w)) { win[i] = t; tree[i] = w; }
+    else             { win[i] = w; tree[i] = t; }
+  }                             /* store the losers in the tree */
+  w = (k > 1) ? win[1] : 0;     /* get the overall winner */
+  while (!rdrs[w].done) {       /* while not all runs are exhausted */
+    n = (size_t)rdrs[w].rec->len;
+    if (full) n += z;           /* write the full record or its text */
+    if (fwrite((full) ? (void*)rdrs[w].rec
+                      : (void*)(rdrs[w].rec->keys +keycnt), 1, n, out)
+        != n) { free(tree); return E_FWRITE; }
+    r = rdrnext(rdrs +w);       /* write the winner's record */
+    if (r) { free(tree); return (r < -1) ? E_NOMEM : E_FREAD; }
+    for (i = (w+k) >> 1; i > 0; i >>= 1)
+      if (beats(tree[i], w)) { t = tree[i]; tree[i] = w; w = t; }
+  }                             /* replay the matches on the path */
+  free(tree);                   /* from the winner's leaf to the root */
+  return 0;                     /* return 'ok' */
+}  /* merge() */
+
+/* A loser tree needs only one comparison per level to find the next */
+/* record, since only the path of the last winner has to be replayed */
+/* (compared to two comparisons per level for a binary heap).        */
+
+/*--------------------------------------------------------------------*/
+
+static int compact (void)
+{                               /* --- merge the smallest runs */
+  int  i, k, l, r;              /* loop variables, level, result */
+  FILE *file;                   /* temporary file for merged runs */
+
+  assert(tmpcnt >= 2);          /* check the function argument */
+  for (i = tmpcnt; (i > 0) && (tmpcnt-i < 2); ) {
+    l = tmplvl[i-1];            /* collect the runs of the lowest */
+    while ((i > 0) && (tmplvl[i-1] <= l)) i--;
+  }                             /* level(s), at least two runs */
+  file = tmpfile();             /* create a temporary file */
+  if (!file) return E_TMPFILE;  /* for the merged runs */
+  r = merge(tmps+i, tmpcnt-i, file, 1);
+  if ((r == 0) && (fflush(file) != 0)) r = E_FWRITE;
+  for (k = i; k < tmpcnt; k++)  /* merge the runs and */
+    fclose(tmps[k]);            /* close their temporary files */
+  rewind(file);                 /* prepare the file for reading */
+  tmps[i] = file; tmplvl[i] = l+1;
+  tmpcnt  = i+1; mrgcnt++;      /* replace the merged runs */
+  return r;                     /* return an error indicator */
+}  /* compact() */
+
+/* Since only at most MAXMERGE temporary files are kept open (the   */
+/* number of open files is usually limited), runs are merged while */
+/* they are written. New runs start at level 0 and are appended, so */
+/* the levels are non-increasing: merging the runs of the lowest    */
+/* level(s), which are the smallest, keeps the number of times a    */
+/* record is rewritten logarithmic in the number of runs.          */
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+static void cleanup (void)
+{                               /* --- clean up memory and files */
+  int i;                        /* loop variable */
+
+  for (i = 0; i < runcnt; i++) {/* traverse the in-memory runs */
+    #ifdef RS_THREADS           /* if multithreaded run generation */
+    if (runs[i].busy) pthread_join(runs[i].thread, NULL);
+    #endif                      /* wait for a running thread */
+    if (runs[i].file) fclose(runs[i].file);
+    if (runs[i].mem)  free(runs[i].mem);
+    if (runs[i].recs) free(runs[i].recs);
+  }                             /* delete the record memory */
+  if (runs) free(runs);         /* delete the run array */
+  for (i = 0; i < MAXMERGE; i++)/* delete the record buffers */
+    if (rdrs[i].rec) free(rdrs[i].rec);  /* of the run readers */
+  for (i = 0; i < tmpcnt; i++)  /* close the temporary files */
+    fclose(tmps[i]);            /* of the written runs */
+  if (line)   free(line);       /* delete the line buffer */
+  if (rbread) rbr_close(rbread);
+  if (in  && (in  != stdin))  fclose(in);
+  if (out && (out != stdout)) fclose(out);
+}  /* cleanup() */
+
+/*--------------------------------------------------------------------*/
+
+#undef  CLEANUP
+#define CLEANUP  cleanup()
+
+GENERROR(error, exit)           /* generic error reporting function */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- main function */
+  int        i, k = 0, n, r;    /* loop variables, counters, result */
+  char       *s;                /* to traverse the options */
+  const char **optarg = NULL;   /* option argument */
+  const char *fn_inp  = NULL;   /* name of input  file */
+  const char *fn_out  = NULL;   /* name of output file */
+  const char *spec    = "1";    /* sort key specification */
+  const char *info    = " (";   /* start of information part */
+  const char *sep     = " ";    /* item separator for output */
+  const char *imp     = " <- "; /* implication sign for rules */
+  long       mem      = 64;     /* memory limit in MB */
+  int        thcnt    = 1;      /* number of threads */
+  size_t     size     = BS_LINE;/* size of the line buffer */
+  size_t     z;                 /* memory per run */
+  long       id;                /* number of records read */
+  char       hdr[4];            /* buffer for the file type check */
+  double     vals[MAXFLD];      /* numeric fields of a set/rule */
+  RSRUN      *run;              /* current run */
+  clock_t    t;                 /* timer for measurements */
+
+  #ifndef QUIET                 /* if not quiet version */
+  prgname = argv[0];            /* get program name for error msgs. */
+
+  /* --- print usage message --- */
+  if (argc > 1) {               /* if arguments are given */
+    fprintf(stderr, "%s - %s\n", argv[0], DESCRIPTION);
+    fprintf(stderr, VERSION); } /* print a startup message */
+  else {                        /* if no arguments given */
+    printf("usage: %s [options] infile [outfile]\n", argv[0]);
+    printf("%s\n", DESCRIPTION);
+    printf("%s\n", VERSION);
+    printf("-s#      list of numeric fields to sort on        "
+                    "(default: %s)\n", spec);
+    printf("         (e.g. -s2,1: second, then first number of the\n"
+           "          information part, descending; a negative\n"
+           "          number sorts in ascending order)\n");
+    printf("-i#      start of the information part (text)     "
+                    "(default: \"%s\")\n", info);
+    printf("-m#      memory limit for sorting in MB           "
+                    "(default: %ld)\n", mem);
+    #ifdef RS_THREADS
+    printf("-t#      number of threads for sorting runs       "
+                    "(default: %d)\n", thcnt);
+    #endif
+    printf("-k#      item separator   (for binary input)      "
+                    "(default: \"%s\")\n", sep);
+    printf("-I#      implication sign (for binary input)      "
+                    "(default: \"%s\")\n", imp);
+    printf("-e       print evaluation (for binary input)      "
+                    "(default: no)\n");
+    printf("         binary input fields: 1: support, "
+                    "2: body support, 3: head support,\n");
+    printf("         4: confidence, 5: lift, 6: evaluation\n");
+    printf("infile   file to read sets/rules from (text/binary) "
+                    "[required]\n");
+    printf("outfile  file to write sorted sets/rules to    "
+                    "[optional]\n");
+    return 0;                   /* print a usage message */
+  }                             /* and abort the program */
+  #endif  /* #ifndef QUIET */
+
+  /* --- evaluate arguments --- */
+  for (i = 1; i < argc; i++) {  /* traverse arguments */
+    s = argv[i];                /* get option argument */
+    if (optarg) { *optarg = s; optarg = NULL; continue; }
+    if ((*s == '-') && *++s) {  /* -- if argument is an option */
+      while (*s) {              /* traverse options */
+        switch (*s++) {         /* evaluate switches */
+          case 's': optarg = &spec;                 break;
+          case 'i': optarg = &info;                 break;
+          case 'm': mem    =      strtol(s, &s, 0); break;
+          case 't': thcnt  = (int)strtol(s, &s, 0); break;
+          case 'k': optarg = &sep;                  break;
+          case 'I': optarg = &imp;                  break;
+          case 'e': eval   = 1;                     break;
+          default : error(E_OPTION, *--s);          break;
+        }                       /* set option variables */
+        if (optarg && *s) { *optarg = s; optarg = NULL; break; }
+      } }                       /* get option argument */
+    else {                      /* -- if argument is no option */
+      switch (k++) {            /* evaluate non-options */
+        case  0: fn_inp = s;      break;
+        case  1: fn_out = s;      break;
+        default: error(E_ARGCNT); break;
+      }                         /* note filenames */
+    }
+  }
+  if (optarg) error(E_OPTARG);  /* check (option) arguments */
+  if (k < 1)  error(E_ARGCNT);  /* and number of arguments */
+  if (keys(spec) != 0) error(E_KEYS, spec);
+  if (mem < 1) mem = 1;         /* check the sort keys and */
+  #ifdef RS_THREADS             /* the memory limit */
+  if (thcnt < 1) thcnt = 1;     /* check the number of threads */
+  #else                         /* (one run per thread, so that */
+  thcnt = 1;                    /* runs can be sorted while the */
+  #endif                        /* next run is being read) */
+  MSG(stderr, "\n");            /* terminate the startup message */
+
+  /* --- create runs --- */
+  runcnt = (thcnt > 1) ? thcnt+1 : 1;
+  runs   = (RSRUN*)calloc((size_t)runcnt, sizeof(RSRUN));
+  line   = (char*) malloc(size);
+  if (!runs || !line) error(E_NOMEM);
+  z = ((size_t)mem << 20) /(size_t)runcnt;
+  for (i = 0; i < runcnt; i++) {/* split the memory between runs */
+    runs[i].max  = z /(sizeof(RSREC*) +ALIGN(sizeof(RSREC)) +16);
+    runs[i].size = z -runs[i].max *sizeof(RSREC*);
+    runs[i].mem  = (char*) malloc(runs[i].size);
+    runs[i].recs = (RSREC**)malloc(runs[i].max *sizeof(RSREC*));
+    if (!runs[i].mem || !runs[i].recs) error(E_NOMEM);
+  }                             /* (about 16 bytes of text assumed */
+                                /* for the size of the record array) */
+  /* --- read sets/rules --- */
+  t = clock();                  /* start timer, open input file */
+  if (!fn_inp || !*fn_inp) { in = stdin; fn_inp = "<stdin>"; }
+  else if (!(in = fopen(fn_inp, "rb"))) error(E_FOPEN, fn_inp);
+  if ((in != stdin)             /* check for a binary file */
+  &&  (fread(hdr, 1, 4, in) == 4) && (memcmp(hdr, "ISRB", 4) == 0)) {
+    rewind(in);                 /* (standard input is always text) */
+    rbread = rbr_open(in, fn_inp);
+    if (!rbread) error(E_FREAD, fn_inp); }
+  else if (in != stdin) rewind(in);
+  MSG(stderr, "reading %s ... ", fn_inp);
+  run = runs; k = 0;            /* start with the first run */
+  for (id = 0; 1; id++) {       /* record read loop */
+    if (rbread) {               /* if the input is binary */
+      r = rbr_next(rbread);     /* read the next set/rule */
+      if (r > 0) break;         /* check for end of file */
+      if (r < 0) error(E_FREAD, fn_inp);
+      r = binline(rbread, sep, imp, &size, vals);
+      n = 6; }                  /* format it and get the fields */
+    else {                      /* if the input is text */
+      r = rdline(in, &size);    /* read the next line */
+      if (r == -1) break;       /* check for end of file */
+      if (r < -1) error((r < -2) ? E_FREAD : E_NOMEM, fn_inp);
+      n = fields(line, info, vals);
+    }                           /* get the numeric fields */
+    if (r < 0) error(E_NOMEM);  /* check for a formatting error */
+    i = runadd(run, id, line, r, vals, n);
+    if (i < 0) error(E_NOMEM);  /* add the set/rule to the run */
+    if (i > 0) {                /* if the run is full */
+      if ((i = runwrite(run)) != 0) error(i, "<tmpfile>");
+      run = runs +(k = (k+1) % runcnt);
+      if ((i = runend(run)) != 0) error(i, "<tmpfile>");
+      if (runadd(run, id, line, r, vals, n) != 0) error(E_NOMEM);
+    }                           /* sort and write the run and */
+  }                             /* add the set/rule to the next run */
+  MSG(stderr, "[%ld set(s)/rule(s)] done [%.2fs].\n", id,
+      SEC_SINCE(t));            /* print a log message */
+
+  /* --- sort sets/rules --- */
+  t = clock();                  /* start timer, open output file */
+  if (!fn_out || !*fn_out) { out = stdout; fn_out = "<stdout>"; }
+  else if (!(out = fopen(fn_out, "w"))) error(E_FOPEN, fn_out);
+  for (i = 0; i < runcnt; i++)  /* wait for the sorting threads */
+    if ((r = runend(runs+i)) != 0) error(r, "<tmpfile>");
+  if (tmpcnt <= 0) {            /* if all records fit into memory */
+    MSG(stderr, "sorting and writing %s ... ", fn_out);
+    qsort(run->recs, run->cnt, sizeof(RSREC*), reccmp);
+    for (z = 0; z < run->cnt; z++)
+      fwrite(run->recs[z]->keys +keycnt, 1,
+             (size_t)run->recs[z]->len, out); }
+  else {                        /* if runs have been written */
+    if (run->cnt > 0) {         /* write the last run */
+      if ((r = runwrite(run)) != 0) error(r, "<tmpfile>");
+      if ((r = runend(run))   != 0) error(r, "<tmpfile>"); }
+    for (i = 0; i < runcnt; i++) {
+      free(runs[i].mem);  runs[i].mem  = NULL;
+      free(runs[i].recs); runs[i].recs = NULL;
+    }                           /* release the run memory */
+    MSG(stderr, "merging %d run(s) into %s ", tmpcnt, fn_out);
+    if (mrgcnt > 0) MSG(stderr, "[%ld intermediate merge(s)] ", mrgcnt);
+    MSG(stderr, "... ");        /* print a log message */
+    r = merge(tmps, tmpcnt, out, 0);
+    if (r) error(r, (r == E_FWRITE) ? fn_out : "<tmpfile>");
+  }
+  if (fflush(out) != 0)         /* check for a write error */
+    error(E_FWRITE, fn_out);
+  MSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
+
+  /* --- clean up --- */
+  CLEANUP;                      /* clean up memory and close files */
+  SHOWMEM;                      /* show (final) memory usage */
+  return 0;                     /* return 'ok' */
+}  /* main() */
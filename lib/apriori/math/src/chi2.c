@@ -5,12 +5,19 @@
   History : 2003.05.19 file created as quantile.c
             2008.03.14 main programs added
 ----------------------------------------------------------------------*/
+#ifndef _ISOC99_SOURCE
+#define _ISOC99_SOURCE
+#endif                          /* needed for functions erf()/erfc() */
 #if defined CHI2PDF_MAIN \
  || defined CHI2CDF_MAIN \
- || defined CHI2QTL_MAIN
+ || defined CHI2QTL_MAIN \
+ || defined CHI2_BENCH
 #include <stdio.h>
 #include <stdlib.h>
 #endif
+#ifdef CHI2_BENCH
+#include <time.h>
+#endif
 #ifdef CHI2QTL_MAIN
 #ifndef CHI2QTL
 #define CHI2QTL
@@ -27,6 +34,10 @@
 #endif
 #include "chi2.h"
 
+#if defined _MSC_VER && (_MSC_VER < 1800)
+#define NO_ERF                  /* MSC supports erf() only since */
+#endif                          /* Visual Studio 2013 */
+
 /*----------------------------------------------------------------------
   Functions
 ----------------------------------------------------------------------*/
@@ -45,6 +56,11 @@ double chi2pdf (double x, double df)
 double chi2cdfP (double x, double df)
 {                               /* --- cumulative distribution fn. */
   assert(df > 0);               /* check the function arguments */
+  if (x  <= 0) return 0;        /* treat x = 0 as a special case */
+  #ifndef NO_ERF
+  if (df == 1) return erf(sqrt(0.5*x));
+  #endif                        /* use closed forms for one */
+  if (df == 2) return -expm1(-0.5*x);  /* and two degrees of freedom */
   return GammaP(0.5*df, 0.5*x); /* compute regularized Gamma function */
 }  /* chi2cdfP() */
 
@@ -53,9 +69,36 @@ double chi2cdfP (double x, double df)
 double chi2cdfQ (double x, double df)
 {                               /* --- cumulative distribution fn. */
   assert(df > 0);               /* check the function arguments */
+  if (x  <= 0) return 1;        /* treat x = 0 as a special case */
+  #ifndef NO_ERF
+  if (df == 1) return erfc(sqrt(0.5*x));
+  #endif                        /* use closed forms for one */
+  if (df == 2) return exp(-0.5*x);     /* and two degrees of freedom */
   return GammaQ(0.5*df, 0.5*x); /* compute regularized Gamma function */
 }  /* chi2cdfQ() */
 
+/*----------------------------------------------------------------------
+For one degree of freedom the chi^2 distribution is the distribution
+of the square of a standard normal variable, so that
+  P(x) = erf(\sqrt(x/2))   and   Q(x) = erfc(\sqrt(x/2)).
+For two degrees of freedom it is an exponential distribution, so that
+  P(x) = 1 -exp(-x/2)      and   Q(x) = exp(-x/2).
+The closed forms are used instead of the series and continued fraction
+expansions of the regularized Gamma function, since they are faster
+(erfc() about 3.5 times). Compared to erfcl()/erfl() (long double),
+with one degree of freedom (benchmark program, CHI2_BENCH):
+  x in        rel. error of Q(x)           abs. error of P(x)
+              closed form  Gamma fn.       closed form  Gamma fn.
+  (0,    1]   3e-16        2e-15           1.2e-16      6.5e-16
+  (0,   10]   1.4e-15      1.2e-14         1.3e-16      1.1e-15
+  (0,  200]   1.8e-14      1.5e-14         1.1e-16      9.5e-16
+  (0, 1000]   8e-14        3.7e-14         1.1e-16      9.1e-16
+For large x the relative error of Q(x) is dominated by the condition
+of the function (a relative change of x changes Q(x) relatively by
+about x/2 times as much), which affects both methods. The closed forms
+need no tables or other state and thus are thread-safe.
+----------------------------------------------------------------------*/
+
 /*--------------------------------------------------------------------*/
 #ifdef CHI2QTL
 
@@ -149,3 +192,45 @@ int main (int argc, char *argv[])
 }  /* main() */
 
 #endif
+/*--------------------------------------------------------------------*/
+#ifdef CHI2_BENCH
+
+int main (int argc, char *argv[])
+{                               /* --- compare methods for df = 1 */
+  int         i, n = 2000000;   /* loop variable, number of points */
+  double      x, p, q;          /* argument, computed values */
+  double      max = 200;        /* maximal argument value */
+  double      ep = 0, eq = 0;   /* maximal errors of closed forms */
+  double      gp = 0, gq = 0;   /* maximal errors of Gamma functions */
+  long double r;                /* reference value (long double) */
+  clock_t     t;                /* timer for measurements */
+  volatile double s = 0;        /* sum of values (prevent removal) */
+
+  if (argc > 1) max = atof(argv[1]);
+  if (argc > 2) n   = atoi(argv[2]);
+  if ((max <= 0) || (n <= 0)) { /* get and check the arguments */
+    printf("usage: %s [max [points]]\n", argv[0]); return -1; }
+  for (i = 1; i <= n; i++) {    /* traverse the argument range */
+    x = i *(max/n);             /* and compare to long double values */
+    r = erfcl(sqrtl(0.5L*x));   /* (relative error for Q(x), */
+    q = fabs((double)((chi2cdfQ(x, 1) -r) /r)); if (q > eq) eq = q;
+    q = fabs((double)((GammaQ(0.5, 0.5*x) -r) /r)); if (q > gq) gq = q;
+    r = erfl (sqrtl(0.5L*x));   /*  absolute error for P(x)) */
+    p = fabs((double)(chi2cdfP(x, 1) -r)); if (p > ep) ep = p;
+    p = fabs((double)(GammaP(0.5, 0.5*x) -r)); if (p > gp) gp = p;
+  }
+  printf("chi^2 (df = 1), %d points in (0, %g]\n", n, max);
+  printf("max. rel. error of Q: closed form %.3g, Gamma fn. %.3g\n",
+         eq, gq);
+  printf("max. abs. error of P: closed form %.3g, Gamma fn. %.3g\n",
+         ep, gp);
+  t = clock();                  /* time the closed form */
+  for (i = 1; i <= n; i++) s += chi2cdfQ(i *(max/n), 1);
+  printf("closed form   : %.3fs\n", (clock()-t)/(double)CLOCKS_PER_SEC);
+  t = clock();                  /* time the Gamma function */
+  for (i = 1; i <= n; i++) s += GammaQ(0.5, 0.5 *(i *(max/n)));
+  printf("Gamma function: %.3fs\n", (clock()-t)/(double)CLOCKS_PER_SEC);
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
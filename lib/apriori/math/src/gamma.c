@@ -59,6 +59,20 @@ static double loghs[MAXFACT+1];
   Functions
 ----------------------------------------------------------------------*/
 
+#ifdef __GNUC__                 /* if supported by the compiler, */
+static void init (void) __attribute__((constructor));
+#define INIT()                  /* fill the tables on program load */
+#else                           /* otherwise fill them on first use */
+#define INIT()      do { if (facts[0] <= 0) init(); } while (0)
+#endif                          /* (not thread-safe in this case) */
+
+/*----------------------------------------------------------------------
+The tables are filled by a constructor function (if the compiler
+supports this), that is, before main() is called or when a shared
+library is loaded. Hence they are never written after threads may
+have been started and all functions of this module are thread-safe.
+----------------------------------------------------------------------*/
+
 static void init (void)
 {                               /* --- init. factorial tables */
   int    i;                     /* loop variable */
@@ -86,7 +100,7 @@ double logGamma (double n)
   double s;                     /*           = ln((n-1)!), n \in IN */
 
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return logfs[(int)floor(n)-1];
@@ -110,7 +124,7 @@ double logGamma (double n)
   double s;                     /*           = ln((n-1)!), n \in IN */
 
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return logfs[(int)floor(n)-1];
@@ -154,7 +168,7 @@ in the second version, the value is slightly more accurate.
 double Gamma (double n)
 {                               /* --- compute Gamma(n) = (n-1)! */
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return facts[(int)floor(n)-1];
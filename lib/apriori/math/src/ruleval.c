@@ -15,10 +15,17 @@
 #include "chi2.h"
 #include "ruleval.h"
 
+#if defined _MSC_VER && !defined __cplusplus
+#define inline __inline         /* MSC knows inline only as __inline */
+#endif                          /* (when compiling C, not C++) */
+
 /*----------------------------------------------------------------------
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
 #define LN_2        0.69314718055994530942  /* ln(2) */
+#define LF_BLKSIZE  1024        /* block size of log-factorial table */
+#define LF_MAXSIZE  (1 << 22)   /* maximal size of log-fact. table */
+#define HG_MAXMEM   (1 << 22)   /* maximal number of cached values */
 
 /*----------------------------------------------------------------------
   Type Definitions
@@ -28,6 +35,236 @@ typedef struct {                /* --- rule evaluation info. --- */
   int       dir;                /* evaluation direction */
 } REINFO;                       /* (rule evaluation information) */
 
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static double logfact (RECACHE *c, int n)
+{                               /* --- compute ln(n!) */
+  int    i, k;                  /* loop variable, new table size */
+  double *p;                    /* reallocated table */
+
+  assert(n >= 0);               /* check the function argument */
+  if (!c)                       /* if there is no cache, */
+    return logGamma(n+1);       /* compute the value directly */
+  if (n < c->lfsize)            /* if the value is in the table, */
+    return c->lfacts[n];        /* simply return it */
+  if (n >= LF_MAXSIZE)          /* if the argument is very large, */
+    return logGamma(n+1);       /* compute the value directly */
+  k = c->lfsize +((c->lfsize > LF_BLKSIZE) ? c->lfsize >> 1
+                                           : LF_BLKSIZE);
+  if (k <= n)         k = n+1;  /* compute the new table size */
+  if (k > LF_MAXSIZE) k = LF_MAXSIZE;
+  p = (double*)realloc(c->lfacts, (size_t)k *sizeof(double));
+  if (!p) return logGamma(n+1); /* enlarge the log-factorial table */
+  for (i = c->lfsize; i < k; i++)
+    p[i] = logGamma(i+1);       /* fill the new table entries */
+  c->lfacts = p; c->lfsize = k; /* (same values as direct calls) */
+  return p[n];                  /* return the requested value */
+}  /* logfact() */
+
+/*--------------------------------------------------------------------*/
+
+static double logcom (RECACHE *c, int body, int head, int rest)
+{                               /* --- common probability term */
+  return logfact(c, head)      +logfact(c, body)
+       + logfact(c, body+rest) +logfact(c, head+rest)
+       - logfact(c, body+head+rest);
+}  /* logcom() */
+
+/*--------------------------------------------------------------------*/
+
+static double logprob (RECACHE *c, int supp, int body, int head,
+                       int rest, double com)
+{                               /* --- log. of a table probability */
+  return com -logfact(c, body-supp) -logfact(c, head-supp)
+             -logfact(c,      supp) -logfact(c, rest+supp);
+}  /* logprob() */
+
+/*--------------------------------------------------------------------*/
+
+static void hgflush (RECACHE *c)
+{                               /* --- flush distribution cache */
+  int i;                        /* loop variable */
+
+  for (i = 0; i < RE_SLOTS; i++) {
+    if (c->dists[i].logp) free(c->dists[i].logp);
+    c->dists[i].logp = c->dists[i].prob = NULL;
+    c->dists[i].size = c->dists[i].valid = 0;
+  }                             /* delete all cached distributions */
+  c->mem = 0;                   /* there are no cached values */
+}  /* hgflush() */
+
+/*--------------------------------------------------------------------*/
+
+static REDIST* hgdist (RECACHE *c, int body, int head, int rest,
+                       double com)
+{                               /* --- get a hypergeom. distribution */
+  int    i, n;                  /* loop variable, number of values */
+  size_t h;                     /* hash value of the marginals */
+  REDIST *d;                    /* cached distribution */
+  double *p;                    /* reallocated arrays */
+
+  if (!c) return NULL;          /* check for a cache */
+  h = ((size_t)body *16777619u ^ (size_t)head) *16777619u
+    ^  (size_t)rest;            /* hash the (normalized) marginals */
+  d = c->dists +(h % RE_SLOTS); /* and get the corresponding slot */
+  if ((d->body != body) || (d->head != head) || (d->rest != rest)) {
+    d->body = body; d->head = head; d->rest = rest;
+    d->valid = 0; return NULL;  /* if the marginals are new, */
+  }                             /* only note them in the slot */
+  if (d->valid) return d;       /* if the distribution is cached */
+  n = body+1;                   /* get the number of tables */
+  if (n > d->size) {            /* if the arrays are too small */
+    if (2*n > HG_MAXMEM)        /* if the distribution is too large, */
+      return NULL;              /* it is computed on the fly */
+    if (c->mem +2*(n -d->size) > HG_MAXMEM) {
+      hgflush(c); d->body = body; d->head = head; d->rest = rest; }
+    p = (double*)realloc(d->logp, 2*(size_t)n *sizeof(double));
+    if (!p) return NULL;        /* enlarge the probability arrays */
+    c->mem += 2*(n -d->size);   /* (flush the cache if it is full) */
+    d->logp = p; d->prob = p+n; d->size = n;
+  }                             /* set the new arrays */
+  for (i = 0; i < n; i++)       /* mark all table probabilities */
+    d->logp[i] = 1;             /* as not yet computed (log > 0) */
+  d->com = com; d->valid = 1;   /* note the common probability term */
+  return d;                     /* return the cached distribution */
+}  /* hgdist() */
+
+/*--------------------------------------------------------------------*/
+
+static double hglogp (RECACHE *c, REDIST *d, int supp)
+{                               /* --- get log. of table probability */
+  if (d->logp[supp] > 0.5)      /* if not yet computed, compute it */
+    d->prob[supp] = exp(d->logp[supp] =
+      logprob(c, supp, d->body, d->head, d->rest, d->com));
+  return d->logp[supp];         /* return the logarithm */
+}  /* hglogp() */
+
+/*--------------------------------------------------------------------*/
+
+static double hgprob (RECACHE *c, REDIST *d, int supp)
+{                               /* --- get a table probability */
+  if (d->logp[supp] > 0.5) hglogp(c, d, supp);
+  return d->prob[supp];         /* compute the probability if needed */
+}  /* hgprob() */
+
+/*----------------------------------------------------------------------
+The tail sums of Fisher's exact test only depend on the (normalized)
+marginals of the contingency table, which are shared by many rules
+(all rules with the same head and the same body support). Therefore
+the logarithms of the table probabilities and the probabilities are
+kept in a small direct mapped cache once a set of marginals is seen
+for the second time. The entries are computed on demand (most tail
+sums do not need all tables) with the same expressions as a direct
+computation, so that the results are exactly the same. The cache is
+passed explicitly (see re_create(), re_eval() and re_batch()), so that
+each caller (e.g. each item set tree) can use its own; without a cache
+(as for the functions re_fet*()) everything is computed directly.
+----------------------------------------------------------------------*/
+#define LOGP(s) ((d) ? hglogp(c, d, s) \
+                     : logprob(c, s, body, head, rest, com))
+#define PROB(s) ((d) ? hgprob(c, d, s) \
+                     : exp(logprob(c, s, body, head, rest, com)))
+
+/*----------------------------------------------------------------------
+  Closed Form Measures
+------------------------------------------------------------------------
+The following functions compute the closed form measures for a single
+rule and are used by the rule evaluation functions as well as by the
+function re_batch(). Invalid marginals are not handled with branches:
+the denominators are replaced by 1, the value is computed anyway, and
+the flag *ok tells whether it is valid. Since the functions are
+inlined, the loops of re_batch() contain only selections and can be
+vectorized, and a batch yields exactly the same values as single rules.
+----------------------------------------------------------------------*/
+
+static inline double conf (int supp, int body, int *ok)
+{                               /* --- rule confidence */
+  *ok = (body > 0);             /* check for a valid body support */
+  return supp /(double)(*ok ? body : 1);
+}  /* conf() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double confdiff (int supp, int body, int head, int base,
+                               int *ok)
+{                               /* --- absolute confidence difference */
+  *ok = (body > 0) & (base > 0);
+  return fabs(supp /(double)(*ok ? body : 1)
+             -head /(*ok ? (double)base : 1));
+}  /* confdiff() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double lift (int supp, int body, int head, int base,
+                           int *ok)
+{                               /* --- lift value */
+  *ok = (body > 0) & (head > 0);
+  return (supp*(double)base) /(*ok ? body*(double)head : 1);
+  /* =   (supp/(double)body) /(head/(double)base) */
+}  /* lift() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double cvct (int supp, int body, int head, int base,
+                           int *ok)
+{                               /* --- conviction */
+  *ok = (base > 0) & (body > supp);
+  return (body*(double)(base-head))
+       / (*ok ? (body-supp)*(double)base : 1);
+  /* = (body/(double)(body-supp)) *((base-head)/(double)base); */
+}  /* cvct() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double quot (double t)
+{                               /* --- difference of quotient to 1 */
+  double d = 1 /((t > 1) ? t : 1);
+  return 1 -((t > 1) ? d : t);  /* use the quotient that is <= 1 */
+}  /* quot() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double cert (int supp, int body, int head, int base,
+                           int *ok)
+{                               /* --- certainty factor */
+  double n, p;                  /* temporary buffers */
+
+  *ok = (body > 0) & (base > 0);
+  p = head /(*ok ? (double)base : 1);
+  n = supp /(double)(*ok ? body : 1) -p;
+  return n /((n >= 0) ? 1-p : p);
+}  /* cert() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double chi2 (int supp, int body, int head, int base,
+                           int *ok)
+{                               /* --- normalized chi^2 measure */
+  double t;                     /* temporary buffer */
+
+  *ok = (head > 0) & (head < base)   /* check for */
+      & (body > 0) & (body < base);  /* non-vanishing marginals */
+  t = head *(double)body -supp *(double)base;
+  return (t*t) /(*ok ? ((double)head)*(base-head)
+                      *((double)body)*(base-body) : 1);
+}  /* chi2() */
+
+/*--------------------------------------------------------------------*/
+
+static inline double yates (int supp, int body, int head, int base,
+                            int *ok)
+{                               /* --- Yates corrected chi^2 measure */
+  double t;                     /* temporary buffer */
+
+  *ok = (head > 0) & (head < base)   /* check for */
+      & (body > 0) & (body < base);  /* non-vanishing marginals */
+  t = fabs(head *(double)body -supp *(double)base) -0.5*base;
+  return (t*t) /(*ok ? ((double)head)*(base-head)
+                      *((double)body)*(base-body) : 1);
+}  /* yates() */
+
 /*----------------------------------------------------------------------
   Rule Evaluation Measures
 ----------------------------------------------------------------------*/
@@ -44,96 +281,81 @@ double re_supp (int supp, int body, int head, int base)
 
 double re_conf (int supp, int body, int head, int base)
 {                               /* --- rule confidence */
-  return (body > 0) ? supp/(double)body : 0;
+  int k; double t = conf(supp, body, &k);
+  return k ? t : 0;             /* compute and return the confidence */
 }  /* re_conf() */
 
 /*--------------------------------------------------------------------*/
 
 double re_confdiff (int supp, int body, int head, int base)
 {                               /* --- absolute confidence difference */
-  if ((body <= 0) || (base <= 0)) return 0;
-  return fabs(supp/(double)body -head/(double)base);
+  int k; double t = confdiff(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return the difference */
 }  /* re_confdiff() */
 
 /*--------------------------------------------------------------------*/
 
 double re_lift (int supp, int body, int head, int base)
 {                               /* --- lift value */
-  if ((body <= 0) || (head <= 0)) return 0;
-  return (supp*(double)base) /(body*(double)head);
-  /* =   (supp/(double)body) /(head/(double)base) */
+  int k; double t = lift(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return the lift */
 }  /* re_lift() */
 
 /*--------------------------------------------------------------------*/
 
 double re_liftdiff (int supp, int body, int head, int base)
 {                               /* --- abs. difference of lift to 1 */
-  if ((body <= 0) || (head <= 0)) return 0;
-  return fabs((supp*(double)base) /(body*(double)head) -1);
+  int k; double t = lift(supp, body, head, base, &k);
+  return k ? fabs(t-1) : 0;     /* compute lift and difference */
 }  /* re_liftdiff() */
 
 /*--------------------------------------------------------------------*/
 
 double re_liftquot (int supp, int body, int head, int base)
 {                               /* --- diff. of lift quotient to 1 */
-  double t;                     /* temporary buffer */
-
-  if ((body <= 0) || (head <= 0)) return 0;
-  t = (supp*(double)base) /(body*(double)head);
-  return 1 -((t > 1) ? 1/t : t);
+  int k; double t = lift(supp, body, head, base, &k);
+  return k ? quot(t) : 0;       /* compute lift and quotient */
 }  /* re_liftquot() */
 
 /*--------------------------------------------------------------------*/
 
 double re_cvct (int supp, int body, int head, int base)
 {                               /* --- conviction */
-  if ((base <= 0) || (body <= supp)) return 0;
-  return (body*(double)(base-head)) /((body-supp)*(double)base);
-  /*   = (body/(double)(body-supp)) *((base-head)/(double)base); */
+  int k; double t = cvct(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return the conviction */
 }  /* re_cvct() */
 
 /*--------------------------------------------------------------------*/
 
 double re_cvctdiff (int supp, int body, int head, int base)
 {                               /* --- abs. diff. of conviction to 1 */
-  if ((base <= 0) || (body <= supp)) return 0;
-  return fabs((body*(double)(base-head)) /((body-supp)*(double)base)-1);
+  int k; double t = cvct(supp, body, head, base, &k);
+  return k ? fabs(t-1) : 0;     /* compute conviction and difference */
 }  /* re_cvctdiff() */
 
 /*--------------------------------------------------------------------*/
 
 double re_cvctquot (int supp, int body, int head, int base)
 {                               /* --- diff. of conviction quot. to 1 */
-  double t;                     /* temporary buffer */
-
-  if ((base <= 0) || (body <= supp)) return 0;
-  t = (body*(double)(base-head)) /((body-supp)*(double)base);
-  return 1 -((t > 1) ? 1/t : t);
+  int k; double t = cvct(supp, body, head, base, &k);
+  return k ? quot(t) : 0;       /* compute conviction and quotient */
 }  /* re_cvctquot() */
 
 /*--------------------------------------------------------------------*/
 
 double re_cert (int supp, int body, int head, int base)
 {                               /* --- certainty factor */
-  double n, p;                  /* temporary buffers */
-
-  if ((body <= 0) || (base <= 0)) return 0;
-  p = head/(double)base; n = supp/(double)body -p;
-  return n / ((n >= 0) ? 1-p : p);
+  int k; double t = cert(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return the certainty */
 }  /* re_cert() */
 
 /*--------------------------------------------------------------------*/
 
 double re_chi2 (int supp, int body, int head, int base)
 {                               /* --- normalized chi^2 measure */
-  double t;                     /* temporary buffer */
-
-  if ((head <= 0) || (head >= base)
-  ||  (body <= 0) || (body >= base))
-    return 0;                   /* check for non-vanishing marginals */
-  t = head *(double)body -supp *(double)base;
-  return (t*t) /(((double)head)*(base-head)*((double)body)*(base-body));
-}  /* re_chi2() */              /* compute and return chi^2 measure */
+  int k; double t = chi2(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return chi^2 measure */
+}  /* re_chi2() */
 
 /*--------------------------------------------------------------------*/
 
@@ -146,14 +368,9 @@ double re_chi2pval (int supp, int body, int head, int base)
 
 double re_yates (int supp, int body, int head, int base)
 {                               /* --- Yates corrected chi^2 measure */
-  double t;                     /* temporary buffer */
-
-  if ((head <= 0) || (head >= base)
-  ||  (body <= 0) || (body >= base))
-    return 0;                   /* check for non-vanishing marginals */
-  t = fabs(head *(double)body -supp *(double)base) -0.5*base;
-  return (t*t) /(((double)head)*(base-head)*((double)body)*(base-body));
-}  /* re_yates() */             /* compute and return chi^2 measure */
+  int k; double t = yates(supp, body, head, base, &k);
+  return k ? t : 0;             /* compute and return chi^2 measure */
+}  /* re_yates() */
 
 /*--------------------------------------------------------------------*/
 
@@ -191,12 +408,14 @@ double re_infopval (int supp, int body, int head, int base)
 
 /*--------------------------------------------------------------------*/
 
-double re_fetprob (int supp, int body, int head, int base)
+static double fetprob (int supp, int body, int head, int base,
+                       RECACHE *c, double maxp)
 {                               /* --- Fisher's exact test (prob.) */
   int    rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
-  double cut, p;                /* (cutoff value for) probability */
+  double cut;                   /* cutoff value for probability */
   double sum;                   /* probability sum of conting. tables */
+  REDIST *d;                    /* (cached) distribution */
 
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
@@ -208,32 +427,31 @@ double re_fetprob (int supp, int body, int head, int base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma(     head+1) +logGamma(     body+1)
-      + logGamma(base-head+1) +logGamma(base-body+1)
-      - logGamma(base+1);       /* compute common probability term */
-  cut = com                     /* and log of the cutoff probability */
-      - logGamma(body-supp+1) -logGamma(head-supp+1)
-      - logGamma(     supp+1) -logGamma(rest+supp+1);
+  com = logcom(c, body, head, rest);/* compute common prob. term */
+  d   = hgdist(c, body, head, rest, com);
+  cut = LOGP(supp);             /* get log of the cutoff probability */
   cut *= 1.0-DBL_EPSILON;       /* adapt for roundoff errors */
   /* cut must be multiplied with a value < 1 in order to increase it, */
   /* because it is the logarithm of a probability and hence negative. */
   for (sum = supp = 0; supp <= body; supp++) {
-    p = com                     /* traverse the contingency tables */
-      - logGamma(body-supp+1) -logGamma(head-supp+1)
-      - logGamma(     supp+1) -logGamma(rest+supp+1);
-    if (p <= cut) sum += exp(p);/* sum probabilities greater */
-  }                             /* than the cutoff probability */
+    if (LOGP(supp) > cut)       /* traverse the contingency tables */
+      continue;                 /* and sum the probabilities greater */
+    sum += PROB(supp);          /* than the cutoff probability */
+    if (sum > maxp) break;      /* abort if the sum gets too large */
+  }                             /* (cannot reach maximal p-value) */
   return sum;                   /* return computed probability */
-}  /* re_fetprob() */
+}  /* fetprob() */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetchi2 (int supp, int body, int head, int base)
+static double fetchi2 (int supp, int body, int head, int base,
+                       RECACHE *c, double maxp)
 {                               /* --- Fisher's exact test (chi^2) */
   int    rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
   double exs;                   /* expected support value */
   double sum;                   /* probability sum of conting. tables */
+  REDIST *d;                    /* (cached) distribution */
 
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
@@ -245,40 +463,39 @@ double re_fetchi2 (int supp, int body, int head, int base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma(     head+1) +logGamma(     body+1)
-      + logGamma(base-head+1) +logGamma(base-body+1)
-      - logGamma(base+1);       /* compute common probability term */
+  com = logcom(c, body, head, rest);/* compute common prob. term */
+  d   = hgdist(c, body, head, rest, com);
   exs = head *(double)body /(double)base;
   if (supp < exs) { n =              (int)ceil (exs+(exs-supp)); }
   else            { n = supp; supp = (int)floor(exs-(supp-exs)); }
   if (n > body) n = body+1;     /* compute the range of values and */
   if (supp < 0) supp = -1;      /* clamp it to the possible maximum */
   if (n-supp-4 < supp+body-n) { /* if fewer less extreme tables */
-    for (sum = 1; ++supp < n;){ /* traverse the less extreme tables */
-      sum -= exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1));
-    } }                         /* sum the probability of the tables */
+    for (sum = 1; ++supp < n; ) /* traverse the less extreme tables */
+      sum -= PROB(supp); }      /* sum the probability of the tables */
   else {                        /* if fewer more extreme tables */
     for (sum = 0; supp >= 0; supp--) {
-      sum += exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1));
-    }                           /* traverse the more extreme tables */
+      sum += PROB(supp);        /* traverse the more extreme tables */
+      if (sum > maxp) return sum;
+    }                           /* abort if the sum gets too large */
     for (supp = n; supp <= body; supp++) {
-      sum += exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1));
-    }                           /* sum the probability of the tables */
+      sum += PROB(supp);        /* sum the probability of the tables */
+      if (sum > maxp) return sum;
+    }                           /* abort if the sum gets too large */
   }                             /* (upper and lower table ranges) */
   return sum;                   /* return computed probability */
-}  /* re_fetchi2() */
+}  /* fetchi2() */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetinfo (int supp, int body, int head, int base)
+static double fetinfo (int supp, int body, int head, int base,
+                       RECACHE *c, double maxp)
 {                               /* --- Fisher's exact test (info.) */
   int    rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
   double cut;                   /* cutoff value for information gain */
   double sum;                   /* probability sum of conting. tables */
+  REDIST *d;                    /* (cached) distribution */
 
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
@@ -290,25 +507,27 @@ double re_fetinfo (int supp, int body, int head, int base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma(     head+1) +logGamma(     body+1)
-      + logGamma(base-head+1) +logGamma(base-body+1)
-      - logGamma(base+1);       /* compute common probability term */
+  com = logcom(c, body, head, rest);/* compute common prob. term */
+  d   = hgdist(c, body, head, rest, com);
   cut = re_info(supp, body, head, base) *(1.0-DBL_EPSILON);
   for (sum = supp = 0; supp <= body; supp++) {
-    if (re_info(supp, body, head, base) >= cut)
-      sum += exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1));
-  }                             /* sum probs. of less extreme tables */
+    if (re_info(supp, body, head, base) < cut)
+      continue;                 /* skip the less extreme tables */
+    sum += PROB(supp);          /* sum probs. of more extreme tables */
+    if (sum > maxp) break;      /* abort if the sum gets too large */
+  }                             /* (cannot reach maximal p-value) */
   return sum;                   /* return computed probability */
-}  /* re_fetinfo() */
+}  /* fetinfo() */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetsupp (int supp, int body, int head, int base)
+static double fetsupp (int supp, int body, int head, int base,
+                       RECACHE *c, double maxp)
 {                               /* --- Fisher's exact test (support) */
   int    rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
   double sum;                   /* probability sum of conting. tables */
+  REDIST *d;                    /* (cached) distribution */
 
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
@@ -320,19 +539,46 @@ double re_fetsupp (int supp, int body, int head, int base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma(     head+1) +logGamma(     body+1)
-      + logGamma(base-head+1) +logGamma(base-body+1)
-      - logGamma(base+1);       /* compute common probability term */
+  com = logcom(c, body, head, rest);/* compute common prob. term */
+  d   = hgdist(c, body, head, rest, com);
   if (supp <= body -supp) {     /* if fewer lesser support values */
     for (sum = 1.0; --supp >= 0; )
-      sum -= exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1)); }
+      sum -= PROB(supp); }      /* sum the table probabilities */
   else {                        /* if fewer greater support values */
-    for (sum = 0.0; supp <= body; supp++)
-      sum += exp(com -logGamma(body-supp+1) -logGamma(head-supp+1)
-                     -logGamma(     supp+1) -logGamma(rest+supp+1));
-  }                             /* sum the table probabilities */
+    for (sum = 0.0; supp <= body; supp++) {
+      sum += PROB(supp);        /* sum the table probabilities */
+      if (sum > maxp) break;    /* abort if the sum gets too large */
+    }                           /* (cannot reach maximal p-value) */
+  }
   return sum;                   /* return computed probability */
+}  /* fetsupp() */
+
+/*--------------------------------------------------------------------*/
+
+double re_fetprob (int supp, int body, int head, int base)
+{                               /* --- Fisher's exact test (prob.) */
+  return fetprob(supp, body, head, base, NULL, DBL_MAX);
+}  /* re_fetprob() */
+
+/*--------------------------------------------------------------------*/
+
+double re_fetchi2 (int supp, int body, int head, int base)
+{                               /* --- Fisher's exact test (chi^2) */
+  return fetchi2(supp, body, head, base, NULL, DBL_MAX);
+}  /* re_fetchi2() */
+
+/*--------------------------------------------------------------------*/
+
+double re_fetinfo (int supp, int body, int head, int base)
+{                               /* --- Fisher's exact test (info.) */
+  return fetinfo(supp, body, head, base, NULL, DBL_MAX);
+}  /* re_fetinfo() */
+
+/*--------------------------------------------------------------------*/
+
+double re_fetsupp (int supp, int body, int head, int base)
+{                               /* --- Fisher's exact test (support) */
+  return fetsupp(supp, body, head, base, NULL, DBL_MAX);
 }  /* re_fetsupp() */
 
 /*--------------------------------------------------------------------*/
@@ -376,3 +622,151 @@ int re_dir (int id)
   assert((id >= 0) && (id <= RE_FNCNT));
   return reinfo[id].dir;        /* retrieve direction from table */
 }  /* re_dir() */
+
+/*--------------------------------------------------------------------*/
+
+void re_batch (int id, const int *supp, const int *body,
+               const int *head, int base, double *vals, int n,
+               RECACHE *cache, double pmax)
+{                               /* --- evaluate a batch of rules */
+  int    i;                     /* loop variable */
+  int    k;                     /* flag for valid marginals */
+  double t;                     /* temporary buffer */
+
+  assert((id >= 0) && (id <= RE_FNCNT)
+  &&     supp && body && head && vals && (n >= 0));
+  switch (id) {                 /* evaluate closed form measures */
+    case RE_NONE:               /* in loops without calls (the */
+      for (i = 0; i < n; i++)   /* measure functions are inlined), */
+        vals[i] = 0;            /* so that they can be vectorized */
+      break;
+    case RE_SUPP:
+      for (i = 0; i < n; i++)
+        vals[i] = (double)supp[i];
+      break;
+    case RE_CONF:
+      for (i = 0; i < n; i++) {
+        t = conf(supp[i], body[i], &k);
+        vals[i] = k ? t : 0;
+      } break;
+    case RE_CONFDIFF:
+      for (i = 0; i < n; i++) {
+        t = confdiff(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      } break;
+    case RE_LIFT:
+      for (i = 0; i < n; i++) {
+        t = lift(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      } break;
+    case RE_LIFTDIFF:
+      for (i = 0; i < n; i++) {
+        t = lift(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? fabs(t-1) : 0;
+      } break;
+    case RE_LIFTQUOT:
+      for (i = 0; i < n; i++) {
+        t = lift(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? quot(t) : 0;
+      } break;
+    case RE_CVCT:
+      for (i = 0; i < n; i++) {
+        t = cvct(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      } break;
+    case RE_CVCTDIFF:
+      for (i = 0; i < n; i++) {
+        t = cvct(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? fabs(t-1) : 0;
+      } break;
+    case RE_CVCTQUOT:
+      for (i = 0; i < n; i++) {
+        t = cvct(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? quot(t) : 0;
+      } break;
+    case RE_CERT:
+      for (i = 0; i < n; i++) {
+        t = cert(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      } break;
+    case RE_CHI2: case RE_CHI2PVAL:
+      for (i = 0; i < n; i++) {
+        t = chi2(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      }                         /* compute the chi^2 measure */
+      if (id == RE_CHI2PVAL)    /* compute p-values if requested */
+        for (i = 0; i < n; i++) vals[i] = chi2cdfQ(base *vals[i], 1);
+      break;
+    case RE_YATES: case RE_YATESPVAL:
+      for (i = 0; i < n; i++) {
+        t = yates(supp[i], body[i], head[i], base, &k);
+        vals[i] = k ? t : 0;
+      }                         /* compute the Yates corr. chi^2 */
+      if (id == RE_YATESPVAL)   /* compute p-values if requested */
+        for (i = 0; i < n; i++) vals[i] = chi2cdfQ(base *vals[i], 1);
+      break;
+    default:                    /* other measures (logarithms, */
+      for (i = 0; i < n; i++)   /* sums over contingency tables) */
+        vals[i] = re_eval(id, supp[i], body[i], head[i], base,
+                          cache, pmax);
+      break;                    /* evaluate the rules one by one */
+  }                             /* for each rule of the batch */
+}  /* re_batch() */
+
+/*----------------------------------------------------------------------
+The loops for the closed form measures contain only selections, which
+gcc turns into vector code if it need not keep floating point traps
+(option -fno-trapping-math, see makefile). The results do not depend
+on this option: each value is computed by the same inline function as
+is used by the evaluation function for a single rule.
+----------------------------------------------------------------------*/
+
+/*--------------------------------------------------------------------*/
+
+RECACHE* re_create (void)
+{                               /* --- create a Fisher test cache */
+  return (RECACHE*)calloc(1, sizeof(RECACHE));
+}  /* re_create() */
+
+/*--------------------------------------------------------------------*/
+
+void re_delete (RECACHE *cache)
+{                               /* --- delete a Fisher test cache */
+  assert(cache);                /* check the function argument */
+  hgflush(cache);               /* delete the distribution cache */
+  if (cache->lfacts) free(cache->lfacts);
+  free(cache);                  /* delete the log-factorial table */
+}  /* re_delete() */            /* and the cache body */
+
+/*--------------------------------------------------------------------*/
+
+double re_eval (int id, int supp, int body, int head, int base,
+                RECACHE *cache, double pmax)
+{                               /* --- evaluate a rule with a cache */
+  assert((id >= 0) && (id <= RE_FNCNT));
+  if (pmax < 0) pmax = DBL_MAX; /* check the maximal p-value */
+  switch (id) {                 /* evaluate Fisher's exact tests */
+    case RE_FETPROB:            /* with the cache and the cutoff */
+      return fetprob(supp, body, head, base, cache, pmax);
+    case RE_FETCHI2:
+      return fetchi2(supp, body, head, base, cache, pmax);
+    case RE_FETINFO:
+      return fetinfo(supp, body, head, base, cache, pmax);
+    case RE_FETSUPP:
+      return fetsupp(supp, body, head, base, cache, pmax);
+    default:                    /* call other evaluation functions */
+      return reinfo[id].fn(supp, body, head, base);
+  }                             /* directly (they need no cache) */
+}  /* re_eval() */
+
+/*----------------------------------------------------------------------
+The cache may be NULL, in which case everything is computed directly.
+If a maximal p-value pmax >= 0 is given (e.g. the significance level of
+a rule filter), the tail sums of Fisher's exact test are aborted as
+soon as they exceed it, because then the test fails regardless of the
+rest of the sum. In this case the returned (partial) sum is still
+greater than pmax, but it is not the exact p-value. Hence a negative
+pmax must be passed if the values themselves are needed. Since all
+state is passed explicitly, the functions are reentrant as long as
+each thread uses its own cache.
+----------------------------------------------------------------------*/
@@ -35,11 +35,29 @@
 #define RE_FETSUPP    20        /* Fisher's exact test (supp.) */
 #define RE_FNCNT      21        /* number of evaluation functions */
 
+#define RE_SLOTS    1024        /* number of cached distributions */
+
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
 typedef double RULEVALFN (int supp, int body, int head, int base);
 
+typedef struct {                /* --- hypergeom. distribution --- */
+  int    body, head, rest;      /* normalized marginals (key) */
+  int    valid;                 /* whether arrays are initialized */
+  int    size;                  /* size of the probability arrays */
+  double com;                   /* common probability term */
+  double *logp;                 /* logarithms of table probabilities */
+  double *prob;                 /* table probabilities (exp(logp)) */
+} REDIST;                       /* (hypergeometric distribution) */
+
+typedef struct {                /* --- Fisher test cache --- */
+  double *lfacts;               /* table of logarithms of factorials */
+  int    lfsize;                /* size of the log-factorial table */
+  int    mem;                   /* number of cached values */
+  REDIST dists[RE_SLOTS];       /* cache of hypergeom. distributions */
+} RECACHE;                      /* (Fisher test cache) */
+
 /*----------------------------------------------------------------------
   Rule Evaluation Functions
 ----------------------------------------------------------------------*/
@@ -68,4 +86,13 @@ extern double     re_fetsupp   (int supp, int body, int head, int base);
 extern RULEVALFN* re_function  (int id);
 extern int        re_dir       (int id);
 
+extern RECACHE*   re_create    (void);
+extern void       re_delete    (RECACHE *cache);
+extern double     re_eval      (int id, int supp, int body, int head,
+                                int base, RECACHE *cache, double pmax);
+extern void       re_batch     (int id, const int *supp,
+                                const int *body, const int *head,
+                                int base, double *vals, int n,
+                                RECACHE *cache, double pmax);
+
 #endif
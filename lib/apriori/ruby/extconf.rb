@@ -0,0 +1,16 @@
+require "mkmf"
+
+# build the apriori library (position independent, since it is linked
+# into a shared object, hence all objects are rebuilt with -B) and link
+# the extension against it
+base = File.expand_path("..", __dir__)
+src  = File.join(base, "apriori", "src")
+abort "cannot build libapriori.a" unless
+	system("make", "-C", src, "-B", "libapriori.a", "ADDFLAGS=-fPIC")
+
+%w(util math tract apriori).each do |dir|
+	$INCFLAGS << " -I" + File.join(base, dir, "src")
+end
+$LOCAL_LIBS << " " + File.join(src, "libapriori.a") + " -lm"
+
+create_makefile("apriori_ext")
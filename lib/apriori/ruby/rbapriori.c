@@ -0,0 +1,100 @@
+/*----------------------------------------------------------------------
+  File    : rbapriori.c
+  Contents: Ruby extension for finding association rules with apriori
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#include <limits.h>
+#include "apriori.h"            /* (must precede ruby.h, since */
+#include <ruby.h>               /* ruby/st.h redefines st_*()) */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- rule sink data --- */
+  VALUE  res;                   /* result array (if no block given) */
+  double wgt;                   /* total weight of transactions */
+  int    state;                 /* state of a raised exception */
+} RBSINK;                       /* (rule sink data) */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+static VALUE yield (VALUE rule)
+{ return rb_yield(rule); }      /* --- yield a rule to the block */
+
+/*--------------------------------------------------------------------*/
+
+static void sink (ISREPORT *rep, void *data)
+{                               /* --- receive a rule from apr_mem() */
+  int        i, n;              /* loop variable, number of items */
+  const int  *items;            /* items of the rule (head first) */
+  VALUE      rule, body;        /* the rule and its body */
+  RBSINK     *s = (RBSINK*)data;/* rule sink data */
+
+  items = isr_ritems(rep);      /* get the items of the rule */
+  if (!items || s->state) return;  /* (ignore sets and aborts) */
+  n    = isr_cnt(rep);          /* get the number of items */
+  body = rb_ary_new2(n-1);      /* collect the body item names */
+  for (i = 1; i < n; i++)
+    rb_ary_push(body, rb_str_new2(isr_itemname(rep, items[i])));
+  rule = rb_ary_new3(5, rb_str_new2(isr_itemname(rep, items[0])),
+                     body, rb_float_new(100 *isr_rsupp(rep) /s->wgt),
+                     rb_float_new(100 *isr_rconf(rep)),
+                     rb_float_new(isr_eval(rep)));
+  if (NIL_P(s->res)) rb_protect(yield, rule, &s->state);
+  else               rb_ary_push(s->res, rule);
+}  /* sink() */
+
+/*--------------------------------------------------------------------*/
+
+static VALUE rules (int argc, VALUE *argv, VALUE self)
+{                               /* --- Apriori.rules(tracts, ...) */
+  long       i, k, n;           /* loop variables, item counter */
+  int        r, m;              /* result of apr_mem(), min. size */
+  double     smin, cmin;        /* minimum support and confidence */
+  VALUE      tracts, supp, conf, min, t;
+  const char **items;           /* item names (trans. end with NULL) */
+  RBSINK     s;                 /* rule sink data */
+
+  rb_scan_args(argc, argv, "13", &tracts, &supp, &conf, &min);
+  smin = NIL_P(supp) ? 10 : NUM2DBL(supp);
+  cmin = NIL_P(conf) ? 80 : NUM2DBL(conf);
+  m    = NIL_P(min)  ?  2 : NUM2INT(min);
+  Check_Type(tracts, T_ARRAY);  /* check the transaction list */
+  for (n = i = 0; i < RARRAY_LEN(tracts); i++) {
+    t = rb_ary_entry(tracts, i);
+    Check_Type(t, T_ARRAY);     /* count the item occurrences */
+    n += RARRAY_LEN(t) +1;      /* (plus one terminator per trans.) */
+    for (k = 0; k < RARRAY_LEN(t); k++)
+      Check_Type(rb_ary_entry(t, k), T_STRING);
+  }                             /* (item names must be strings) */
+  items = ALLOC_N(const char*, n);
+  for (n = i = 0; i < RARRAY_LEN(tracts); i++) {
+    t = rb_ary_entry(tracts, i);/* traverse the transactions */
+    for (k = 0; k < RARRAY_LEN(t); k++)
+      items[n++] = StringValueCStr(RARRAY_PTR(t)[k]);
+    items[n++] = NULL;          /* copy the item names and */
+  }                             /* terminate each transaction */
+  s.res   = rb_block_given_p() ? Qnil : rb_ary_new();
+  s.wgt   = (double)RARRAY_LEN(tracts);
+  s.state = 0;                  /* initialize the rule sink */
+  r = apr_mem(items, (int)RARRAY_LEN(tracts), ISR_RULE, smin, cmin,
+              RE_NONE, 10, m, INT_MAX, sink, &s);
+  xfree(items);                 /* execute the apriori algorithm */
+  if (s.state) rb_jump_tag(s.state);  /* reraise a block exception */
+  if (r == E_NOMEM)             /* if apr_mem() failed, raise */
+    rb_raise(rb_eNoMemError, "%s", apr_errmsg(r));
+  if (r < 0)                    /* an exception with the message */
+    rb_raise(rb_eRuntimeError, "%s", apr_errmsg(r));
+  return NIL_P(s.res) ? self : s.res;
+}  /* rules() */               /* return the rules or the module */
+
+/*--------------------------------------------------------------------*/
+
+void Init_apriori_ext (void)
+{                               /* --- initialize the extension */
+  VALUE mod = rb_define_module("Apriori");
+  rb_define_module_function(mod, "rules", rules, -1);
+}  /* Init_apriori_ext() */
@@ -0,0 +1,443 @@
+/*----------------------------------------------------------------------
+  File    : repbin.c
+  Contents: reader for binary item set/association rule files
+            (as written by an item set reporter in mode ISR_BINARY)
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <assert.h>
+#include "repbin.h"
+#ifndef NOMAIN
+#include "error.h"
+#endif
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define PRGNAME     "repbin"
+#define DESCRIPTION "convert binary item set/rule/tid files to text"
+#define VERSION     "version 1.0 (2026.10.18)         " \
+                    "(c) 2026        agent"
+
+/* --- error codes --- */
+#define E_NONE        0         /* no error */
+#define E_NOMEM     (-1)        /* not enough memory */
+#define E_FOPEN     (-2)        /* cannot open file */
+#define E_FREAD     (-3)        /* read error on file */
+#define E_FWRITE    (-4)        /* write error on file */
+#define E_STDIN     (-5)        /* double assignment of stdin */
+#define E_OPTION    (-6)        /* unknown option */
+#define E_OPTARG    (-7)        /* missing option argument */
+#define E_ARGCNT    (-8)        /* too few/many arguments */
+#define E_FORMAT    (-9)        /* invalid file format */
+
+#define MAGIC       "ISRB"      /* magic number (see report.h) */
+#define FMTVERS     1           /* version of the binary format */
+#define TIDMAGIC    "ISRT"      /* magic number of tid files */
+#define TIDVERS     1           /* version of the tid file format */
+#define BLKSIZE     32          /* block size for the item buffer */
+
+#ifndef QUIET                   /* if not quiet version, */
+#define MSG         fprintf     /* print messages */
+#else                           /* if quiet version, */
+#define MSG(...)                /* suppress messages */
+#endif
+
+#define SEC_SINCE(t)  ((clock()-(t)) /(double)CLOCKS_PER_SEC)
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+#if !defined QUIET && !defined NOMAIN
+/* --- error messages --- */
+static const char *errmsgs[] = {
+  /* E_NONE      0 */  "no error",
+  /* E_NOMEM    -1 */  "not enough memory",
+  /* E_FOPEN    -2 */  "cannot open file %s",
+  /* E_FREAD    -3 */  "read error on file %s",
+  /* E_FWRITE   -4 */  "write error on file %s",
+  /* E_STDIN    -5 */  "double assignment of standard input",
+  /* E_OPTION   -6 */  "unknown option -%c",
+  /* E_OPTARG   -7 */  "missing option argument",
+  /* E_ARGCNT   -8 */  "wrong number of arguments",
+  /* E_FORMAT   -9 */  "invalid binary item set/tid file %s",
+  /*           -10 */  "unknown error"
+};
+#endif
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+#ifndef NOMAIN
+#ifndef QUIET
+static const char *prgname;     /* program name for error messages */
+#endif
+static RBREAD *rbread = NULL;   /* binary item set file reader */
+static FILE   *in     = NULL;   /* binary trans. id file */
+static FILE   *out    = NULL;   /* output file */
+#endif
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static int getv (FILE *file, unsigned int *v)
+{                               /* --- read a variable length int. */
+  int c, s;                     /* next byte, shift for the byte */
+
+  assert(file && v);            /* check the function arguments */
+  for (*v = 0, s = 0; s < 35; s += 7) {
+    c = getc(file);             /* read the next byte */
+    if (c == EOF) return -1;    /* check for end of file */
+    *v |= (unsigned int)(c & 0x7f) << s;
+    if (!(c & 0x80)) return 0;  /* add the lowest 7 bits and */
+  }                             /* check for a continuation flag */
+  return -1;                    /* too many bytes: invalid number */
+}  /* getv() */
+
+/*--------------------------------------------------------------------*/
+
+static int getx (FILE *file, void *p, int n)
+{                               /* --- read a fixed width number */
+  int           i = 1;          /* loop variable, endianess test */
+  unsigned char b[8];           /* buffer for the bytes */
+
+  assert(file && p && (n <= 8));/* check the function arguments */
+  if (fread(b, 1, (size_t)n, file) != (size_t)n)
+    return -1;                  /* read the bytes (little endian) */
+  if (*(char*)&i)               /* little endian: in memory order */
+    memcpy(p, b, (size_t)n);
+  else                          /* big endian: in reverse order */
+    for (i = n; --i >= 0; ) ((unsigned char*)p)[n-1-i] = b[i];
+  return 0;                     /* return 'ok' */
+}  /* getx() */
+
+/*--------------------------------------------------------------------*/
+
+static int getsupp (RBREAD *rbr, double *supp)
+{                               /* --- read a support value */
+  int i;                        /* integer support */
+
+  assert(rbr && supp);          /* check the function arguments */
+  if (rbr->swd == 8) return getx(rbr->file, supp, 8);
+  if (getx(rbr->file, &i, 4) != 0) return -1;
+  *supp = (double)i;            /* read a real-valued or */
+  return 0;                     /* an integer support value */
+}  /* getsupp() */
+
+/*----------------------------------------------------------------------
+  Reader Functions
+----------------------------------------------------------------------*/
+
+RBREAD* rbr_open (FILE *file, const char *name)
+{                               /* --- open a binary item set file */
+  int          i, n;            /* loop variable, number of items */
+  unsigned int k;               /* buffer for a varint */
+  char         hdr[6];          /* file header */
+  RBREAD       *rbr;            /* created binary file reader */
+
+  rbr = (RBREAD*)malloc(sizeof(RBREAD));
+  if (!rbr) return NULL;        /* create the base structure */
+  rbr->own = 0;                 /* default: file owned by caller */
+  if (file)                     /* if a file is given, */
+    rbr->name = name;           /* store the file name */
+  else if (!name || !*name) {   /* if no name or an empty name */
+    file = stdin; rbr->name = "<stdin>"; }
+  else {                        /* if a proper name is given */
+    file = fopen(rbr->name = name, "rb");
+    if (!file) { free(rbr); return NULL; }
+    rbr->own = 1;               /* open the file with given name */
+  }                             /* (and close it in rbr_close()) */
+  rbr->file  = file;            /* store the input file */
+  rbr->cnt   = 0;               /* clear the item dictionary */
+  rbr->names = NULL;            /* and the current record */
+  rbr->rule  = rbr->size = rbr->heval = 0;
+  rbr->supp  = rbr->body = rbr->head  = rbr->eval = 0;
+  rbr->max   = BLKSIZE;         /* create an item buffer */
+  rbr->items = (int*)malloc((size_t)rbr->max *sizeof(int));
+  if (!rbr->items
+  ||  (fread(hdr, 1, 6, file) != 6)
+  ||  (memcmp(hdr, MAGIC, 4) != 0)
+  ||  (hdr[4] != FMTVERS)       /* read and check the header */
+  ||  ((hdr[5] != 4) && (hdr[5] != 8))) {
+    rbr_close(rbr); return NULL; }
+  rbr->swd = hdr[5];            /* note the width of support values */
+  if ((getsupp(rbr, &rbr->wgt) != 0)
+  ||  (getv(file, &k) != 0) || (k > (unsigned int)INT_MAX)) {
+    rbr_close(rbr); return NULL; }
+  n = (int)k;                   /* get the number of items */
+  rbr->names = (char**)calloc((size_t)n+1, sizeof(char*));
+  if (!rbr->names) { rbr_close(rbr); return NULL; }
+  for (i = 0; i < n; i++) {     /* traverse the item dictionary */
+    rbr->cnt = i;               /* note the number of read names */
+    if (getv(file, &k) != 0) { rbr_close(rbr); return NULL; }
+    rbr->names[i] = (char*)malloc((size_t)k+1);
+    if (!rbr->names[i]
+    ||  (fread(rbr->names[i], 1, (size_t)k, file) != (size_t)k)) {
+      rbr_close(rbr); return NULL; }
+    rbr->names[i][k] = 0;       /* read the item name and */
+  }                             /* terminate it with a null byte */
+  rbr->cnt = i;                 /* note the number of items */
+  return rbr;                   /* return the created reader */
+}  /* rbr_open() */
+
+/*--------------------------------------------------------------------*/
+
+int rbr_close (RBREAD *rbr)
+{                               /* --- close a binary item set file */
+  int i;                        /* loop variable, result of fclose() */
+
+  assert(rbr);                  /* check the function argument */
+  if (rbr->names) {             /* if there is an item dictionary */
+    for (i = 0; rbr->names[i]; i++) free(rbr->names[i]);
+    free(rbr->names);           /* delete the item names */
+  }                             /* and the name array */
+  if (rbr->items) free(rbr->items);
+  i = (rbr->own) ? fclose(rbr->file) : 0;
+  free(rbr);                    /* close the input file (if opened */
+  return i;                     /* by rbr_open()) and delete the */
+}  /* rbr_close() */            /* base structure */
+
+/*--------------------------------------------------------------------*/
+
+int rbr_next (RBREAD *rbr)
+{                               /* --- read the next set/rule */
+  int          i, n, e;         /* loop variable, number of items */
+  unsigned int k;               /* buffer for a varint */
+  int          *p;              /* buffer for reallocation */
+
+  assert(rbr);                  /* check the function argument */
+  if (getv(rbr->file, &k) != 0) /* read the number of items */
+    return (feof(rbr->file)) ? 1 : -1;
+  rbr->rule = (int)(k >> 1) & 1;/* get the record type */
+  e = (int)k & 1;               /* and the evaluation flag */
+  rbr->heval = e;               /* (whether an evaluation follows) */
+  n = (int)(k >> 2);            /* and the number of items */
+  if (n > rbr->max) {           /* if the item buffer is too small */
+    k = (unsigned int)(n +BLKSIZE);
+    p = (int*)realloc(rbr->items, (size_t)k *sizeof(int));
+    if (!p) return -1;          /* enlarge the item buffer */
+    rbr->items = p; rbr->max = (int)k;
+  }                             /* set the new buffer and its size */
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    if (getv(rbr->file, &k) != 0) return -1;
+    if      (i <= 0) rbr->items[i] = (int)k;
+    else if (k &  1) rbr->items[i] = rbr->items[i-1] -(int)(k >> 1) -1;
+    else             rbr->items[i] = rbr->items[i-1] +(int)(k >> 1);
+    if ((rbr->items[i] < 0) || (rbr->items[i] >= rbr->cnt))
+      return -1;                /* decode the zigzag encoded */
+  }                             /* differences of the items */
+  rbr->size = n;                /* note the number of items */
+  rbr->body = rbr->head = rbr->eval = 0;
+  if ((getsupp(rbr, &rbr->supp) != 0)
+  ||  (rbr->rule && ((getsupp(rbr, &rbr->body) != 0)
+  ||                 (getsupp(rbr, &rbr->head) != 0)))
+  ||  (e && (getx(rbr->file, &rbr->eval, 8) != 0)))
+    return -1;                  /* read support values and */
+  return 0;                     /* the evaluation (if any) */
+}  /* rbr_next() */
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+#ifndef NOMAIN
+
+#ifndef NDEBUG                  /* if debug version */
+  #undef  CLEANUP               /* clean up memory and close files */
+  #define CLEANUP \
+  if (rbread) rbr_close(rbread); \
+  if (in  && (in  != stdin))  fclose(in); \
+  if (out && (out != stdout)) fclose(out);
+#endif
+
+GENERROR(error, exit)           /* generic error reporting function */
+
+/*--------------------------------------------------------------------*/
+
+static long tidconv (FILE *in, FILE *out, const char *sep)
+{                               /* --- convert a binary tid file */
+  long         n;               /* number of converted lists */
+  int          i, b, m;         /* loop variables, bitmap byte */
+  unsigned int k, c, t, x;      /* list header, number of ids, id */
+  char         hdr[4];          /* buffer for the magic number */
+
+  assert(in && out);            /* check the function arguments */
+  if ((fread(hdr, 1, 4, in) != 4) || (memcmp(hdr, TIDMAGIC, 4) != 0)
+  ||  (getv(in, &k) != 0) || (k != TIDVERS))
+    return -1;                  /* check magic number and version */
+  for (n = 0; getv(in, &k) == 0; n++) {
+    c = k >> 2;                 /* traverse the lists */
+    if (c > 0) {                /* get the number of ids */
+      if (getv(in, &t) != 0) return -1; }
+    if ((k & 1) && (c > 0)) {   /* if the list is a bitmap */
+      if (getv(in, &x) != 0) return -1;
+      for (m = 0; x > 0; x--) { /* traverse the bitmap bytes */
+        if ((b = getc(in)) == EOF) return -1;
+        for (i = 0; i < 8; i++) {
+          if (!(b & (1 << i))) continue;
+          if (m++ > 0) fputs(sep, out);
+          fprintf(out, "%u", t +(unsigned int)i +1);
+        }                       /* print the ids of the set bits */
+        t += 8;                 /* (ids in the file start at 0, */
+      } }                       /* ids in text files start at 1) */
+    else {                      /* if the list is delta coded */
+      for ( ; c > 0; c--) {     /* traverse the transaction ids */
+        fprintf(out, "%u", t+1);/* print the transaction id */
+        if ((k & 2) && ((getv(in, &x) != 0)
+        ||  (fprintf(out, ":%u", x) < 0)))
+          return -1;            /* print the item counter */
+        if (c <= 1) break;      /* if this is not the last id, */
+        if (getv(in, &x) != 0) return -1;
+        t += x +1;              /* get the next transaction id */
+        fputs(sep, out);        /* (decode the gap to the */
+      }                         /* preceding transaction id) */
+    }                           /* and print a separator */
+    fputc('\n', out);           /* terminate the list */
+  }
+  return (feof(in)) ? n : -1;   /* return the number of lists */
+}  /* tidconv() */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- main function */
+  int        i, k = 0, r;       /* loop variables, counters, result */
+  char       *s;                /* to traverse the options */
+  const char **optarg = NULL;   /* option argument */
+  const char *fn_inp  = NULL;   /* name of input  file */
+  const char *fn_out  = NULL;   /* name of output file */
+  const char *sep     = " ";    /* item separator for output */
+  const char *imp     = " <- "; /* implication sign for rules */
+  int        eval     = 0;      /* flag for evaluation output */
+  int        dict     = 0;      /* flag for dictionary output */
+  int        tids     = 0;      /* flag for trans. id file input */
+  long       n;                 /* number of converted sets/rules */
+  clock_t    t;                 /* timer for measurements */
+
+  #ifndef QUIET                 /* if not quiet version */
+  prgname = argv[0];            /* get program name for error msgs. */
+
+  /* --- print usage message --- */
+  if (argc > 1) {               /* if arguments are given */
+    fprintf(stderr, "%s - %s\n", argv[0], DESCRIPTION);
+    fprintf(stderr, VERSION); } /* print a startup message */
+  else {                        /* if no arguments given */
+    printf("usage: %s [options] infile [outfile]\n", argv[0]);
+    printf("%s\n", DESCRIPTION);
+    printf("%s\n", VERSION);
+    printf("-k#      item separator for output                "
+                    "(default: \"%s\")\n", sep);
+    printf("-I#      implication sign for association rules   "
+                    "(default: \"%s\")\n", imp);
+    printf("-e       print the additional evaluation value\n");
+    printf("-d       print the item dictionary first\n");
+    printf("-t       convert a binary transaction id file "
+                    "(ISR_TIDBIN)\n");
+    printf("infile   binary file to read item sets/rules from "
+                    "[required]\n");
+    printf("outfile  file to write item sets/rules to (text) "
+                    "[optional]\n");
+    return 0;                   /* print a usage message */
+  }                             /* and abort the program */
+  #endif  /* #ifndef QUIET */
+
+  /* --- evaluate arguments --- */
+  for (i = 1; i < argc; i++) {  /* traverse arguments */
+    s = argv[i];                /* get option argument */
+    if (optarg) { *optarg = s; optarg = NULL; continue; }
+    if ((*s == '-') && *++s) {  /* -- if argument is an option */
+      while (*s) {              /* traverse options */
+        switch (*s++) {         /* evaluate switches */
+          case 'k': optarg = &sep;                  break;
+          case 'I': optarg = &imp;                  break;
+          case 'e': eval   = 1;                     break;
+          case 'd': dict   = 1;                     break;
+          case 't': tids   = 1;                     break;
+          default : error(E_OPTION, *--s);          break;
+        }                       /* set option variables */
+        if (optarg && *s) { *optarg = s; optarg = NULL; break; }
+      } }                       /* get option argument */
+    else {                      /* -- if argument is no option */
+      switch (k++) {            /* evaluate non-options */
+        case  0: fn_inp = s;      break;
+        case  1: fn_out = s;      break;
+        default: error(E_ARGCNT); break;
+      }                         /* note filenames */
+    }
+  }
+  if (optarg) error(E_OPTARG);  /* check (option) arguments */
+  if (k < 1)  error(E_ARGCNT);  /* and number of arguments */
+  MSG(stderr, "\n");            /* terminate the startup message */
+
+  /* --- convert transaction id lists --- */
+  if (tids) {                   /* if to convert a tid file */
+    t = clock();                /* start timer, open input file */
+    if (!*fn_inp) { in = stdin; fn_inp = "<stdin>"; }
+    else if (!(in = fopen(fn_inp, "rb"))) error(E_FOPEN, fn_inp);
+    if (!fn_out || !*fn_out)    /* open the output file */
+      out = stdout;             /* (default: standard output) */
+    else if (!(out = fopen(fn_out, "w")))
+      error(E_FOPEN, fn_out);   /* check for an error */
+    MSG(stderr, "converting %s ... ", fn_inp);
+    n = tidconv(in, out, sep);  /* convert the transaction id lists */
+    if (n < 0) error(E_FORMAT, fn_inp);
+    if (ferror(out))            /* check for a write error */
+      error(E_FWRITE, (out == stdout) ? "<stdout>" : fn_out);
+    MSG(stderr, "[%ld list(s)] done [%.2fs].\n", n, SEC_SINCE(t));
+    CLEANUP; SHOWMEM;           /* clean up memory and close files */
+    return 0;                   /* return 'ok' */
+  }
+
+  /* --- convert item sets/rules --- */
+  t = clock();                  /* start timer, open input file */
+  rbread = rbr_open(NULL, fn_inp);
+  if (!rbread)                  /* open the binary input file */
+    error(E_FORMAT, (*fn_inp) ? fn_inp : "<stdin>");
+  if (!fn_out || !*fn_out)      /* open the output file */
+    out = stdout;               /* (default: standard output) */
+  else if (!(out = fopen(fn_out, "w")))
+    error(E_FOPEN, fn_out);     /* check for an error */
+  MSG(stderr, "converting %s ... ", rbr_fname(rbread));
+  if (dict) {                   /* if to print the item dictionary */
+    for (i = 0; i < rbr_itemcnt(rbread); i++)
+      fprintf(out, "%d: %s\n", i, rbr_name(rbread, i));
+    fprintf(out, "total: %.16g\n", rbr_total(rbread));
+  }                             /* print items and total weight */
+  for (n = 0; (r = rbr_next(rbread)) == 0; n++) {
+    k = rbr_size(rbread);       /* traverse the sets/rules */
+    for (i = 0; i < k; i++) {   /* traverse the items */
+      if ((i > 1) || ((i > 0) && !rbr_isrule(rbread)))
+        fputs(sep, out);        /* print an item separator */
+      fputs(rbr_name(rbread, rbr_items(rbread)[i]), out);
+      if ((i <= 0) && rbr_isrule(rbread))
+        fputs(imp, out);        /* print the implication sign */
+    }                           /* after the head (even if the */
+                                /* body of the rule is empty) */
+    fprintf(out, " (%.16g", rbr_supp(rbread));
+    if (rbr_isrule(rbread))     /* print the support (and the */
+      fprintf(out, ", %.16g, %.16g",
+              rbr_body(rbread), rbr_head(rbread));
+    if (eval && rbr_haseval(rbread))   /* body/head support */
+      fprintf(out, ", %.16g", rbr_eval(rbread));     /* for rules), */
+    fputs(")\n", out);          /* the evaluation (if there is one) */
+  }                             /* and terminate the line */
+  if (r < 0) error(E_FREAD, rbr_fname(rbread));
+  if (ferror(out))              /* check for a write error */
+    error(E_FWRITE, (out == stdout) ? "<stdout>" : fn_out);
+  MSG(stderr, "[%ld set(s)/rule(s)] done [%.2fs].\n", n, SEC_SINCE(t));
+
+  /* --- clean up --- */
+  CLEANUP;                      /* clean up memory and close files */
+  SHOWMEM;                      /* show (final) memory usage */
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
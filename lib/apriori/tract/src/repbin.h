@@ -0,0 +1,68 @@
+/*----------------------------------------------------------------------
+  File    : repbin.h
+  Contents: reader for binary item set/association rule files
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#ifndef __REPBIN__
+#define __REPBIN__
+#include <stdio.h>
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- binary item set file reader */
+  FILE       *file;             /* input file to read from */
+  int        own;               /* whether the file was opened here */
+  const char *name;             /* name of the input file */
+  int        swd;               /* width of support values (4 or 8) */
+  double     wgt;               /* total weight of transactions */
+  int        cnt;               /* number of items (dictionary size) */
+  char       **names;           /* item names (dictionary) */
+  int        rule;              /* whether current record is a rule */
+  int        size;              /* number of items in current record */
+  int        max;               /* size of the item buffer */
+  int        *items;            /* items of the current record */
+  double     supp;              /* support of the set/rule */
+  double     body;              /* support of the rule body */
+  double     head;              /* support of the rule head */
+  int        heval;             /* whether the record has an eval. */
+  double     eval;              /* additional evaluation */
+} RBREAD;                       /* (binary item set file reader) */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern RBREAD*     rbr_open    (FILE *file, const char *name);
+extern int         rbr_close   (RBREAD *rbr);
+extern int         rbr_next    (RBREAD *rbr);
+extern const char* rbr_fname   (RBREAD *rbr);
+extern double      rbr_total   (RBREAD *rbr);
+extern int         rbr_itemcnt (RBREAD *rbr);
+extern const char* rbr_name    (RBREAD *rbr, int item);
+extern int         rbr_isrule  (RBREAD *rbr);
+extern int         rbr_size    (RBREAD *rbr);
+extern const int*  rbr_items   (RBREAD *rbr);
+extern double      rbr_supp    (RBREAD *rbr);
+extern double      rbr_body    (RBREAD *rbr);
+extern double      rbr_head    (RBREAD *rbr);
+extern int         rbr_haseval (RBREAD *rbr);
+extern double      rbr_eval    (RBREAD *rbr);
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define rbr_fname(r)      ((r)->name)
+#define rbr_total(r)      ((r)->wgt)
+#define rbr_itemcnt(r)    ((r)->cnt)
+#define rbr_name(r,i)     ((const char*)(r)->names[i])
+#define rbr_isrule(r)     ((r)->rule)
+#define rbr_size(r)       ((r)->size)
+#define rbr_items(r)      ((const int*)(r)->items)
+#define rbr_supp(r)       ((r)->supp)
+#define rbr_body(r)       ((r)->body)
+#define rbr_head(r)       ((r)->head)
+#define rbr_haseval(r)    ((r)->heval)
+#define rbr_eval(r)       ((r)->eval)
+
+#endif
@@ -50,12 +50,19 @@
             2012.10.16 bug in function isr_rinfo() fixed ("L", lift)
             2012.10.26 bug in function fastout() fixed (empty set)
 ----------------------------------------------------------------------*/
+#if defined ISR_ASYNC && !defined _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* needed for clock_gettime() */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <float.h>
+#include <time.h>
 #include <assert.h>
 #include <math.h>
+#ifdef ISR_ASYNC
+#include <pthread.h>
+#endif
 #include "report.h"
 #include "scanner.h"
 #ifdef STORAGE
@@ -70,11 +77,71 @@
 /*----------------------------------------------------------------------
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
-#define BS_WRITE    65536       /* size of internal write buffer */
+#define BS_WRITE    65536       /* default size of write buffer */
+#define BS_MIN         64       /* minimum size of write buffer */
 #define BS_INT         32       /* buffer size for integer output */
 #define BS_FLOAT       80       /* buffer size for float   output */
 #define LN_2        0.69314718055994530942  /* ln(2) */
-#define MODEMASK    (ISR_TARGET|ISR_NOEXPAND|ISR_SORT)
+#define MODEMASK    (ISR_TARGET|ISR_NOEXPAND|ISR_SORT|ISR_BINARY \
+                    |ISR_TIDBIN)
+#define SUPP_ISDBL  ((SUPP_T)0.5 != 0)  /* whether support is real */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+#ifdef ISR_ASYNC
+typedef struct israsync {       /* --- asynchronous writer --- */
+  pthread_t       thread;       /* writer thread */
+  pthread_mutex_t lock;         /* lock for the shared variables */
+  pthread_cond_t  cond;         /* condition for state changes */
+  FILE            *file;        /* output file to write to */
+  char            *buf;         /* buffer that is to be written */
+  size_t          len;          /* number of characters to write */
+  int             busy;         /* whether buffer is being written */
+  int             quit;         /* whether writer is to terminate */
+} ISRASYNC;                     /* (asynchronous writer) */
+#endif
+
+typedef struct {                /* --- a collected rule --- */
+  double     val;               /* value of the selection measure */
+  long       id;                /* sequence number (to break ties) */
+  SUPP_T     supp;              /* support of the rule */
+  SUPP_T     body;              /* support of the rule body */
+  SUPP_T     head;              /* support of the rule head */
+  double     eval;              /* additional evaluation */
+  int        cnt;               /* number of items (head first) */
+  int        size;              /* size of the item buffer */
+  int        *items;            /* items of the rule */
+} TOPRULE;                      /* (collected rule) */
+
+typedef struct isrtopn {        /* --- top-N rule collector --- */
+  ISRULEFN   *fn;               /* measure for selecting the rules */
+  int        dir;               /* direction of the measure */
+  int        max;               /* maximum number of rules to keep */
+  int        cnt;               /* current number of rules */
+  int        out;               /* flag for writing collected rules */
+  long       seen;              /* number of offered rules */
+  long       drop;              /* number of rules below the cutoff */
+  TOPRULE    **heap;            /* heap of rules (worst rule at root) */
+  TOPRULE    rules[1];          /* storage for the collected rules */
+} ISRTOPN;                      /* (top-N rule collector) */
+
+typedef struct {                /* --- an output shard --- */
+  FILE       *file;             /* output file of the shard */
+  char       *name;             /* name of the shard file */
+  char       *buf;              /* write buffer of the shard */
+  char       *next;             /* next character position to write */
+  long       cnt;               /* number of written sets/rules */
+} ISRSHD;                       /* (output shard) */
+
+typedef struct isrshard {       /* --- sharded output --- */
+  int        cnt;               /* number of shards */
+  int        key;               /* shard key (e.g. ISR_SHHEAD) */
+  int        cur;               /* index of the current shard */
+  FILE       *mft;              /* manifest file (if open) */
+  char       *names;            /* buffer for the shard file names */
+  ISRSHD     shds[1];           /* shard files and write buffers */
+} ISRSHARD;                     /* (sharded output) */
 
 /*----------------------------------------------------------------------
   Constants
@@ -87,6 +154,13 @@ static const double pows[] = {  /* several powers of ten */
   1e+24, 1e+25, 1e+26, 1e+27, 1e+28, 1e+29, 1e+30, 1e+31,
   1e+32, 1e+33 };
 
+static const char dpairs[] =    /* pairs of decimal digits */
+  "00010203040506070809" "10111213141516171819"
+  "20212223242526272829" "30313233343536373839"
+  "40414243444546474849" "50515253545556575859"
+  "60616263646566676869" "70717273747576777879"
+  "80818283848586878889" "90919293949596979899";
+
 /*----------------------------------------------------------------------
   Basic Output Functions
 ----------------------------------------------------------------------*/
@@ -100,7 +174,8 @@ static void fastchk (ISREPORT *rep)
   else if (!rep->file)          /* if no output (and no filtering), */
     rep->fast = -1;             /* only count the item sets */
   else {                        /* if only an output file is written */
-    rep->fast = ((rep->min <= 1) && (rep->max >= INT_MAX)
+    rep->fast = (!(rep->mode & ISR_BINARY) && !rep->shard
+              &&  (rep->min <= 1) && (rep->max >= INT_MAX)
               && ((strcmp(rep->format, " (%a)") == 0)
               ||  (strcmp(rep->format, " (%d)") == 0))
               &&  (strcmp(rep->hdr,    "")      == 0)
@@ -125,12 +200,146 @@ static int getsd (const char *s, const char **end)
 
 /*--------------------------------------------------------------------*/
 
+static double wtime (void)
+{                               /* --- get the current wall time */
+  #ifdef ISR_ASYNC              /* if POSIX threads are used */
+  struct timespec t;            /* current time */
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec +1e-9 *(double)t.tv_nsec;
+  #else                         /* if only C99 is available, */
+  return clock() /(double)CLOCKS_PER_SEC;
+  #endif                        /* fall back to the processor time */
+}  /* wtime() */
+
+/*--------------------------------------------------------------------*/
+#ifdef ISR_ASYNC
+
+static void* writer (void *data)
+{                               /* --- asynchronous writer thread */
+  ISRASYNC *asy = (ISRASYNC*)data;  /* asynchronous writer data */
+
+  pthread_mutex_lock(&asy->lock);
+  while (1) {                   /* writer loop */
+    while (!asy->busy && !asy->quit)
+      pthread_cond_wait(&asy->cond, &asy->lock);
+    if (!asy->busy) break;      /* wait for a buffer to write */
+    pthread_mutex_unlock(&asy->lock);
+    fwrite(asy->buf, sizeof(char), asy->len, asy->file);
+    pthread_mutex_lock(&asy->lock);
+    asy->busy = 0;              /* write the buffer and */
+    pthread_cond_signal(&asy->cond);
+  }                             /* signal that the buffer is free */
+  pthread_mutex_unlock(&asy->lock);
+  return NULL;                  /* terminate the writer thread */
+}  /* writer() */
+
+/*--------------------------------------------------------------------*/
+
+static ISRASYNC* asynew (size_t size)
+{                               /* --- create an asynchronous writer */
+  ISRASYNC *asy;                /* created asynchronous writer */
+
+  asy = (ISRASYNC*)malloc(sizeof(ISRASYNC));
+  if (!asy) return NULL;        /* create the base structure */
+  asy->buf = (char*)malloc(size *sizeof(char));
+  if (!asy->buf) { free(asy); return NULL; }
+  pthread_mutex_init(&asy->lock, NULL);
+  pthread_cond_init (&asy->cond, NULL);
+  asy->file = NULL;             /* create a second write buffer */
+  return asy;                   /* and init. the synchronization */
+}  /* asynew() */
+
+/*--------------------------------------------------------------------*/
+
+static void asydel (ISRASYNC *asy)
+{                               /* --- delete an asynchronous writer */
+  pthread_mutex_destroy(&asy->lock);
+  pthread_cond_destroy (&asy->cond);
+  free(asy->buf);               /* destroy the synchronization, */
+  free(asy);                    /* delete the second write buffer */
+}  /* asydel() */               /* and the base structure */
+
+/*--------------------------------------------------------------------*/
+
+static int asystart (ISRASYNC *asy, FILE *file)
+{                               /* --- start a writer thread */
+  asy->file = file;             /* note the output file */
+  asy->busy = asy->quit = 0;    /* and clear the state flags */
+  return (pthread_create(&asy->thread, NULL, writer, asy) != 0)
+       ? -1 : 0;                /* start the writer thread */
+}  /* asystart() */
+
+/*--------------------------------------------------------------------*/
+
+static void asywait (ISREPORT *rep, ISRASYNC *asy)
+{                               /* --- wait for the writer thread */
+  double   t;                   /* start time of waiting */
+
+  if (!asy->busy) return;       /* check whether writer is busy */
+  rep->bpcnt++; t = wtime();    /* count the back-pressure event */
+  while (asy->busy)             /* and wait until the writer */
+    pthread_cond_wait(&asy->cond, &asy->lock);
+  rep->iowait += wtime() -t;    /* has finished writing; */
+}  /* asywait() */              /* sum the time spent waiting */
+
+/*--------------------------------------------------------------------*/
+
+static void asystop (ISREPORT *rep, ISRASYNC *asy)
+{                               /* --- stop a writer thread */
+  pthread_mutex_lock(&asy->lock);
+  asywait(rep, asy);            /* wait for the last buffer */
+  asy->quit = 1;                /* and tell the writer to terminate */
+  pthread_cond_signal(&asy->cond);
+  pthread_mutex_unlock(&asy->lock);
+  pthread_join(asy->thread, NULL);
+  asy->file = NULL;             /* wait for the writer to terminate */
+}  /* asystop() */              /* and note that it is not running */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+static char* wrbuf (ISREPORT *rep, struct israsync *asy, FILE *file,
+                    char **buf, char *next)
+{                               /* --- write a filled buffer */
+  double t;                     /* start time of writing */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  char   *b;                    /* exchange buffer for swapping */
+  #endif
+
+  assert(rep && file && buf && (next > *buf));
+  rep->wrcnt++;                 /* count the written block */
+  rep->bytes += (double)(next -*buf);
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (asy) {                    /* if there is a writer thread */
+    pthread_mutex_lock(&asy->lock);
+    asywait(rep, asy);          /* wait until other buffer is free */
+    b = asy->buf; asy->buf = *buf; *buf = b;
+    asy->len  = (size_t)(next -asy->buf);
+    asy->busy = 1;              /* pass the full buffer to the writer */
+    pthread_cond_signal(&asy->cond);
+    pthread_mutex_unlock(&asy->lock);
+    return *buf;                /* continue with the other buffer */
+  }                             /* (writing is done by the thread) */
+  #endif
+  t = wtime();                  /* write the buffer synchronously */
+  fwrite(*buf, sizeof(char), (size_t)(next -*buf), file);
+  rep->iowait += wtime() -t;    /* sum the time spent writing */
+  return *buf;                  /* return the next write position */
+}  /* wrbuf() */
+
+/* The same function serves the item set output and the transaction */
+/* id output, which have separate buffers and writer threads, but   */
+/* share the output statistics (block and byte counters, waiting).  */
+
+/*--------------------------------------------------------------------*/
+
 static void isr_flush (ISREPORT *rep)
 {                               /* --- flush the output buffer */
   assert(rep);                  /* check the function arguments */
-  fwrite(rep->buf, sizeof(char), rep->next -rep->buf, rep->file);
-  rep->next = rep->buf;         /* write the output buffer */
-}  /* isr_flush() */
+  if (rep->next <= rep->buf) return;
+  rep->next = wrbuf(rep, rep->async, rep->file, &rep->buf, rep->next);
+  rep->end  = rep->buf +rep->bsize;
+}  /* isr_flush() */            /* write the buffer and reinit. */
 
 /*--------------------------------------------------------------------*/
 
@@ -175,25 +384,36 @@ static void isr_putsn (ISREPORT *rep, const char *s, int n)
 
 /*--------------------------------------------------------------------*/
 
+static char* utoa (char *end, unsigned int num)
+{                               /* --- format an unsigned integer */
+  while (num >= 100) {          /* while there are 3 or more digits */
+    end -= 2; memcpy(end, dpairs +2*(num % 100), 2);
+    num /= 100;                 /* store the two lowest digits */
+  }                             /* and remove them from the number */
+  if (num < 10) *--end = (char)(num +'0');
+  else { end -= 2; memcpy(end, dpairs +2*num, 2); }
+  return end;                   /* store the remaining digit(s) and */
+}  /* utoa() */                 /* return the start of the digits */
+
+/* Producing two digits per division roughly halves the number of */
+/* (slow) integer divisions compared to a digit by digit loop.    */
+
+/*--------------------------------------------------------------------*/
+
 int isr_intout (ISREPORT *rep, int num)
 {                               /* --- print an integer number */
-  int  i = BS_INT, n;           /* loop variable, character counter */
-  char buf[BS_INT];             /* output buffer */
+  int          n = 0;           /* character counter */
+  unsigned int u;               /* absolute value of the number */
+  char         *s;              /* start of the formatted number */
+  char         buf[BS_INT];     /* output buffer */
 
   assert(rep);                  /* check the function arguments */
-  if (num == 0) {               /* treat zero as a special case */
-    isr_putc(rep, '0'); return 1; }
-  if (num <= INT_MIN) {         /* treat INT_MIN as a special case */
-    isr_puts(rep, "-2147483648"); return 11; }
-  n = 0;                        /* default: no sign printed */
+  u = (unsigned int)num;        /* get the number as unsigned */
   if (num < 0) {                /* if the number is negative, */
-    num = -num; isr_putc(rep, '-'); n = 1; }  /* print a sign */
-  do {                          /* digit output loop */
-    buf[--i] = (num % 10) +'0'; /* store the next digit and */
-    num /= 10;                  /* remove it from the number */
-  } while (num > 0);            /* while there are more digits */
-  isr_putsn(rep, buf+i, BS_INT-i);
-  n += BS_INT-i;                /* print the generated digits and */
+    u = -u; isr_putc(rep, '-'); n = 1; }  /* print a sign */
+  s = utoa(buf+BS_INT, u);      /* format the absolute value */
+  isr_putsn(rep, s, (int)(buf+BS_INT-s));
+  n += (int)(buf+BS_INT-s);     /* print the generated digits and */
   return n;                     /* return the number of characters */
 }  /* isr_intout() */
 
@@ -201,7 +421,7 @@ int isr_intout (ISREPORT *rep, int num)
 
 int mantout (ISREPORT *rep, double num, int digits, int ints)
 {                               /* --- format a non-negative mantissa */
-  int    i, n;                  /* loop variables, sign flag */
+  int    i, k, n;               /* loop variables, digit */
   double x, y;                  /* integral and fractional part */
   char   *s, *e, *d;            /* pointers into the output buffer */
   char   buf[BS_FLOAT];         /* output buffer */
@@ -214,9 +434,9 @@ int mantout (ISREPORT *rep, double num, int digits, int ints)
   if (n > 0) {                  /* if to print decimal digits, */
     *e++ = '.';                 /* store a decimal point */
     do { y *= 10;               /* compute the next decimal */
-      *e++ = (int)y +'0';       /* and store it in the buffer */
-      y   -= floor(y);          /* remove the printed decimal */
-    } while (--n > 0);          /* while there are more decimals */
+      *e++ = (char)((k = (int)y) +'0');
+      y   -= k;                 /* store it in the buffer and */
+    } while (--n > 0);          /* remove it from the fraction */
   }                             /* remove a decimal if necessary */
   if ((y > 0.5) || ((y == 0.5)  /* if number needs to be rounded */
   &&  ((e > d) ? *(e-1) & 1 : floor(x/2) >= x/2))) {
@@ -231,11 +451,15 @@ int mantout (ISREPORT *rep, double num, int digits, int ints)
     while (*--e == '0');        /* remove all trailing zeros */
     if (e > d) e++;             /* if there are no decimals left, */
   }                             /* also remove the decimal point */
-  s = d;                        /* adapt the decimals if necessary */
-  do {                          /* integral part output loop */
-    *--s = (char)fmod(x, 10) +'0';
-    x = floor(x/10);            /* compute and store next digit */
-  } while (x > 0);              /* while there are more digits */
+  if (x < 4294967296.0)         /* if the integral part is small, */
+    s = utoa(d, (unsigned int)x);     /* format it as an integer */
+  else {                        /* if the integral part is large */
+    s = d;                      /* adapt the decimals if necessary */
+    do {                        /* integral part output loop */
+      *--s = (char)fmod(x, 10) +'0';
+      x = floor(x/10);          /* compute and store next digit */
+    } while (x > 0);            /* while there are more digits */
+  }
   if ((n = d-s) > ints)         /* check size of integral part */
     return -n;                  /* and abort if it is too large */
   isr_putsn(rep, s, n = e-s);   /* print the formatted number */
@@ -327,20 +551,278 @@ int isr_wgtout (ISREPORT *rep, SUPP_T supp, double wgt)
 
 /*--------------------------------------------------------------------*/
 
+static void tidflush (ISREPORT *rep)
+{                               /* --- flush the tid output buffer */
+  assert(rep);                  /* check the function arguments */
+  if (rep->tidnxt <= rep->tidbuf) return;
+  rep->tidnxt = wrbuf(rep, rep->tidasy, rep->tidfile,
+                      &rep->tidbuf, rep->tidnxt);
+  rep->tidend = rep->tidbuf +rep->bsize;
+}  /* tidflush() */             /* write the buffer and reinit. */
+
+/*--------------------------------------------------------------------*/
+
+static void tidputsn (ISREPORT *rep, const char *s, int n)
+{                               /* --- write a string to tid output */
+  int k;                        /* number of chars in buffer */
+
+  assert(rep);                  /* check the function arguments */
+  while (n > 0) {               /* while there are characters left */
+    k = rep->tidend -rep->tidnxt;  /* get free space in buffer */
+    if (k >= n) {               /* if the string fits into buffer, */
+      memcpy(rep->tidnxt, s, n *sizeof(char));
+      rep->tidnxt += n; break;  /* simply copy the string into */
+    }                           /* the write buffer and abort */
+    memcpy(rep->tidnxt, s, k *sizeof(char));
+    s += k; n -= k; rep->tidnxt = rep->tidend;
+    tidflush(rep);              /* fill the buffer, then flush it, */
+  }                             /* and reduce the remaining string */
+}  /* tidputsn() */
+
+/*--------------------------------------------------------------------*/
+
 int isr_tidout (ISREPORT *rep, int tid)
 {                               /* --- print a positive integer */
-  int  i = BS_INT;              /* loop variable */
-  char buf[BS_INT];             /* output buffer */
+  int  n;                       /* number of digits */
+  char buf[BS_INT], *s;         /* buffer for the formatted number */
 
   assert(rep && (tid >= 0));    /* check the function arguments */
-  do {                          /* digit output loop */
-    buf[--i] = (tid % 10) +'0'; /* store the next digit and */
-    tid /= 10;                  /* remove it from the number */
-  } while (tid > 0);            /* while there are more digits */
-  fwrite(buf +i, sizeof(char), BS_INT -i, rep->tidfile);
-  return BS_INT -i;             /* print the digits and */
+  s = utoa(buf +BS_INT, (unsigned int)tid);
+  n = (int)(buf +BS_INT -s);    /* format the transaction id */
+  if (rep->tidnxt +n > rep->tidend)
+    tidflush(rep);              /* ensure space for the digits */
+  memcpy(rep->tidnxt, s, (size_t)n);
+  rep->tidnxt += n;             /* copy the digits to the buffer */
+  return n;                     /* and return their number */
 }  /* isr_tidout() */
 
+/*----------------------------------------------------------------------
+  Binary Output Functions
+----------------------------------------------------------------------*/
+/* Binary files start with the magic number "ISRB", a version byte,   */
+/* the width of support values (4: int, 8: double), the total weight */
+/* and the item dictionary (number of items, then length and name  */
+/* of each item). Each set/rule record starts with a varint holding */
+/* (number of items << 2) | (rule << 1) | has eval., followed by    */
+/* the first item as a varint and the differences of the following  */
+/* items as zigzag encoded varints (head first for rules). Then the */
+/* support (for rules also body and head support) and, if flagged,  */
+/* the evaluation (as a double) follow. Fixed width fields are all  */
+/* stored in little endian byte order.                              */
+
+static char* putv (char *p, unsigned int v)
+{                               /* --- store a variable length int. */
+  while (v >= 0x80) {           /* while more than 7 bits are left, */
+    *p++ = (char)((v & 0x7f) | 0x80);
+    v >>= 7;                    /* store the lowest 7 bits */
+  }                             /* with a continuation flag */
+  *p++ = (char)v;               /* store the highest bits */
+  return p;                     /* return the next write position */
+}  /* putv() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_putv (ISREPORT *rep, unsigned int v)
+{                               /* --- write a variable length int. */
+  assert(rep);                  /* check the function arguments */
+  if (rep->next +5 > rep->end)  /* if the output buffer is full, */
+    isr_flush(rep);             /* flush it (write it to the file) */
+  rep->next = putv(rep->next, v);
+}  /* isr_putv() */             /* store the number in the buffer */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_putx (ISREPORT *rep, const void *p, int n)
+{                               /* --- write a fixed width number */
+  int i = 1;                    /* loop variable, endianess test */
+  const unsigned char *b;       /* to traverse the bytes */
+
+  assert(rep && p && (n <= 8)); /* check the function arguments */
+  if (rep->next +n > rep->end)  /* if the output buffer is full, */
+    isr_flush(rep);             /* flush it (write it to the file) */
+  b = (const unsigned char*)p;  /* traverse the bytes */
+  if (*(char*)&i)               /* little endian: in memory order */
+    for (i = 0;  i < n; i++) *rep->next++ = (char)b[i];
+  else                          /* big endian: in reverse order */
+    for (i = n; --i >= 0; )  *rep->next++ = (char)b[i];
+}  /* isr_putx() */             /* (files are always little endian) */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_putsupp (ISREPORT *rep, SUPP_T supp)
+{                               /* --- write a support value */
+  int    i;                     /* integer support */
+  double d;                     /* real-valued support */
+
+  if (SUPP_ISDBL) { d = (double)supp; isr_putx(rep, &d, 8); }
+  else            { i = (int)   supp; isr_putx(rep, &i, 4); }
+}  /* isr_putsupp() */
+
+/*--------------------------------------------------------------------*/
+
+static void binhdr (ISREPORT *rep)
+{                               /* --- write binary file header */
+  int        i, n;              /* loop variable, number of items */
+  const char *name;             /* to traverse the item names */
+
+  assert(rep && rep->file);     /* check the function arguments */
+  isr_putsn(rep, ISR_BINMAGIC, 4);
+  isr_putc (rep, ISR_BINVERS);  /* write magic number, version */
+  isr_putc (rep, SUPP_ISDBL ? 8 : 4); /* and width of support */
+  isr_putsupp(rep, rep->supps[0]);    /* write the total weight */
+  n = ib_cnt(rep->base);        /* get the number of items */
+  isr_putv(rep, (unsigned int)n);
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    name = rep->inames[i];      /* and write the item dictionary */
+    isr_putv (rep, (unsigned int)strlen(name));
+    isr_puts (rep, name);       /* (name length and name) */
+  }
+}  /* binhdr() */
+
+/*--------------------------------------------------------------------*/
+
+static void binout (ISREPORT *rep, const int *items, int n, int rule,
+                    SUPP_T supp, SUPP_T body, SUPP_T head,
+                    const double *eval)
+{                               /* --- write a set/rule in binary */
+  int d;                        /* difference to preceding item */
+
+  assert(rep && rep->file && (items || (n <= 0)));
+  isr_putv(rep, ((unsigned int)n << 2) | (rule ? 2 : 0)
+              | (eval ? 1 : 0));/* write the record type */
+  if (n > 0)                    /* and the first item */
+    isr_putv(rep, (unsigned int)items[0]);
+  while (--n > 0) {             /* traverse the other items */
+    d = items[1] -items[0]; items++;
+    isr_putv(rep, ((unsigned int)d << 1) ^ (unsigned int)(d >> 31));
+  }                             /* write zigzag encoded differences */
+  isr_putsupp(rep, supp);       /* write the support of the set */
+  if (rule) {                   /* and for rules also the support */
+    isr_putsupp(rep, body);     /* of the rule body and */
+    isr_putsupp(rep, head);     /* of the rule head */
+  }
+  if (eval)                     /* write the evaluation (if any, */
+    isr_putx(rep, eval, 8);     /* presence is indicated by a flag) */
+}  /* binout() */
+
+/*----------------------------------------------------------------------
+  Transaction Id Output Functions
+----------------------------------------------------------------------*/
+/* Binary transaction id files (mode ISR_TIDBIN) start with the magic */
+/* number "ISRT" and a version byte. Each list starts with a varint  */
+/* holding (number of ids << 2) | (counts << 1) | bitmap. Lists are  */
+/* written in ascending order, with ids starting at 0. A delta coded */
+/* list holds the first id and then the gaps to the preceding ids    */
+/* (minus 1), all as varints, each followed by the number of items   */
+/* contained in the transaction if the counts flag is set. A bitmap  */
+/* list holds the first id, the number of bitmap bytes (varints) and */
+/* then the bitmap bytes, in which bit j (of byte j/8, from the low  */
+/* bit) refers to transaction first id +j. A bitmap is chosen if it  */
+/* is shorter than one byte per transaction id.                      */
+
+static void tidfinish (ISREPORT *rep)
+{                               /* --- finish transaction id output */
+  tidflush(rep);                /* flush the write buffer */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (rep->tidasy) {            /* if there is a writer thread, */
+    asystop(rep, rep->tidasy);  /* wait for it to terminate */
+    asydel (rep->tidasy); rep->tidasy = NULL;
+  }                             /* and delete the writer */
+  #endif
+}  /* tidfinish() */
+
+/*--------------------------------------------------------------------*/
+
+static void tidputv (ISREPORT *rep, unsigned int v)
+{                               /* --- write a varint to tid output */
+  if (rep->tidnxt +5 > rep->tidend)
+    tidflush(rep);              /* ensure space for the number */
+  rep->tidnxt = putv(rep->tidnxt, v);
+}  /* tidputv() */              /* store the number in the buffer */
+
+/*--------------------------------------------------------------------*/
+
+static void tidbin (ISREPORT *rep, const int *tids, int n, int step)
+{                               /* --- write a tid list in binary */
+  int i, t, b, k;               /* loop variable, tid, bit, byte */
+  int first, last;              /* first and last transaction id */
+
+  if (n <= 0) { tidputv(rep, 0); return; }
+  first = tids[0]; last = tids[(n-1)*step];
+  if (((last -first) >> 3) +1 < n) {
+    tidputv(rep, ((unsigned int)n << 2) | 1);
+    tidputv(rep, (unsigned int)first);
+    tidputv(rep, (unsigned int)((last -first) >> 3) +1);
+    for (k = b = i = 0; i < n; i++, tids += step) {
+      t = *tids -first;         /* traverse the transaction ids */
+      for ( ; k < (t >> 3); k++) {
+        if (rep->tidnxt >= rep->tidend) tidflush(rep);
+        *rep->tidnxt++ = (char)b; b = 0;
+      }                         /* write the completed bytes */
+      b |= 1 << (t & 7);        /* set the bit of the trans. id */
+    }                           /* in the current bitmap byte */
+    if (rep->tidnxt >= rep->tidend) tidflush(rep);
+    *rep->tidnxt++ = (char)b; } /* write the last bitmap byte */
+  else {                        /* if to write a delta coded list */
+    tidputv(rep, (unsigned int)n << 2);
+    tidputv(rep, (unsigned int)first);
+    for (t = first, i = 1; i < n; i++) {
+      tids += step; tidputv(rep, (unsigned int)(*tids -t -1));
+      t = *tids;                /* write the gaps between */
+    }                           /* the transaction ids */
+  }
+}  /* tidbin() */
+
+/*--------------------------------------------------------------------*/
+
+static void tidcnts (ISREPORT *rep)
+{                               /* --- write a tid list with counts */
+  int i, k, n, min;             /* loop variables, minimum count */
+
+  min = rep->cnt -rep->miscnt;  /* get the minimum number of items */
+  if (rep->mode & ISR_TIDBIN) { /* if to write in binary format */
+    for (n = i = 0; i < rep->tracnt; i++)
+      n += (rep->tids[i] >= min);
+    tidputv(rep, ((unsigned int)n << 2) | ((rep->miscnt > 0) ? 2 : 0));
+    for (k = -1, i = 0; i < rep->tracnt; i++) {
+      if (rep->tids[i] < min) continue;
+      tidputv(rep, (unsigned int)((k < 0) ? i : i -k -1)); k = i;
+      if (rep->miscnt > 0) tidputv(rep, (unsigned int)rep->tids[i]);
+    } return; }                 /* write ids (and item counters) */
+  for (i = k = 0; i < rep->tracnt; i++) {
+    if (rep->tids[i] < min)     /* skip all transactions that */
+      continue;                 /* do not contain enough items */
+    if (k++ > 0) tidputsn(rep, rep->sep, (int)strlen(rep->sep));
+    isr_tidout(rep, i+1);       /* print the transaction identifier */
+    if (rep->miscnt <= 0) continue;
+    tidputsn(rep, ":", 1);      /* print an item counter separator */
+    isr_tidout(rep, rep->tids[i]);
+  }                             /* print number of contained items */
+  tidputsn(rep, "\n", 1);       /* terminate the transaction id list */
+}  /* tidcnts() */
+
+/*--------------------------------------------------------------------*/
+
+static void tidlist (ISREPORT *rep)
+{                               /* --- write a transaction id list */
+  int       i, n, k;            /* loop variable, number of ids */
+  const int *tids;              /* to traverse the transaction ids */
+
+  if ((rep->tidcnt == 0) && (rep->tracnt > 0)) {
+    tidcnts(rep); return; }     /* list with item counters */
+  n = abs(rep->tidcnt);         /* get the number of trans. ids */
+  k = (rep->tidcnt >= 0) ? 1 : -1;  /* and the traversal direction */
+  tids = (k > 0) ? rep->tids : rep->tids +n-1;
+  if (rep->mode & ISR_TIDBIN) { /* if to write in binary format */
+    tidbin(rep, tids, n, k); return; }
+  n = (int)strlen(rep->sep);    /* get the length of the separator */
+  for (i = abs(rep->tidcnt); --i >= 0; tids += k) {
+    isr_tidout(rep, *tids +1);  /* print the transaction identifier */
+    if (i > 0) tidputsn(rep, rep->sep, n);
+  }                             /* print a separator if needed */
+  tidputsn(rep, "\n", 1);       /* terminate the transaction id list */
+}  /* tidlist() */
+
 /*----------------------------------------------------------------------
   Generator Filtering Functions
 ----------------------------------------------------------------------*/
@@ -436,6 +918,215 @@ static int is_isgen (ISREPORT *rep, int item, SUPP_T supp)
   Main Functions
 ----------------------------------------------------------------------*/
 
+#define worse(a,b)  (((a)->val <  (b)->val) \
+                 || (((a)->val == (b)->val) && ((a)->id > (b)->id)))
+
+static void sift (TOPRULE **heap, int i, int n)
+{                               /* --- let a rule sink in the heap */
+  int     k;                    /* index of a successor */
+  TOPRULE *r = heap[i];         /* rule to let sink */
+
+  while ((k = i+i+1) < n) {     /* while there is a successor */
+    if ((k+1 < n) && worse(heap[k+1], heap[k]))
+      k++;                      /* get the worse successor */
+    if (!worse(heap[k], r)) break;
+    heap[i] = heap[k]; i = k;   /* if the successor is worse, */
+  }                             /* move it up and go down */
+  heap[i] = r;                  /* store the rule in its place */
+}  /* sift() */
+
+/*--------------------------------------------------------------------*/
+
+static void topadd (ISREPORT *rep, const int *items, int n,
+                    SUPP_T supp, SUPP_T body, SUPP_T head, double eval)
+{                               /* --- offer a rule to the collector */
+  int     i, k;                 /* loop variable, heap index */
+  double  val;                  /* value of the selection measure */
+  int     *p;                   /* (reallocated) item buffer */
+  TOPRULE *r;                   /* rule to fill */
+  ISRTOPN *top = rep->topn;     /* top-N rule collector */
+
+  val = top->dir *top->fn((int)supp, (int)body, (int)head,
+                          (int)rep->supps[0]);
+  if (isnan(val)) val = -INFINITY;  /* compute the rule's value */
+  top->seen++;                  /* count the offered rule */
+  if (top->cnt < top->max) {    /* if the collector is not full, */
+    k = top->cnt;               /* get the next free rule */
+    r = top->rules +k; }
+  else if (val > top->heap[0]->val) {
+    k = 0; r = top->heap[0]; }  /* replace the worst rule */
+  else {                        /* if the rule is below the cutoff, */
+    top->drop++; return; }      /* simply drop it */
+  if (n > r->size) {            /* if the item buffer is too small */
+    p = (int*)realloc(r->items, (size_t)n *sizeof(int));
+    if (!p) { top->drop++; return; }
+    r->items = p; r->size = n;  /* on failure drop the rule, */
+  }                             /* otherwise set the new buffer */
+  for (i = 0; i < n; i++) r->items[i] = items[i];
+  r->cnt  = n;    r->val  = val;  r->id   = top->seen;
+  r->supp = supp; r->body = body; r->head = head; r->eval = eval;
+  if (top->cnt >= top->max) {   /* if the worst rule was replaced, */
+    sift(top->heap, 0, top->cnt); return; }   /* let it sink */
+  top->cnt++;                   /* count the new rule */
+  while (k > 0) {               /* let the new rule rise in the heap */
+    i = (k-1) >> 1;             /* get the index of the predecessor */
+    if (!worse(r, top->heap[i])) break;
+    top->heap[k] = top->heap[i]; k = i;
+  }                             /* move the predecessor down */
+  top->heap[k] = r;             /* store the new rule */
+}  /* topadd() */
+
+/*--------------------------------------------------------------------*/
+
+static void topdel (ISRTOPN *top)
+{                               /* --- delete a top-N rule collector */
+  int i;                        /* loop variable */
+
+  for (i = 0; i < top->max; i++)
+    if (top->rules[i].items) free(top->rules[i].items);
+  free(top->heap);              /* delete the item buffers, */
+  free(top);                    /* the heap and the base structure */
+}  /* topdel() */
+
+/* The heap keeps the worst collected rule at its root, so that a */
+/* rule can be dropped with a single comparison once the collector */
+/* is full. Rules with equal value are ranked by their order of    */
+/* arrival, so the selection does not depend on the heap layout.   */
+
+/*--------------------------------------------------------------------*/
+
+static void shswitch (ISREPORT *rep, int k)
+{                               /* --- switch to another shard */
+  ISRSHARD *sh = rep->shard;    /* sharded output */
+  ISRSHD   *d;                  /* shard to switch from/to */
+
+  if (k == sh->cur) return;     /* check for the current shard */
+  d = sh->shds +sh->cur;        /* note the write state */
+  d->buf    = rep->buf;         /* of the current shard */
+  d->next   = rep->next;
+  d = sh->shds +(sh->cur = k);  /* get the new shard and */
+  rep->file = d->file;          /* make it the output target */
+  rep->buf  = d->buf;
+  rep->next = d->next;
+  rep->end  = rep->buf +rep->bsize;
+}  /* shswitch() */
+
+/*--------------------------------------------------------------------*/
+
+static void shsel (ISREPORT *rep, const int *items, int n, int rule)
+{                               /* --- select the shard of a set/rule */
+  unsigned int h;               /* hash value of the item set */
+  ISRSHARD     *sh = rep->shard;/* sharded output */
+
+  if (rule && (sh->key == ISR_SHHEAD))
+    h = (unsigned int)items[0]; /* shard rules by their head item */
+  else {                        /* shard item sets by a hash value */
+    for (h = 0; --n >= 0; )     /* sum the hash values of the items */
+      h += ((unsigned int)items[n] +1) *0x9e3779b1u;
+    h ^= h >> 16;               /* (a sum is order independent, */
+  }                             /* which is needed for item sets) */
+  shswitch(rep, (int)(h % (unsigned int)sh->cnt));
+  sh->shds[sh->cur].cnt++;      /* switch to the selected shard */
+}  /* shsel() */                /* and count the set/rule */
+
+/*--------------------------------------------------------------------*/
+
+static int shfree (ISREPORT *rep)
+{                               /* --- close shard files and buffers */
+  int      i, r = 0;            /* loop variable, result of fclose() */
+  ISRSHARD *sh = rep->shard;    /* sharded output */
+  ISRSHD   *d;                  /* to traverse the shards */
+
+  shswitch(rep, 0);             /* return to the main write buffer */
+  for (i = 0; i < sh->cnt; i++) {
+    d = sh->shds +i;            /* traverse the shards */
+    if (d->file) { r |= fclose(d->file); d->file = NULL; }
+    if (d->buf && (i > 0)) free(d->buf);
+    d->buf = d->next = NULL;    /* close the shard files and */
+  }                             /* delete the extra write buffers */
+  if (sh->mft) { r |= fclose(sh->mft); sh->mft = NULL; }
+  if (sh->names) { free(sh->names); sh->names = NULL; }
+  rep->file = NULL;             /* close the manifest, delete names */
+  return r;                     /* return the result of fclose() */
+}  /* shfree() */
+
+/*--------------------------------------------------------------------*/
+
+static int shopen (ISREPORT *rep, const char *name)
+{                               /* --- open the shards and manifest */
+  int      i;                   /* loop variable */
+  size_t   n;                   /* size of a shard file name */
+  ISRSHARD *sh = rep->shard;    /* sharded output */
+  ISRSHD   *d;                  /* to traverse the shards */
+
+  n = strlen(name) +16;         /* allocate a buffer for the names */
+  sh->names = (char*)malloc((size_t)sh->cnt *n *sizeof(char));
+  if (!sh->names) return -1;    /* (manifest name with shard index) */
+  for (i = 0; i < sh->cnt; i++) {
+    d = sh->shds +i;            /* traverse the shards */
+    d->name = sh->names +(size_t)i *n;
+    sprintf(d->name, "%s.%d", name, i);
+    d->buf  = d->next = (i > 0) ? NULL : rep->buf;
+    d->cnt  = 0;                /* build the shard file names */
+  }                             /* and initialize the shards */
+  sh->cur = 0;                  /* the main buffer is the first one */
+  sh->mft = fopen(rep->name = name, "w");
+  if (!sh->mft) { shfree(rep); return -2; }
+  for (i = 0; i < sh->cnt; i++) {
+    d = sh->shds +i;            /* traverse the shards */
+    if ((i > 0) && !(d->buf = d->next = (char*)malloc(rep->bsize)))
+      { shfree(rep); return -1; }
+    d->file = fopen(d->name, "w");
+    if (!d->file) { shfree(rep); return -2; }
+  }                             /* create buffers and open files */
+  rep->next = rep->buf;         /* start with the first shard */
+  rep->file = sh->shds[0].file;
+  if (rep->mode & ISR_BINARY) { /* if to write in binary format */
+    for (i = sh->cnt; --i >= 0; ) {
+      shswitch(rep, i); binhdr(rep); }
+  }                             /* write a header to each shard */
+  return 0;                     /* return 'ok' */
+}  /* shopen() */
+
+/*--------------------------------------------------------------------*/
+
+static int shclose (ISREPORT *rep)
+{                               /* --- close shards, write manifest */
+  int      i, n, r = 0;         /* loop variables, error flag */
+  ISRSHARD *sh = rep->shard;    /* sharded output */
+  ISRSHD   *d;                  /* to traverse the shards */
+
+  for (i = 0; i < sh->cnt; i++) {
+    shswitch(rep, i); isr_flush(rep); }
+  fprintf(sh->mft, "shards\t%d\t%s\n", sh->cnt,
+          (sh->key == ISR_SHHEAD) ? "head" : "hash");
+  for (i = 0; i < sh->cnt; i++) {
+    d = sh->shds +i;            /* traverse the shards */
+    fprintf(sh->mft, "%d\t%s\t%ld\t%ld\n",
+            i, d->name, d->cnt, ftell(d->file));
+    r |= ferror(d->file);       /* list the shard files with their */
+  }                             /* number of records and bytes */
+  if (sh->key == ISR_SHHEAD) {  /* if the rules are sharded by head, */
+    n = ib_cnt(rep->base);      /* list the shard of each item */
+    for (i = 0; i < n; i++)
+      fprintf(sh->mft, "%d\t%s\n", i % sh->cnt, rep->inames[i]);
+  }
+  r |= ferror(sh->mft);         /* check for write errors */
+  return shfree(rep) | r;       /* close files and delete buffers */
+}  /* shclose() */
+
+/* Each shard has its own write buffer (the first shard uses the     */
+/* main buffer of the reporter), which is swapped into the reporter */
+/* before a set or rule is written, so that the output functions   */
+/* need not know about shards. Asynchronous writing is not used.   */
+/* The manifest is a tab separated text file with a line "shards", */
+/* the number of shards and the key, one line per shard file with  */
+/* index, file name, number of records and size in bytes, and (for */
+/* sharding by the head item) one line per item with its shard.   */
+/* Item sets have no head item and are therefore always hashed.    */
+
+/*--------------------------------------------------------------------*/
+
 ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
                       const char *hdr, const char *sep, const char *imp)
 {                               /* --- create an item set reporter */
@@ -456,10 +1147,16 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
   rep->base    = base;          /* store the item base */
   rep->file    = NULL;          /* clear the output file and its name */
   rep->name    = NULL;          /* and allocate a file write buffer */
-  rep->buf     = (char*)malloc(BS_WRITE *sizeof(char));
+  rep->bsize   = BS_WRITE;      /* note the write buffer size */
+  rep->buf     = (char*)malloc(rep->bsize *sizeof(char));
   if (!rep->buf) { free(rep); return NULL; }
   rep->next    = rep->buf;
-  rep->end     = rep->buf +BS_WRITE;
+  rep->end     = rep->buf +rep->bsize;
+  rep->async   = NULL;          /* default: synchronous writing */
+  rep->topn    = NULL;          /* default: report all rules */
+  rep->shard   = NULL;          /* default: a single output file */
+  rep->wrcnt   = rep->bpcnt = 0;/* clear the output statistics */
+  rep->bytes   = rep->iowait = 0;
   rep->mode    = mode & MODEMASK;
   rep->rep     = 0;             /* init. the item set counter and */
   rep->min     = 1;             /* the range of item set sizes */
@@ -475,8 +1172,12 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
   rep->evaldir = 1;             /* default: threshold is minimum */
   rep->repofn  = (ISREPOFN*)0;  /* clear item set report function */
   rep->repodat = NULL;          /* and the corresponding data */
+  rep->ritems  = NULL;          /* clear the current rule */
+  rep->rsupp   = rep->rbody = rep->rhead = 0;
   rep->tidfile = NULL;          /* clear the transaction id file */
   rep->tidname = NULL;          /* and its name */
+  rep->tidbuf  = rep->tidnxt = rep->tidend = NULL;
+  rep->tidasy  = NULL;          /* (buffer is created on opening) */
   rep->tids    = NULL;          /* clear transaction ids array and */
   rep->tidcnt  = 0;             /* the number of transaction ids */
   rep->tracnt  = 0;             /* set default value for the other */
@@ -585,9 +1286,25 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
 
 int isr_delete (ISREPORT *rep, int mode)
 {                               /* --- delete an item set reporter */
-  int i, k;                     /* loop variable, buffers */
+  int i, k, r;                  /* loop variable, buffers */
 
   assert(rep);                  /* check the function argument */
+  k = (mode & ISR_FCLOSE) ? isr_tidclose(rep) : 0;
+  r = (mode & ISR_FCLOSE) ? isr_close(rep)    : 0;
+  if (rep->tidfile) tidfinish(rep);  /* write the buffered tids */
+  if (rep->shard && rep->shard->mft) {
+    isr_topout(rep);            /* the shard files and the manifest */
+    if (shclose(rep) != 0) r = EOF;  /* were opened by the reporter, */
+  }                             /* so they are always closed */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (rep->async && rep->async->file) {
+    isr_flush(rep);             /* if the writer thread is running, */
+    asystop(rep, rep->async);   /* pass it the buffered output and */
+  }                             /* wait for it to terminate */
+  #endif                        /* (the file is left open) */
+  /* The files must be closed before anything is freed, because */
+  /* closing reports the collected best rules (option -N), which */
+  /* needs the item names, the output buffer and the item base.  */
   #ifdef ISR_CLOMAX             /* if closed/maximal filtering */
   if (rep->clomax) cm_delete(rep->clomax);
   if (rep->gentab) st_delete(rep->gentab);
@@ -605,18 +1322,35 @@ int isr_delete (ISREPORT *rep, int mode)
   if (rep->supps) free(rep->supps);
   if (rep->stats) free(rep->stats);  /* delete the item base */
   if (mode & ISR_DELISET) ib_delete(rep->base);
-  k = (mode & ISR_FCLOSE) ? isr_tidclose(rep) : 0;
-  i = (mode & ISR_FCLOSE) ? isr_close(rep)    : 0;
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (rep->async) asydel(rep->async);
+  #endif                        /* delete an asynchronous writer */
+  if (rep->topn) topdel(rep->topn);   /* delete a rule collector */
+  if (rep->shard) { shfree(rep); free(rep->shard); }
+  if (rep->tidbuf) free(rep->tidbuf); /* delete the tid buffer */
   free(rep->buf);               /* delete the file write buffer */
   free(rep);                    /* delete the base structure */
-  return (i) ? i : k;           /* return file closing result */
+  return (r) ? r : k;           /* return file closing result */
 }  /* isr_delete() */
 
 /*--------------------------------------------------------------------*/
 
 int isr_open (ISREPORT *rep, FILE *file, const char *name)
 {                               /* --- open an output file */
+  int r;                        /* result of shopen() */
+
   assert(rep);                  /* check the function arguments */
+  if (rep->shard) {             /* if to write sharded output */
+    if (!file && name && *name){/* if a proper name is given */
+      #ifdef ISR_ASYNC          /* if asynchronous writing */
+      if (rep->async) { asydel(rep->async); rep->async = NULL; }
+      #endif                    /* shards are written synchronously */
+      r = shopen(rep, name);    /* open the shard files */
+      fastchk(rep);             /* and the manifest and */
+      return r;                 /* check for fast output */
+    }
+    isr_setshard(rep, 0, 0);    /* shards need a proper file name, */
+  }                             /* otherwise write a single file */
   if (file)                     /* if a file is given, */
     rep->name = name;           /* store the file name */
   else if (! name) {            /* if no name is given */
@@ -629,6 +1363,13 @@ int isr_open (ISREPORT *rep, FILE *file, const char *name)
   }                             /* and check for an error */
   rep->file = file;             /* store the new output file */
   fastchk(rep);                 /* check for fast output */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (file && rep->async        /* if to use an async. writer, */
+  &&  (asystart(rep->async, file) != 0)) {   /* start the thread */
+    asydel(rep->async); rep->async = NULL; }
+  #endif                        /* (on failure write synchronously) */
+  if (file && (rep->mode & ISR_BINARY))
+    binhdr(rep);                /* write a binary file header */
   return 0;                     /* return 'ok' */
 }  /* isr_open() */
 
@@ -639,8 +1380,18 @@ int isr_close (ISREPORT *rep)
   int r;                        /* result of fclose()/fflush() */
 
   assert(rep);                  /* check the function arguments */
+  isr_topout(rep);              /* report the collected rules */
+  if (rep->shard && rep->shard->mft) {
+    r = shclose(rep);           /* close the shards, */
+    fastchk(rep);               /* write the manifest and */
+    return r;                   /* check for fast output */
+  }
   if (!rep->file) return 0;     /* check for an output file */
   isr_flush(rep);               /* flush the write buffer */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (rep->async)               /* if there is a writer thread, */
+    asystop(rep, rep->async);   /* wait for it to terminate */
+  #endif
   r = ((rep->file == stdout) || (rep->file == stderr))
     ? fflush(rep->file) : fclose(rep->file);
   rep->file = NULL;             /* close the current output file */
@@ -650,6 +1401,33 @@ int isr_close (ISREPORT *rep)
 
 /*--------------------------------------------------------------------*/
 
+int isr_setbuf (ISREPORT *rep, size_t size, int async)
+{                               /* --- set write buffer size/mode */
+  char *buf;                    /* new write buffer */
+
+  assert(rep && !rep->file && !rep->tidfile);
+  if (size <= 0)     size = rep->bsize; /* keep the current size */
+  if (size < BS_MIN) size = BS_MIN;     /* or ensure a minimum size */
+  buf = (char*)realloc(rep->buf, size *sizeof(char));
+  if (!buf) return -1;          /* resize the write buffer */
+  rep->buf   = rep->next = buf; /* and set the new buffer */
+  rep->end   = buf +size;       /* and its size */
+  rep->bsize = size;
+  if (rep->tidbuf) {            /* delete a transaction id buffer */
+    free(rep->tidbuf); rep->tidbuf = NULL; }
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (rep->async) {             /* if there is an async. writer, */
+    asydel(rep->async); rep->async = NULL; }
+  if (!async) return 0;         /* delete it (will be recreated) */
+  rep->async = asynew(size);    /* create an asynchronous writer */
+  return (rep->async) ? 0 : -1; /* with a second write buffer */
+  #else                         /* if only synchronous writing, */
+  return (async) ? 1 : 0;       /* indicate that async. writing */
+  #endif                        /* is not possible */
+}  /* isr_setbuf() */
+
+/*--------------------------------------------------------------------*/
+
 void isr_reset (ISREPORT *rep)
 {                               /* --- reset the output counters */
   rep->rep = 0;                 /* reinit. number of reported sets */
@@ -704,6 +1482,82 @@ void isr_setrepo (ISREPORT *rep, ISREPOFN repofn, void *data)
 
 /*--------------------------------------------------------------------*/
 
+int isr_settopn (ISREPORT *rep, int n, ISRULEFN *fn, int dir)
+{                               /* --- set up top-N rule collection */
+  int     i;                    /* loop variable */
+  ISRTOPN *top;                 /* created top-N rule collector */
+
+  assert(rep && ((n <= 0) || fn));   /* check the function arguments */
+  if (rep->topn) { topdel(rep->topn); rep->topn = NULL; }
+  if (n <= 0) return 0;         /* delete an existing collector */
+  top = (ISRTOPN*)malloc(sizeof(ISRTOPN) +(size_t)(n-1)
+                                         *sizeof(TOPRULE));
+  if (!top) return -1;          /* create a rule collector */
+  top->heap = (TOPRULE**)malloc((size_t)n *sizeof(TOPRULE*));
+  if (!top->heap) { free(top); return -1; }
+  for (i = 0; i < n; i++) {     /* create the rule heap and */
+    top->rules[i].size  = 0;    /* clear the item buffers */
+    top->rules[i].items = NULL;
+  }
+  top->fn   = fn;  top->dir = (dir < 0) ? -1 : +1;
+  top->max  = n;   top->cnt = top->out = 0;
+  top->seen = top->drop = 0;    /* initialize the fields */
+  rep->topn = top;              /* and set the collector */
+  return 0;                     /* return 'ok' */
+}  /* isr_settopn() */
+
+/*--------------------------------------------------------------------*/
+
+void isr_topout (ISREPORT *rep)
+{                               /* --- report the collected rules */
+  int     i, n;                 /* loop variable, number of rules */
+  TOPRULE *r;                   /* to traverse the rules */
+  ISRTOPN *top;                 /* top-N rule collector */
+
+  assert(rep);                  /* check the function argument */
+  top = rep->topn;              /* get the rule collector */
+  if (!top || (top->cnt <= 0)) return;
+  for (n = top->cnt; --n > 0; ) {
+    r = top->heap[0]; top->heap[0] = top->heap[n]; top->heap[n] = r;
+    sift(top->heap, 0, n);      /* heap sort the collected rules */
+  }                             /* (worst rule to the end) */
+  top->out = 1;                 /* report the rules best first */
+  for (i = 0; i < top->cnt; i++) {
+    r = top->heap[i];           /* traverse the sorted rules */
+    isr_rule(rep, r->items, r->cnt, r->supp, r->body, r->head, r->eval);
+  }                             /* report the rules in the normal way */
+  top->out = 0;                 /* and clear the collector */
+  top->cnt = 0;                 /* (item buffers are kept for reuse) */
+}  /* isr_topout() */
+
+/*--------------------------------------------------------------------*/
+
+int isr_setshard (ISREPORT *rep, int n, int key)
+{                               /* --- set up sharded output */
+  int      i;                   /* loop variable */
+  ISRSHARD *sh;                 /* created sharded output */
+
+  assert(rep && !rep->file);    /* check the function arguments */
+  if (rep->shard) {             /* delete an existing sharding */
+    shfree(rep); free(rep->shard); rep->shard = NULL; }
+  if (n <= 1) { fastchk(rep); return 0; }
+  sh = (ISRSHARD*)malloc(sizeof(ISRSHARD) +(size_t)(n-1)
+                                          *sizeof(ISRSHD));
+  if (!sh) return -1;           /* create the sharded output */
+  for (i = 0; i < n; i++) {     /* and clear the shards */
+    sh->shds[i].file = NULL; sh->shds[i].name = NULL;
+    sh->shds[i].buf  = sh->shds[i].next = NULL;
+    sh->shds[i].cnt  = 0;       /* (files and buffers are */
+  }                             /* created in isr_open()) */
+  sh->cnt   = n;   sh->key   = (key == ISR_SHHASH) ? key : ISR_SHHEAD;
+  sh->cur   = 0;   sh->mft   = NULL; sh->names = NULL;
+  rep->shard = sh;              /* set the sharded output */
+  fastchk(rep);                 /* and check for fast output */
+  return 0;                     /* return 'ok' */
+}  /* isr_setshard() */
+
+/*--------------------------------------------------------------------*/
+
 int isr_tidopen (ISREPORT *rep, FILE *file, const char *name)
 {                               /* --- set/open trans. id output file */
   assert(rep);                  /* check the function arguments */
@@ -720,8 +1574,28 @@ int isr_tidopen (ISREPORT *rep, FILE *file, const char *name)
     file = fopen(rep->tidname = name, "w");
     if (!file) return -2;       /* open file with given name */
   }                             /* and check for an error */
+  if (file && !rep->tidbuf) {   /* if there is no write buffer, */
+    rep->tidbuf = (char*)malloc(rep->bsize *sizeof(char));
+    if (!rep->tidbuf) {         /* create a write buffer */
+      if ((file != stdout) && (file != stderr)) fclose(file);
+      return -1;                /* on failure close the file */
+    }                           /* and abort the function */
+  }
+  rep->tidnxt  = rep->tidbuf;   /* init. the next write position */
+  rep->tidend  = rep->tidbuf +rep->bsize;
   rep->tidfile = file;          /* store the new output file */
   fastchk(rep);                 /* check for fast output */
+  #ifdef ISR_ASYNC              /* if asynchronous writing */
+  if (file && rep->async) {     /* if the item sets are written */
+    rep->tidasy = asynew(rep->bsize);   /* asynchronously, */
+    if (rep->tidasy && (asystart(rep->tidasy, file) != 0)) {
+      asydel(rep->tidasy); rep->tidasy = NULL; }
+  }                             /* start a writer thread for tids */
+  #endif                        /* (on failure write synchronously) */
+  if (file && (rep->mode & ISR_TIDBIN)) {
+    tidputsn(rep, ISR_TIDMAGIC, 4);
+    tidputv (rep, ISR_TIDVERS); /* write magic number and version */
+  }                             /* of a binary transaction id file */
   return 0;                     /* return 'ok' */
 }  /* isr_tidopen() */
 
@@ -733,6 +1607,7 @@ int isr_tidclose (ISREPORT *rep)
 
   assert(rep);                  /* check the function arguments */
   if (!rep->tidfile) return 0;  /* check for an output file */
+  tidfinish(rep);               /* write the buffered tid lists */
   r = ((rep->tidfile == stdout) || (rep->tidfile == stderr))
     ? fflush(rep->tidfile) : fclose(rep->tidfile);
   rep->tidfile = NULL;          /* close the current output file */
@@ -960,8 +1835,7 @@ static void fastout (ISREPORT *rep, int n)
 
 static void output (ISREPORT *rep)
 {                               /* --- output an item set */
-  int        i, k;              /* loop variable, flag */
-  int        min;               /* minimum number of items */
+  int        i;                 /* loop variable */
   char       *s;                /* to traverse the output buffer */
   const char *name;             /* to traverse the item names */
   double     sum;               /* to compute the logarithm sums */
@@ -989,44 +1863,27 @@ static void output (ISREPORT *rep)
   if (rep->repofn)              /* call reporting function if given */
     rep->repofn(rep, rep->repodat);
   if (!rep->file) return;       /* check for an output file */
-  s = rep->pos[rep->pfx];       /* get the position for appending */
-  while (rep->pfx < rep->cnt) { /* traverse the additional items */
-    if (rep->pfx > 0)           /* if this is not the first item */
-      for (name = rep->sep; *name; )
-        *s++ = *name++;         /* copy the item separator */
-    for (name = rep->inames[rep->items[rep->pfx]]; *name; )
-      *s++ = *name++;           /* copy the item name to the buffer */
-    rep->pos[++rep->pfx] = s;   /* compute and record new position */
-  }                             /* for appending the next item */
-  isr_putsn(rep, rep->out, s -rep->out);
-  isr_sinfo(rep, rep->supps[rep->cnt],
-            (rep->wgts) ? rep->wgts[rep->cnt] : 0, rep->eval);
-  isr_putc(rep, '\n');          /* print the item set information */
-  if (!rep->tidfile || !rep->tids) /* check whether to report */
-    return;                        /* a list of transaction ids */
-  if      (rep->tidcnt > 0) {   /* if tids are in ascending order */
-    for (i = 0; i < rep->tidcnt; i++) {
-      if (i > 0) fputs(rep->sep, rep->tidfile);
-      isr_tidout(rep, rep->tids[i]+1);
-    } }                         /* report the transaction ids */
-  else if (rep->tidcnt < 0) {   /* if tids are in descending order */
-    for (i = -rep->tidcnt; --i >= 0; ) {
-      isr_tidout(rep, rep->tids[i]+1);
-      if (i > 0) fputs(rep->sep, rep->tidfile);
-    } }                         /* report the transaction ids */
-  else if (rep->tracnt > 0) {   /* if item occurrence counters */
-    min = rep->cnt -rep->miscnt;/* traverse all transaction ids */
-    for (i = k = 0; i < rep->tracnt; i++) {
-      if (rep->tids[i] < min)   /* skip all transactions that */
-        continue;               /* do not contain enough items */
-      if (k++ > 0) fputs(rep->sep, rep->tidfile);
-      isr_tidout(rep, i+1);     /* print the transaction identifier */
-      if (rep->miscnt <= 0) continue;
-      fputc(':', rep->tidfile); /* print an item counter separator */
-      isr_tidout(rep, rep->tids[i]);
-    }                           /* print number of contained items */
+  if (rep->shard) shsel(rep, rep->items, rep->cnt, 0);
+  if (rep->mode & ISR_BINARY)   /* if to write in binary format */
+    binout(rep, rep->items, rep->cnt, 0, rep->supps[rep->cnt], 0, 0,
+           (rep->evalfn || rep->wgts) ? &rep->eval : NULL);
+  else {                        /* if to write in text format */
+    s = rep->pos[rep->pfx];     /* get the position for appending */
+    while (rep->pfx < rep->cnt) {  /* traverse the additional items */
+      if (rep->pfx > 0)         /* if this is not the first item */
+        for (name = rep->sep; *name; )
+          *s++ = *name++;       /* copy the item separator */
+      for (name = rep->inames[rep->items[rep->pfx]]; *name; )
+        *s++ = *name++;         /* copy the item name to the buffer */
+      rep->pos[++rep->pfx] = s; /* compute and record new position */
+    }                           /* for appending the next item */
+    isr_putsn(rep, rep->out, s -rep->out);
+    isr_sinfo(rep, rep->supps[rep->cnt],
+              (rep->wgts) ? rep->wgts[rep->cnt] : 0, rep->eval);
+    isr_putc(rep, '\n');        /* print the item set information */
   }
-  fputc('\n', rep->tidfile);    /* terminate the transaction id list */
+  if (rep->tidfile && rep->tids)  /* if to report a list */
+    tidlist(rep);               /* of transaction ids, write it */
 }  /* output() */
 
 /*--------------------------------------------------------------------*/
@@ -1053,6 +1910,8 @@ int isr_report (ISREPORT *rep)
   int    n, k, z;               /* number of perfect exts., buffer */
   long   m, c;                  /* buffers for item set counting */
   double w;                     /* buffer for an item set weight */
+  char   *e;                    /* start of formatted support */
+  char   buf[BS_INT];           /* buffer for support formatting */
   #ifdef ISR_CLOMAX             /* if closed/maximal filtering */
   SUPP_T s, r;                  /* support buffers */
   int    *items;                /* item set for prefix tree update */
@@ -1102,8 +1961,11 @@ int isr_report (ISREPORT *rep)
   /* It is debatable whether this way of handling perfect extensions  */
   /* in case no output is produced is acceptable for fair benchmarks, */
   /* since the sets in the hypercube are not explicitly generated.    */
-  if (rep->fast)                /* format support for fast output */
-    rep->size = sprintf(rep->info, " (%d)\n", rep->supps[rep->cnt]);
+  if (rep->fast) {              /* format support for fast output */
+    e = utoa(buf+BS_INT-2, (unsigned int)rep->supps[rep->cnt]);
+    *--e = '('; *--e = ' '; buf[BS_INT-2] = ')'; buf[BS_INT-1] = '\n';
+    memcpy(rep->info, e, rep->size = (int)(buf+BS_INT-e));
+  }                             /* (" (<supp>)\n" as with printf) */
   if (rep->mode & ISR_NOEXPAND){/* if not to expand perfect exts. */
     k = rep->cnt +n;            /* if all perfext extensions make */
     if (k > rep->max) return 0; /* the item set too large, abort */
@@ -1159,6 +2021,9 @@ void isr_direct (ISREPORT *rep, const int *items, int n,
   rep->stats[n]++;              /* count the reported item set */
   rep->rep++;                   /* (for its size and overall) */
   if (!rep->file) return;       /* check for an output file */
+  if (rep->shard) shsel(rep, items, n, 0);  /* select shard */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary format */
+    binout(rep, items, n, 0, supp, 0, 0, &eval); return; }
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   if (n > 0)                    /* print the first item */
@@ -1187,6 +2052,9 @@ void isr_directx (ISREPORT *rep, const int *items, int n,
   rep->stats[n]++;              /* count the reported item set */
   rep->rep++;                   /* (for its size and overall) */
   if (!rep->file) return;       /* check for an output file */
+  if (rep->shard) shsel(rep, items, n, 0);  /* select shard */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary format */
+    binout(rep, items, n, 0, supp, 0, 0, &eval); return; }
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   if (n > 0) {                  /* if at least one item */
@@ -1214,9 +2082,21 @@ void isr_rule (ISREPORT *rep, const int *items, int n,
   &&     items && (n > 0) && (supp >= 0));
   if ((n < rep->min) || (n > rep->max))
     return;                     /* check the item set size */
+  if (rep->topn && !rep->topn->out) {
+    topadd(rep, items, n, supp, body, head, eval); return; }
   rep->stats[n]++;              /* count the reported rule */
   rep->rep++;                   /* (for its size and overall) */
+  if (rep->repofn) {            /* if there is a reporting function */
+    c = rep->cnt; rep->cnt = n; /* note the rule for isr_r*() */
+    rep->ritems = items; rep->rsupp = supp;
+    rep->rbody  = body;  rep->rhead = head; rep->eval = eval;
+    rep->repofn(rep, rep->repodat);
+    rep->ritems = NULL;  rep->cnt   = c;
+  }                             /* call the reporting function */
   if (!rep->file) return;       /* check for an output file */
+  if (rep->shard) shsel(rep, items, n, 1);  /* select shard */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary format */
+    binout(rep, items, n, 1, supp, body, head, &eval); return; }
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   isr_puts(rep, rep->inames[*items++]);
@@ -1244,6 +2124,21 @@ void isr_prstats (ISREPORT *rep, FILE *out)
     if (rep->stats[n] != 0) break;
   for (i = 0; i <= n; i++)      /* print set counters per set size */
     fprintf(out, "%3d: %ld\n", i, rep->stats[i]);
+  if (rep->topn)                /* print top-N collector statistics */
+    fprintf(out, "top: %ld of %ld rule(s) below the cutoff\n",
+            rep->topn->drop, rep->topn->seen);
+  if (rep->shard)               /* print the number of shards */
+    fprintf(out, "shards: %d (by %s)\n", rep->shard->cnt,
+            (rep->shard->key == ISR_SHHEAD) ? "head item" : "hash");
+  if (rep->wrcnt <= 0) return;  /* check for written output */
+  fprintf(out, "output: %.0f byte(s) in %ld block(s) of %ld byte(s)\n",
+          rep->bytes, rep->wrcnt, (long)rep->bsize);
+  if (rep->async)               /* print the output statistics */
+    fprintf(out, "writer: %ld wait(s) for output thread, %.2fs\n",
+            rep->bpcnt, rep->iowait);
+  else                          /* (back-pressure and waiting time */
+    fprintf(out, "writer: synchronous, %.2fs in writes\n",
+            rep->iowait);       /* or the time spent writing) */
 }  /* isr_prstats() */
 
 /*--------------------------------------------------------------------*/
@@ -61,6 +61,18 @@
 #define ISR_LOGS      0x0100    /* compute sums of logarithms */
 #define ISR_WEIGHTS   0x0200    /* allow for item set weights */
 #define ISR_SCAN      0x0400    /* report in scanable form */
+#define ISR_BINARY    0x0800    /* report in binary format */
+#define ISR_TIDBIN    0x1000    /* report trans. ids in binary format */
+
+/* --- binary format --- */
+#define ISR_BINMAGIC  "ISRB"    /* magic number of binary files */
+#define ISR_BINVERS   1         /* version of the binary format */
+#define ISR_TIDMAGIC  "ISRT"    /* magic number of binary tid files */
+#define ISR_TIDVERS   1         /* version of the binary tid format */
+
+/* --- shard keys --- */
+#define ISR_SHHEAD    0         /* shard rules by their head item */
+#define ISR_SHHASH    1         /* shard by a hash of the item set */
 
 /* --- delete modes --- */
 #define ISR_DELISET   0x0001    /* delete the item set */
@@ -69,9 +81,13 @@
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
+struct israsync;                /* --- asynchronous writer --- */
+struct isrtopn;                 /* --- top-N rule collector --- */
+struct isrshard;                /* --- sharded output --- */
 struct isreport;                /* --- an item set eval. function --- */
 typedef double ISEVALFN (struct isreport *rep, void *data);
 typedef void   ISREPOFN (struct isreport *rep, void *data);
+typedef double ISRULEFN (int supp, int body, int head, int base);
 
 typedef struct isreport {       /* --- an item set reporter --- */
   ITEMBASE   *base;             /* underlying item base */
@@ -80,6 +96,14 @@ typedef struct isreport {       /* --- an item set reporter --- */
   char       *buf;              /* write buffer for output */
   char       *next;             /* next character position to write */
   char       *end;              /* end of the write buffer */
+  size_t     bsize;             /* size of the write buffer */
+  struct israsync *async;       /* asynchronous writer (if any) */
+  struct isrtopn  *topn;        /* top-N rule collector (if any) */
+  struct isrshard *shard;       /* sharded output (if any) */
+  long       wrcnt;             /* number of written blocks */
+  long       bpcnt;             /* number of waits for the writer */
+  double     bytes;             /* number of written bytes */
+  double     iowait;            /* time spent waiting for output */
   int        mode;              /* reporting mode (e.g. ISR_CLOSED) */
   int        min;               /* minimum number of items in set */
   int        max;               /* maximum number of items in set */
@@ -112,6 +136,10 @@ typedef struct isreport {       /* --- an item set reporter --- */
   double     eval;              /* additional evaluation value */
   ISREPOFN   *repofn;           /* item set reporting function */
   void       *repodat;          /* item set reporting data */
+  const int  *ritems;           /* items of current rule (head first) */
+  SUPP_T     rsupp;             /* support of current rule */
+  SUPP_T     rbody;             /* support of current rule body */
+  SUPP_T     rhead;             /* support of current rule head */
   const char *hdr;              /* record header for output */
   const char *sep;              /* item separator for output */
   const char *imp;              /* implication sign for rule output */
@@ -123,6 +151,10 @@ typedef struct isreport {       /* --- an item set reporter --- */
   char       info[32];          /* item set info.    for fastout() */
   FILE       *tidfile;          /* output file for transaction ids */
   const char *tidname;          /* name of tid output file */
+  char       *tidbuf;           /* write buffer for trans. ids */
+  char       *tidnxt;           /* next character position to write */
+  char       *tidend;           /* end of the tid write buffer */
+  struct israsync *tidasy;      /* asynchronous tid writer (if any) */
   int        *tids;             /* array  of transaction ids */
   int        tidcnt;            /* number of transaction ids */
   int        tracnt;            /* total number of transactions */
@@ -142,6 +174,7 @@ extern int        isr_mode     (ISREPORT *rep);
 extern int        isr_target   (ISREPORT *rep);
 extern int        isr_open     (ISREPORT *rep, FILE *file, CCHAR *name);
 extern int        isr_close    (ISREPORT *rep);
+extern int        isr_setbuf   (ISREPORT *rep, size_t size, int async);
 extern FILE*      isr_file     (ISREPORT *rep);
 extern CCHAR*     isr_name     (ISREPORT *rep);
 
@@ -154,6 +187,10 @@ extern void       isr_seteval  (ISREPORT *rep, ISEVALFN evalfn,
                                 void *data, int dir, double thresh);
 extern void       isr_setrepo  (ISREPORT *rep, ISREPOFN repofn,
                                 void *data);
+extern int        isr_settopn  (ISREPORT *rep, int n,
+                                ISRULEFN *fn, int dir);
+extern void       isr_topout   (ISREPORT *rep);
+extern int        isr_setshard (ISREPORT *rep, int n, int key);
 extern int        isr_tidopen  (ISREPORT *rep, FILE *file, CCHAR *name);
 extern int        isr_tidclose (ISREPORT *rep);
 extern void       isr_tidcfg   (ISREPORT *rep, int tracnt, int miscnt);
@@ -187,6 +224,12 @@ extern double     isr_logsum   (ISREPORT *rep);
 extern double     isr_logsumx  (ISREPORT *rep, int index);
 extern double     isr_eval     (ISREPORT *rep);
 
+extern const int* isr_ritems   (ISREPORT *rep);
+extern SUPP_T     isr_rsupp    (ISREPORT *rep);
+extern SUPP_T     isr_rbody    (ISREPORT *rep);
+extern SUPP_T     isr_rhead    (ISREPORT *rep);
+extern double     isr_rconf    (ISREPORT *rep);
+
 extern int        isr_pexcnt   (ISREPORT *rep);
 extern int        isr_pex      (ISREPORT *rep, int index);
 extern const int* isr_pexs     (ISREPORT *rep);
@@ -269,6 +312,12 @@ extern int        isr_tail     (ISREPORT *rep, const int *items, int n);
 #define isr_logsumx(r,i)  ((r)->sums [i])
 #define isr_eval(r)       ((r)->eval)
 
+#define isr_ritems(r)     ((r)->ritems)
+#define isr_rsupp(r)      ((r)->rsupp)
+#define isr_rbody(r)      ((r)->rbody)
+#define isr_rhead(r)      ((r)->rhead)
+#define isr_rconf(r)      ((r)->rsupp /(double)(r)->rbody)
+
 #define isr_pexcnt(r)     ((int)((r)->items -(r)->pexs))
 #define isr_pex(r,t)      ((r)->pexs [i])
 #define isr_pexs(r)       ((const int*)(r)->pexs)
@@ -84,6 +84,14 @@
 #include <math.h>
 #include <time.h>
 #include <assert.h>
+#ifdef TA_THREADS
+#include <pthread.h>
+#endif
+#if defined __SSE2__ && defined __GNUC__
+#include <immintrin.h>
+#define TA_SIMD                 /* SSE2, AVX2 with runtime dispatch */
+#define TA_WIDE      4          /* min. dest./source size ratio */
+#endif                          /* for eight item vector search */
 #include "tract.h"
 #include "scanner.h"
 #ifndef NOMAIN
@@ -101,7 +109,8 @@
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
 #define PRGNAME     "tract"
-#define DESCRIPTION "benchmarking transaction sorting methods"
+#define DESCRIPTION "benchmarking transaction sorting methods " \
+                    "and support queries"
 #define VERSION     "version 1.7 (2012.07.30)         " \
                     "(c) 2011-2012   Christian Borgelt"
 
@@ -116,6 +125,8 @@
 
 #define BLKSIZE      1024       /* block size for enlarging arrays */
 #define TH_INSERT       8       /* threshold for insertion sort */
+#define TH_ITSORT      16       /* threshold for direct trans. sort */
+#define TH_RANGE     4096       /* min. range size for par. sweeps */
 #define TS_PRIMES    (sizeof(primes)/sizeof(*primes))
 
 #ifndef QUIET                   /* if not quiet version, */
@@ -213,6 +224,9 @@ static CCHAR    *prgname;       /* program name for error messages */
 static TABREAD  *tread = NULL;  /* table/transaction reader */
 static ITEMBASE *ibase = NULL;  /* item base */
 static TABAG    *tabag = NULL;  /* transaction bag/multiset */
+static TIDIDX   *tidx  = NULL;  /* vertical index (tid lists) */
+static TRACT    **qrys = NULL;  /* support queries (benchmark) */
+static int      nqry   = 0;     /* number of support queries */
 #endif
 
 static char msgbuf[2*TRD_MAXLEN+64];  /* buffer for error messages */
@@ -763,9 +777,10 @@ const char* ib_errmsg (ITEMBASE *base, char *buf, size_t size)
     k = snprintf(buf, size, "%s:%d(%d): ", TRD_FPOS(base->trd));
     if (k >= size) k = size-1;  /* print the input file name and */
   }                             /* the record and field number */
-  snprintf(buf+k, size-k, msg, trd_field(base->trd));
+  snprintf(buf+k, size-k, msg, ((i >= -E_FOPEN) && (i <= -E_FWRITE))
+           ? trd_name(base->trd) : trd_field(base->trd));
   return buf;                   /* format the error message */
-}  /* ib_errmsg() */
+}  /* ib_errmsg() */            /* (with file name or field) */
 
 /*--------------------------------------------------------------------*/
 
@@ -1109,10 +1124,10 @@ int ta_cmpx (const TRACT *t, const int *items, int n)
 
   assert(t && items);           /* check the function arguments */
   k = (n < t->size) ? n : t->size;
-  for (i = t->items; --k >= 0; i++, items++) {
-    if (*i < *items) return -1; /* compare corresponding items */
-    if (*i > *items) return +1; /* and abort the comparison */
-  }                             /* if one of them is greater */
+  for (i = t->items; (--k >= 0) && (*i == *items); i++, items++)
+    ;                           /* skip the equal items and */
+  if (k >= 0)                   /* compare the first differing ones */
+    return (*i < *items) ? -1 : +1;
   return t->size -n;            /* return the size difference */
 }  /* ta_cmpx() */
 
@@ -1130,38 +1145,149 @@ int ta_cmpsz (const void *p1, const void *p2, void *data)
 
 /*--------------------------------------------------------------------*/
 
+#if !defined TA_SIMD || defined TRACT_BENCH
+
+static int subset (const TRACT *t1, const TRACT *t2, int off)
+{                               /* --- test for subset (scalar) */
+  const int *s, *d, *e, *x, *y; /* to traverse the items */
+
+  s = t1->items;                /* check for empty source sequence, */
+  if (*s <= TA_END) return 0;   /* then traverse the destination */
+  e = t2->items +(t2->size -t1->size);
+  for (d = t2->items +off; d <= e; d++) {
+    if (*d != *s) continue;     /* try to find source start in dest. */
+    for (x = s+1, y = d+1; *x > TA_END; y++) {
+      if (*y <= TA_END) return -1;  /* compare the remaining items */
+      if (*x == *y) x++;        /* skip matched item in source and */
+    }                           /* always skip item in destination */
+    return d -t2->items;        /* all in source matched, subset */
+  }                             /* (if the greedy matching fails, */
+  return -1;                    /* it also fails for later starts) */
+}  /* subset() */
+
+#endif
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_SIMD
+
+static const int* find4 (const int *p, const int *e, int i)
+{                               /* --- find an item (SSE2) */
+  int     m;                    /* match mask */
+  __m128i v = _mm_set1_epi32(i);/* item to find in all lanes */
+
+  for ( ; p +4 <= e; p += 4) {  /* compare blocks of four items */
+    m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_loadu_si128((const __m128i*)p), v)));
+    if (m) return p +__builtin_ctz((unsigned int)m);
+  }                             /* return the first match */
+  while ((p < e) && (*p != i)) p++;
+  return p;                     /* compare the remaining items */
+}  /* find4() */
+
+/*--------------------------------------------------------------------*/
+
+__attribute__((target("avx2")))
+static const int* find8 (const int *p, const int *e, int i)
+{                               /* --- find an item (AVX2) */
+  int     m;                    /* match mask */
+  __m256i v = _mm256_set1_epi32(i);   /* item to find in all lanes */
+  __m128i u = _mm256_castsi256_si128(v);
+
+  if (p +4 <= e) {              /* check the next four items first, */
+    m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_loadu_si128((const __m128i*)p), u)));
+    if (m) return p +__builtin_ctz((unsigned int)m);
+    p += 4;                     /* as matches are often close */
+  }
+  for ( ; p +8 <= e; p += 8) {  /* compare blocks of eight items */
+    m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+          _mm256_loadu_si256((const __m256i*)p), v)));
+    if (m) return p +__builtin_ctz((unsigned int)m);
+  }                             /* return the first match */
+  if (p +4 <= e) {              /* compare a last block of four */
+    m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_loadu_si128((const __m128i*)p), u)));
+    if (m) return p +__builtin_ctz((unsigned int)m);
+    p += 4;                     /* (less than eight items left) */
+  }
+  while ((p < e) && (*p != i)) p++;
+  return p;                     /* compare the remaining items */
+}  /* find8() */
+
+/*--------------------------------------------------------------------*/
+
+static inline int subfind (const TRACT *t1, const TRACT *t2,
+  int off, const int* find (const int*, const int*, int))
+{                               /* --- test for subset (with search) */
+  const int *s, *d, *e, *y;     /* to traverse the items */
+
+  s = t1->items;                /* check for empty source sequence */
+  if (*s <= TA_END) return 0;   /* and get the end of destination */
+  e = t2->items +t2->size;      /* search for the source start */
+  d = find(t2->items +off, e -t1->size +1, *s);
+  if (d > e -t1->size)          /* (all other source items must */
+    return -1;                  /* still fit after the start) */
+  for (y = d; *++s > TA_END; )  /* find the remaining source items */
+    if ((y = find(y+1, e, *s)) >= e) return -1;
+  return d -t2->items;          /* all in source found, subset */
+}  /* subfind() */
+
+/*--------------------------------------------------------------------*/
+
+static int subset4 (const TRACT *t1, const TRACT *t2, int off)
+{ return subfind(t1, t2, off, find4); }
+
+__attribute__((target("avx2")))
+__attribute__((target("avx2")))
+static int subset8 (const TRACT *t1, const TRACT *t2, int off)
+{ return subfind(t1, t2, off, find8); }
+
+#endif
+/*--------------------------------------------------------------------*/
+
 int ta_subset (const TRACT *t1, const TRACT *t2, int off)
 {                               /* --- test for subset/subsequence */
-  const int *s, *d, *x, *y;     /* to traverse the items */
-
   assert(t1 && t2 && (off >= 0));  /* check the function arguments */
   if ((off > t2->size) || (t1->size > t2->size -off))
     return -1;                  /* check for (enough) items in dest. */
-  s = t1->items;                /* check for empty source sequence, */
-  if (*s <= TA_END) return 0;   /* then traverse the destination */
-  for (d = t2->items +off; *d > TA_END; d++) {
-    if (*d != *s) continue;     /* try to find source start in dest. */
-    for (x = s+1, y = d+1; 1; y++) {  /* compare the remaining items */
-      if (*x <= TA_END) return d -t2->items;
-      if (*y <= TA_END) break;  /* all in source matched, subset, */
-      if (*x == *y) x++;        /* end of destination, no subset */
-    }                           /* skip matched item in source and */
-  }                             /* always skip item in destination */
-  return -1;                    /* return 'not subsequence w/o gaps' */
+  #ifdef TA_SIMD                /* if vector instructions available */
+  if ((t2->size -off >= TA_WIDE *t1->size)
+  &&  __builtin_cpu_supports("avx2"))
+    return subset8(t1, t2, off);/* use wide vectors for long gaps */
+  return subset4(t1, t2, off);  /* and narrow vectors otherwise */
+  #else                         /* if only scalar code is possible */
+  return subset(t1, t2, off);   /* traverse the items one by one */
+  #endif
 }  /* ta_subset() */
 
+/* The greedy matching of the subset test mostly searches for the     */
+/* next occurrence of a source item in the destination. This is done  */
+/* with a vector comparison of four (SSE2) or eight items (AVX2) at a */
+/* time, if available (AVX2 is chosen at runtime, so the code also    */
+/* runs on older processors). Eight item blocks only pay off if the   */
+/* gaps between matches are long, that is, if the destination is at   */
+/* least TA_WIDE times as long as the source (as for candidates that  */
+/* are much shorter than the transactions, which is the common case). */
+/* Otherwise most matches lie in the first block of four items and    */
+/* the narrower search is faster. The result is the same as for the   */
+/* scalar version, because the first occurrence is found in both      */
+/* cases. The end of the destination is given by its size (for packed */
+/* items the rest of a transaction is filled with sentinels, which    */
+/* never match).                                                      */
+
 /*--------------------------------------------------------------------*/
 
 int ta_subwog (const TRACT *t1, const TRACT *t2, int off)
 {                               /* --- test for subsequence w/o gaps */
-  const int *s, *d, *x, *y;     /* to traverse the segments */
+  const int *s, *d, *e, *x, *y; /* to traverse the segments */
 
   assert(t1 && t2 && (off >= 0));  /* check the function arguments */
   if ((off > t2->size) || (t1->size > t2->size -off))
     return -1;                  /* check for (enough) items in dest. */
   s = t1->items;                /* check for empty source sequence, */
   if (*s <= TA_END) return 0;   /* then traverse the destination */
-  for (d = t2->items +off; *d > TA_END; d++) {
+  e = t2->items +(t2->size -t1->size);
+  for (d = t2->items +off; d <= e; d++) {
     if (*d != *s) continue;     /* try to find source start in dest. */
     x = s; y = d;               /* compare the remaining items */
     do { if (*++x <= TA_END) return d -t2->items; }
@@ -1409,39 +1535,142 @@ int wta_cmpsz (const void *p1, const void *p2, void *data)
 
 /*--------------------------------------------------------------------*/
 
-int wta_subset (const WTRACT *t1, const WTRACT *t2, int off)
-{                               /* --- test for subset/subsequence */
-  const WITEM *s, *d, *x, *y;   /* to traverse the items */
+#if !defined TA_SIMD || defined TRACT_BENCH
+
+static int wsubset (const WTRACT *t1, const WTRACT *t2, int off)
+{                               /* --- test for subset (scalar) */
+  const WITEM *s, *d, *e, *x, *y;  /* to traverse the items */
 
-  assert(t1 && t2 && (off >= 0));  /* check the function arguments */
-  if ((off > t2->size) || (t1->size > t2->size -off))
-    return -1;                  /* check for (enough) items in dest. */
   s = t1->items;                /* check for empty source sequence, */
   if (s->id < 0) return 0;      /* then traverse the destination */
-  for (d = t2->items +off; d->id >= 0; d++) {
+  e = t2->items +(t2->size -t1->size);
+  for (d = t2->items +off; d <= e; d++) {
     if (d->id != s->id)         /* try to find source start in dest., */
       continue;                 /* then compare the remaining items */
-    for (x = s+1, y = d+1; 1; y++) {
-      if (x->id < 0) return d -t2->items;
-      if (y->id < 0) break;     /* all in source matched, subset, */
-      if (x->id == y->id) x++;  /* end of destination, no subset */
-    }                           /* skip matched item in source */
-  }                             /* always skip item in destination */
-  return -1;                    /* return 'not subsequence w/o gaps' */
+    for (x = s+1, y = d+1; x->id >= 0; y++) {
+      if (y->id < 0) return -1; /* end of destination, no subset */
+      if (x->id == y->id) x++;  /* skip matched item in source */
+    }                           /* always skip item in destination */
+    return d -t2->items;        /* all in source matched, subset */
+  }                             /* (if the greedy matching fails, */
+  return -1;                    /* it also fails for later starts) */
+}  /* wsubset() */
+
+#endif
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_SIMD
+
+static const WITEM* wfind4 (const WITEM *p, const WITEM *e, int i)
+{                               /* --- find an item (SSE2) */
+  int     m;                    /* match mask */
+  __m128  a, b;                 /* two blocks of two items */
+  __m128i v = _mm_set1_epi32(i);/* item to find in all lanes */
+
+  for ( ; p +4 <= e; p += 4) {  /* compare blocks of four items */
+    a = _mm_loadu_ps((const float*)(p));
+    b = _mm_loadu_ps((const float*)(p+2));
+    a = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+    m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_castps_si128(a), v)));  /* collect the identifiers */
+    if (m) return p +__builtin_ctz((unsigned int)m);
+  }                             /* return the first match */
+  while ((p < e) && (p->id != i)) p++;
+  return p;                     /* compare the remaining items */
+}  /* wfind4() */
+
+/*--------------------------------------------------------------------*/
+
+__attribute__((target("avx2")))
+static const WITEM* wfind8 (const WITEM *p, const WITEM *e, int i)
+{                               /* --- find an item (AVX2) */
+  int     m;                    /* match mask */
+  __m128  c, d;                 /* two blocks of two items */
+  __m256  a, b;                 /* two blocks of four items */
+  __m256i v = _mm256_set1_epi32(i);   /* item to find in all lanes */
+  __m128i u = _mm256_castsi256_si128(v);
+
+  if (p +4 <= e) {              /* check the next four items first, */
+    c = _mm_loadu_ps((const float*)(p));   /* as matches are often */
+    d = _mm_loadu_ps((const float*)(p+2)); /* close to the start */
+    c = _mm_shuffle_ps(c, d, _MM_SHUFFLE(2,0,2,0));
+    m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+          _mm_castps_si128(c), u)));
+    if (m) return p +__builtin_ctz((unsigned int)m);
+    p += 4;                     /* return a match or skip the block */
+  }
+  for ( ; p +8 <= e; p += 8) {  /* compare blocks of eight items */
+    a = _mm256_loadu_ps((const float*)(p));
+    b = _mm256_loadu_ps((const float*)(p+4));
+    a = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+    m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+          _mm256_castps_si256(a), v)));
+    if (m) return p +__builtin_ctz((unsigned int)
+                  ((m & 0xc3) | ((m & 0x0c) << 2) | ((m & 0x30) >> 2)));
+  }                             /* (identifiers are collected in the */
+  while ((p < e) && (p->id != i)) p++;    /* order 0,1,4,5,2,3,6,7, */
+  return p;                     /* so the mask bits 2,3 and 4,5 are */
+}  /* wfind8() */               /* swapped to restore the order) */
+
+/*--------------------------------------------------------------------*/
+
+static inline int wsubfind (const WTRACT *t1, const WTRACT *t2,
+  int off, const WITEM* find (const WITEM*, const WITEM*, int))
+{                               /* --- test for subset (with search) */
+  const WITEM *s, *d, *e, *y;   /* to traverse the items */
+
+  s = t1->items;                /* check for empty source sequence */
+  if (s->id < 0) return 0;      /* and get the end of destination */
+  e = t2->items +t2->size;      /* search for the source start */
+  d = find(t2->items +off, e -t1->size +1, s->id);
+  if (d > e -t1->size)          /* (all other source items must */
+    return -1;                  /* still fit after the start) */
+  for (y = d; (++s)->id >= 0; ) /* find the remaining source items */
+    if ((y = find(y+1, e, s->id)) >= e) return -1;
+  return d -t2->items;          /* all in source found, subset */
+}  /* wsubfind() */
+
+/*--------------------------------------------------------------------*/
+
+static int wsubset4 (const WTRACT *t1, const WTRACT *t2, int off)
+{ return wsubfind(t1, t2, off, wfind4); }
+
+__attribute__((target("avx2")))
+__attribute__((target("avx2")))
+static int wsubset8 (const WTRACT *t1, const WTRACT *t2, int off)
+{ return wsubfind(t1, t2, off, wfind8); }
+
+#endif
+/*--------------------------------------------------------------------*/
+
+int wta_subset (const WTRACT *t1, const WTRACT *t2, int off)
+{                               /* --- test for subset/subsequence */
+  assert(t1 && t2 && (off >= 0));  /* check the function arguments */
+  if ((off > t2->size) || (t1->size > t2->size -off))
+    return -1;                  /* check for (enough) items in dest. */
+  #ifdef TA_SIMD                /* if vector instructions available */
+  if ((t2->size -off >= TA_WIDE *t1->size)
+  &&  __builtin_cpu_supports("avx2"))
+    return wsubset8(t1, t2, off);   /* use wide vectors for long */
+  return wsubset4(t1, t2, off); /* gaps, narrow vectors otherwise */
+  #else                         /* if only scalar code is possible */
+  return wsubset(t1, t2, off);  /* traverse the items one by one */
+  #endif
 }  /* wta_subset() */
 
 /*--------------------------------------------------------------------*/
 
 int wta_subwog (const WTRACT *t1, const WTRACT *t2, int off)
 {                               /* --- test for subsequence w/o gaps */
-  const WITEM *s, *d, *x, *y;   /* to traverse the segments */
+  const WITEM *s, *d, *e, *x, *y;  /* to traverse the segments */
 
   assert(t1 && t2 && (off >= 0));  /* check the function arguments */
   if ((off > t2->size) || (t1->size > t2->size -off))
     return -1;                  /* check for (enough) items in dest. */
   s = t1->items;                /* check for empty source sequence, */
   if (s->id < 0) return 0;      /* then traverse the destination */
-  for (d = t2->items +off; d->id >= 0; d++) {
+  e = t2->items +(t2->size -t1->size);
+  for (d = t2->items +off; d <= e; d++) {
     if (d->id != s->id)         /* try to find the source start */
       continue;                 /* in the destination sequence */
     x = s; y = d;               /* compare the remaining items */
@@ -1644,6 +1873,99 @@ int tbg_addib (TABAG *bag)
 
 /*--------------------------------------------------------------------*/
 
+static unsigned int ta_hash (const void *t, int wgts)
+{                               /* --- compute hash of a transaction */
+  unsigned int h;               /* computed hash value */
+  const int    *s;              /* to traverse the items */
+  const WITEM  *p;              /* to traverse the weighted items */
+
+  if (!wgts) {                  /* if standard transaction */
+    h = ((const TRACT*)t)->size;
+    for (s = ((const TRACT*)t)->items; *s > TA_END; s++)
+      h = h *16777619 +(unsigned int)*s; }
+  else {                        /* if transaction w/ weighted items */
+    h = ((const WTRACT*)t)->size;
+    for (p = ((const WTRACT*)t)->items; p->id >= 0; p++)
+      h = (h *16777619 +(unsigned int)p->id) *16777619
+        + (unsigned int)(int)(p->wgt *1024.0F);
+  }                             /* combine item identifiers */
+  return h;                     /* (and item weights) */
+}  /* ta_hash() */
+
+/*--------------------------------------------------------------------*/
+
+static int ta_same (const void *t1, const void *t2, int wgts)
+{                               /* --- check for equal transactions */
+  int         n;                /* loop variable */
+  const WITEM *a, *b;           /* to traverse the weighted items */
+
+  if (!wgts)                    /* if standard transactions */
+    return (((const TRACT*)t1)->size == ((const TRACT*)t2)->size)
+        && (memcmp(((const TRACT*)t1)->items, ((const TRACT*)t2)->items,
+                   (size_t)((const TRACT*)t1)->size *sizeof(int)) == 0);
+  n = ((const WTRACT*)t1)->size;/* if transactions w/ weighted items */
+  if (n != ((const WTRACT*)t2)->size) return 0;
+  a = ((const WTRACT*)t1)->items; b = ((const WTRACT*)t2)->items;
+  while (--n >= 0) {            /* compare identifiers and weights */
+    if ((a[n].id != b[n].id) || (a[n].wgt != b[n].wgt)) return 0; }
+  return -1;                    /* return 'transactions are equal' */
+}  /* ta_same() */
+
+/*--------------------------------------------------------------------*/
+
+static int tbg_rdmrg (TABAG *bag, TABREAD *tread, int mode)
+{                               /* --- read and merge transactions */
+  int          r, i, n;         /* result of ib_read(), buffers */
+  int          wgts;            /* flag for weighted items */
+  unsigned int h, k, y, z;      /* hash value/index and table size */
+  int          *htab = NULL;    /* hash table (trans. indices +1) */
+  void         *t, *u;          /* new and already stored trans. */
+
+  wgts = bag->mode & IB_WEIGHTS;/* get the transaction type */
+  z    = 0;                     /* there is no hash table yet */
+  while (1) {                   /* transaction read loop */
+    r = ib_read(bag->base, tread, mode);
+    if (r != 0) break;          /* read the next transaction and */
+    t = bag->base->tract;       /* check for error and end of file */
+    if (!(mode & TA_TERM)) {    /* if not a sequence, canonicalize */
+      if (wgts) wi_sort (((WTRACT*)t)->items, ((WTRACT*)t)->size);
+      else      int_qsort(((TRACT*) t)->items, ((TRACT*) t)->size);
+    }                           /* (sort the items by identifier) */
+    if ((unsigned int)bag->cnt *3 >= z *2) {
+      n = (bag->cnt < BLKSIZE) ? BLKSIZE : bag->cnt +bag->cnt;
+      z = (unsigned int)taa_tabsize(n);
+      u = realloc(htab, z *sizeof(int));
+      if (!u) { r = E_NOMEM; break; }
+      htab = (int*)memset(u, 0, z *sizeof(int));
+      for (i = 0; i < bag->cnt; i++) {
+        h = ta_hash(bag->tracts[i], wgts);
+        y = h % (z-2) +1;       /* rehash the stored transactions */
+        for (k = h % z; htab[k]; k = (k+y) % z);
+        htab[k] = i+1;          /* find an empty bin and store */
+      }                         /* the transaction index in it */
+    }                           /* (enlarge the hash table) */
+    h = ta_hash(t, wgts);       /* compute the hash value */
+    y = h % (z-2) +1;           /* and the probing step width */
+    for (k = h % z; htab[k]; k = (k+y) % z)
+      if (ta_same(t, bag->tracts[htab[k]-1], wgts)) break;
+    if (htab[k]) {              /* if the transaction is a duplicate, */
+      u = bag->tracts[htab[k]-1];  /* only add its weight */
+      i = (wgts) ? ((WTRACT*)t)->wgt : ((TRACT*)t)->wgt;
+      if (wgts) ((WTRACT*)u)->wgt += i;
+      else      ((TRACT*) u)->wgt += i;
+      bag->wgt += i; continue;  /* sum the transaction weight */
+    }                           /* in the stored transaction */
+    r = (wgts) ? tbg_addw(bag, NULL) : tbg_add(bag, NULL);
+    if (r) { r = E_NOMEM; break; }
+    htab[k] = bag->cnt;         /* add a new transaction to the bag */
+  }                             /* and note its index (+1) in table */
+  if (htab) free(htab);         /* delete the hash table */
+  if (r == E_NOMEM) bag->base->err = E_NOMEM;
+  return (r < 0) ? r : 0;       /* return error code or 'ok' */
+}  /* tbg_rdmrg() */
+
+/*--------------------------------------------------------------------*/
+
 int tbg_read (TABAG *bag, TABREAD *tread, int mode)
 {                               /* --- read transactions from a file */
   int r;                        /* result of ib_read()/tbg_add() */
@@ -1651,6 +1973,8 @@ int tbg_read (TABAG *bag, TABREAD *tread, int mode)
   assert(bag && tread);         /* check the function arguments */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->ifrqs = bag->icnts = NULL; }
+  if (mode & TA_MERGE)          /* if to merge duplicate transactions */
+    return tbg_rdmrg(bag, tread, mode);
   while (1) {                   /* transaction read loop */
     r = ib_read(bag->base, tread, mode);
     if (r < 0) return r;        /* read the next transaction and */
@@ -1661,6 +1985,207 @@ int tbg_read (TABAG *bag, TABREAD *tread, int mode)
   }                             /* add transaction to bag/multiset */
 }  /* tbg_read() */
 
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+typedef struct {                /* --- part of a parallel read --- */
+  TABREAD   *trd;               /* reader for the part of the input */
+  ITEMBASE  *base;              /* thread-local item base */
+  int       mode;               /* read mode (e.g. TA_WEIGHT) */
+  int       err;                /* error code of the part */
+  int       cnt;                /* number of transactions */
+  int       size;               /* size of the transaction array */
+  TRACT     **tracts;           /* transactions (with local ids) */
+  int       *map;               /* map from local to global ids */
+  int       run;                /* whether a thread was started */
+  pthread_t thread;             /* thread for reading/recoding */
+} TBGPART;                      /* (part of a parallel read) */
+
+/*--------------------------------------------------------------------*/
+
+static void* tbg_rdpart (void *data)
+{                               /* --- read a part of the input */
+  int     n;                    /* new transaction array size */
+  TRACT   **p;                  /* new transaction array */
+  TBGPART *part = (TBGPART*)data;  /* part to read */
+
+  while (1) {                   /* transaction read loop */
+    part->err = ib_read(part->base, part->trd, part->mode);
+    if (part->err <  0) return NULL;   /* read the next transaction */
+    if (part->err >  0) { part->err = 0; return NULL; }
+    n = part->size;             /* get the transaction array size */
+    if (part->cnt >= n) {       /* if the transaction array is full */
+      n += (n > BLKSIZE) ? (n >> 1) : BLKSIZE;
+      p  = (TRACT**)realloc(part->tracts, (size_t)n *sizeof(TRACT*));
+      if (!p) { part->err = E_NOMEM; return NULL; }
+      part->tracts = p; part->size = n;
+    }                           /* enlarge the transaction array */
+    p = part->tracts +part->cnt;
+    if (!(*p = ta_clone(ib_tract(part->base)))) {
+      part->err = E_NOMEM; return NULL; }
+    part->cnt++;                /* store a copy of the transaction */
+  }                             /* (with local item identifiers) */
+}  /* tbg_rdpart() */
+
+/*--------------------------------------------------------------------*/
+
+static void* tbg_mappart (void *data)
+{                               /* --- recode a part to global ids */
+  int     i, k;                 /* loop variables */
+  TRACT   *t;                   /* to traverse the transactions */
+  TBGPART *part = (TBGPART*)data;  /* part to recode */
+
+  for (i = 0; i < part->cnt; i++) {
+    t = part->tracts[i];        /* traverse the transactions */
+    for (k = 0; k < t->size; k++)
+      t->items[k] = part->map[t->items[k]];
+  }                             /* map the local item identifiers */
+  return NULL;                  /* to the global ones */
+}  /* tbg_mappart() */
+
+/*--------------------------------------------------------------------*/
+
+static void tbg_runall (TBGPART *parts, int n, void* (*fn)(void*))
+{                               /* --- run a function on all parts */
+  int k;                        /* loop variable */
+
+  for (k = 0; k < n; k++)       /* start a thread for each part */
+    parts[k].run = (pthread_create(&parts[k].thread, NULL,
+                                   fn, parts +k) == 0);
+  for (k = 0; k < n; k++) {     /* traverse the parts again */
+    if (parts[k].run) pthread_join(parts[k].thread, NULL);
+    else              fn(parts +k);
+  }                             /* wait for the threads to finish */
+}  /* tbg_runall() */           /* (or do the work directly) */
+
+/*--------------------------------------------------------------------*/
+
+static int tbg_merge (TABAG *bag, TBGPART *parts, int n)
+{                               /* --- merge the parts of a read */
+  int        i, k, m;           /* loop variables, number of items */
+  size_t     z;                 /* size of an item key/name */
+  ITEMBASE   *base = bag->base; /* underlying item base */
+  ITEM       *src, *dst;        /* local and global item */
+  const void *key;              /* key/name of a local item */
+
+  for (k = 0; k < n; k++) {     /* traverse the parts in order */
+    m = ib_cnt(parts[k].base);  /* get the number of local items */
+    parts[k].map = (int*)malloc((size_t)(m+1) *sizeof(int));
+    if (!parts[k].map) return E_NOMEM;
+    for (i = 0; i < m; i++) {   /* traverse the local items */
+      src = (ITEM*)idm_byid(parts[k].base->idmap, i);
+      key = idm_key(src);       /* (in the order of their appearance) */
+      dst = (ITEM*)idm_bykey(base->idmap, key);
+      if (!dst) {               /* if the item is new, add it */
+        z = (base->mode & IB_INTNAMES)
+          ? sizeof(int) : strlen((const char*)key)+1;
+        dst = (ITEM*)idm_add(base->idmap, key, z, sizeof(ITEM));
+        if (!dst) return E_NOMEM;
+        dst->app = base->app;   /* add the new item to the map */
+        dst->idx = dst->xfq = dst->frq = 0;
+        dst->pen = base->pen;   /* clear counters and trans. index */
+      }                         /* and init. the insertion penalty */
+      dst->frq += src->frq;     /* sum the item frequencies */
+      dst->xfq += src->xfq;     /* (standard and extended) */
+      parts[k].map[i] = dst->id;/* and note the global identifier */
+    }
+    base->wgt += parts[k].base->wgt;
+    base->idx += parts[k].cnt;  /* sum the transaction weights */
+  }                             /* and count the transactions */
+  base->idx++;                  /* (like the final call of ib_read()) */
+  tbg_runall(parts, n, tbg_mappart);
+  for (m = bag->cnt, k = 0; k < n; k++)
+    m += parts[k].cnt;          /* recode the transactions and */
+  if (m > bag->size) {          /* count the transactions */
+    void **p = (void**)realloc(bag->tracts, (size_t)m *sizeof(TRACT*));
+    if (!p) return E_NOMEM;     /* enlarge the transaction array */
+    bag->tracts = p; bag->size = m;
+  }                             /* (to hold all transactions) */
+  for (k = 0; k < n; k++) {     /* traverse the parts in order */
+    for (i = 0; i < parts[k].cnt; i++)
+      tbg_add(bag, parts[k].tracts[i]);
+    parts[k].cnt = 0;           /* add the transactions to the bag */
+  }                             /* (they are now owned by the bag) */
+  return 0;                     /* return 'ok' */
+}  /* tbg_merge() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+int tbg_readpar (TABAG *bag, TABREAD *tread, int mode, int nthd)
+{                               /* --- read transactions in parallel */
+  #ifdef TA_THREADS             /* if parallel reading is possible */
+  int     i, k, n;              /* loop variables, number of parts */
+  int     r = 0;                /* result of reading/merging */
+  TABREAD **trds;               /* readers for the parts */
+  TBGPART *parts;               /* parts of the input */
+
+  assert(bag && tread);         /* check the function arguments */
+  if ((nthd <= 1)               /* sequential reading is needed */
+  ||  (mode & (TA_MERGE|TA_TERM))  /* for merging and sequences, */
+  ||  (bag->mode & IB_WEIGHTS)  /* for weighted items and */
+  ||  (bag->base->app == APP_NONE)) /* for ignoring new items */
+    return tbg_read(bag, tread, mode);
+  trds  = (TABREAD**)malloc((size_t)nthd *sizeof(TABREAD*));
+  parts = (TBGPART*) calloc((size_t)nthd, sizeof(TBGPART));
+  if (!trds || !parts) {        /* create the part arrays */
+    if (trds)  free(trds);
+    if (parts) free(parts);
+    return bag->base->err = E_NOMEM;
+  }
+  n = trd_split(tread, trds, nthd);
+  if (n <= 0) {                 /* split the input into parts */
+    free(trds); free(parts);    /* if this is not possible, */
+    return (n < 0) ? bag->base->err = E_NOMEM
+                   : tbg_read(bag, tread, mode);
+  }                             /* read the input sequentially */
+  if (bag->icnts) {             /* delete the item-specific counters */
+    free(bag->icnts); bag->ifrqs = bag->icnts = NULL; }
+  for (k = 0; k < n; k++) {     /* traverse the parts */
+    parts[k].trd  = trds[k];    /* and set up their item bases */
+    parts[k].mode = mode;
+    parts[k].base = ib_create(bag->base->mode, 0);
+    if (!parts[k].base) { r = E_NOMEM; continue; }
+    parts[k].base->app = bag->base->app;
+    parts[k].base->pen = bag->base->pen;
+  }                             /* (new items are initialized */
+  if (r == 0) {                 /* like in the global item base) */
+    tbg_runall(parts, n, tbg_rdpart);
+    for (i = k = 0; k < n; k++) {  /* read the parts in parallel */
+      if (parts[k].err) {       /* if an error occurred in a part, */
+        trd_join(tread, trds[k], i);   /* note its position */
+        bag->base->trd = tread; /* (with absolute record number) */
+        r = bag->base->err = parts[k].err; break;
+      }                         /* and abort with the error code */
+      i += trd_rec(trds[k]) -1; /* sum the numbers of records */
+    }                           /* of the preceding parts */
+    if (r == 0) {               /* merge dictionaries, add trans. */
+      r = tbg_merge(bag, parts, n);
+      bag->base->trd = tread;   /* note the reader of the input */
+      bag->base->err = (r) ? r : 1;
+    }                           /* and the error code (or end) */
+  }
+  for (k = 0; k < n; k++) {     /* traverse the parts */
+    for (i = 0; i < parts[k].cnt; i++)
+      free(parts[k].tracts[i]); /* delete unused transactions */
+    if (parts[k].tracts) free(parts[k].tracts);
+    if (parts[k].map)    free(parts[k].map);
+    if (parts[k].base)   ib_delete(parts[k].base);
+    trd_delete(trds[k], 0);     /* delete the item bases */
+  }                             /* and the part readers */
+  free(trds); free(parts);      /* delete the part arrays */
+  return r;                     /* return the error code */
+  #else                         /* if only sequential reading, */
+  return tbg_read(bag, tread, mode);  /* read the input normally */
+  #endif
+}  /* tbg_readpar() */
+
+/* The input is split at record boundaries and each part is read by */
+/* its own thread into a thread-local item base. The local item     */
+/* bases are merged in the order of the parts, so that the global   */
+/* item identifiers are the same as with sequential reading. The    */
+/* transactions are then recoded to global identifiers in parallel. */
+
 /*--------------------------------------------------------------------*/
 #ifdef TA_WRITE
 
@@ -1687,50 +2212,127 @@ int tbg_write (TABAG *bag, TABWRITE *twr, const char *wgtfmt, ...)
 #endif
 /*--------------------------------------------------------------------*/
 
-void recode (TABAG *bag, int *map)
-{                               /* --- recode items in transactions */
-  int    i, n;                  /* item buffer, loop variable */
-  TRACT  *t;                    /* to traverse the transactions */
-  int    *s, *d;                /* to traverse the items */
-  WTRACT *x;                    /* to traverse the transactions */
-  WITEM  *a, *b;                /* to traverse the items */
+typedef struct {                /* --- range of transactions --- */
+  TABAG     *bag;               /* transaction bag to process */
+  const int *map;               /* identifier map for recoding */
+  int       beg, end;           /* range of transaction indices */
+  int       dir;                /* direction for sorting items */
+  int       heap;               /* flag for heap sort */
+  int       max;                /* number of items in largest trans. */
+  int       extent;             /* total number of item instances */
+  #ifdef TA_THREADS             /* if parallel processing is possible */
+  int       run;                /* whether a thread was started */
+  pthread_t thread;             /* thread for recoding/sorting */
+  #endif
+} TBGRANGE;                     /* (range of transactions) */
 
-  assert(bag && map);           /* check the function arguments */
-  if (bag->icnts) {             /* delete the item-specific counters */
-    free(bag->icnts); bag->ifrqs = bag->icnts = NULL; }
-  bag->max = bag->extent = 0;   /* clear maximal transaction size */
-  if (bag->mode & IB_WEIGHTS) { /* if the items carry weights */
-    for (n = bag->cnt; --n >= 0; ) {
-      x = (WTRACT*)bag->tracts[n]; /* traverse the transactions */
+/*--------------------------------------------------------------------*/
+
+static void tbg_rngall (TABAG *bag, TBGRANGE *all, int nthd,
+                        void* (*fn)(void*))
+{                               /* --- process ranges of transactions */
+  int      k, n;                /* loop variable, number of ranges */
+  TBGRANGE *rng = all;          /* ranges of transactions */
+
+  n = bag->cnt /TH_RANGE;       /* get the number of ranges */
+  if (n > nthd) n = nthd;       /* (at most one per thread and */
+  if (n < 1)    n = 1;          /* at least TH_RANGE transactions) */
+  #ifdef TA_THREADS             /* if parallel processing is possible */
+  if (n > 1) rng = (TBGRANGE*)malloc((size_t)n *sizeof(TBGRANGE));
+  if (!rng) { rng = all; n = 1; }
+  #else                         /* if only sequential processing, */
+  n = 1;                        /* process all transactions at once */
+  #endif
+  for (k = 0; k < n; k++) {     /* split the transactions */
+    rng[k]     = *all;          /* into ranges of about equal size */
+    rng[k].beg = (int)((double)bag->cnt *k     /n);
+    rng[k].end = (int)((double)bag->cnt *(k+1) /n);
+  }
+  if (n <= 1) { fn(rng); return; }
+  #ifdef TA_THREADS             /* if parallel processing is possible */
+  for (k = 0; k < n; k++)       /* start a thread for each range */
+    rng[k].run = (pthread_create(&rng[k].thread, NULL,
+                                 fn, rng +k) == 0);
+  all->max = all->extent = 0;   /* traverse the ranges again */
+  for (k = 0; k < n; k++) {     /* and wait for the threads */
+    if (rng[k].run) pthread_join(rng[k].thread, NULL);
+    else            fn(rng +k); /* (or do the work directly) */
+    if (rng[k].max > all->max) all->max = rng[k].max;
+    all->extent += rng[k].extent;
+  }                             /* combine the size information */
+  free(rng);                    /* delete the range array */
+  #endif
+}  /* tbg_rngall() */
+
+/*--------------------------------------------------------------------*/
+
+static void* tbg_rcdrng (void *data)
+{                               /* --- recode a range of trans. */
+  int      i, n;                /* item buffer, loop variable */
+  TRACT    *t;                  /* to traverse the transactions */
+  int      *s, *d;              /* to traverse the items */
+  WTRACT   *x;                  /* to traverse the transactions */
+  WITEM    *a, *b;              /* to traverse the items */
+  TBGRANGE *rng = (TBGRANGE*)data;  /* range to recode */
+  const int *map = rng->map;    /* identifier map for recoding */
+
+  rng->max = rng->extent = 0;   /* clear maximal transaction size */
+  if (rng->bag->mode & IB_WEIGHTS) {   /* if items carry weights */
+    for (n = rng->beg; n < rng->end; n++) {
+      x = (WTRACT*)rng->bag->tracts[n];   /* traverse the trans. */
       for (a = b = x->items; a->id >= 0; a++) {
         i = map[a->id];         /* traverse and recode the items */
         if (i >= 0) (b++)->id = i; /* remove all items that are */
       }                         /* not mapped (mapped to id < 0) */
       x->size = b -x->items;    /* compute the new number of items */
       x->items[x->size] = WTA_END; /* store a sentinel at the end */
-      if (x->size > bag->max)   /* update the maximal trans. size */
-        bag->max = x->size;     /* (may differ from the old size */
-      bag->extent += x->size;   /* as items may have been removed) */
+      if (x->size > rng->max)   /* update the maximal trans. size */
+        rng->max = x->size;     /* (may differ from the old size */
+      rng->extent += x->size;   /* as items may have been removed) */
     } }                         /* and sum the item instances */
   else {                        /* if the items do not carry weights */
-    for (n = bag->cnt; --n >= 0; ) {
-      t = (TRACT*)bag->tracts[n];   /* traverse the transactions */
+    for (n = rng->beg; n < rng->end; n++) {
+      t = (TRACT*)rng->bag->tracts[n];    /* traverse the trans. */
       for (s = d = t->items; *s > TA_END; s++) {
         i = map[*s];            /* traverse and recode the items */
         if (i >= 0) *d++ = i;   /* remove all items that are */
       }                         /* not mapped (mapped to id < 0) */
       t->size = d -t->items;    /* compute the new number of items */
       t->items[t->size] = TA_END;  /* store a sentinel at the end */
-      if (t->size > bag->max)   /* update the maximal trans. size */
-        bag->max = t->size;     /* (may differ from the old size */
-      bag->extent += t->size;   /* as items may have been removed) */
+      if (t->size > rng->max)   /* update the maximal trans. size */
+        rng->max = t->size;     /* (may differ from the old size */
+      rng->extent += t->size;   /* as items may have been removed) */
     }                           /* and sum the item instances */
   }
+  return NULL;                  /* return a dummy result */
+}  /* tbg_rcdrng() */
+
+/*--------------------------------------------------------------------*/
+
+static void recode (TABAG *bag, const int *map, int nthd)
+{                               /* --- recode items in transactions */
+  TBGRANGE all;                 /* range of all transactions */
+
+  assert(bag && map);           /* check the function arguments */
+  if (bag->icnts) {             /* delete the item-specific counters */
+    free(bag->icnts); bag->ifrqs = bag->icnts = NULL; }
+  all.bag = bag; all.map = map; /* recode all transactions */
+  all.dir = all.heap = 0;       /* (possibly in parallel ranges) */
+  tbg_rngall(bag, &all, nthd, tbg_rcdrng);
+  bag->max    = all.max;        /* set the maximal transaction size */
+  bag->extent = all.extent;     /* and the number of item instances */
 }  /* recode() */
 
 /*--------------------------------------------------------------------*/
 
 int tbg_recode (TABAG *bag, int min, int max, int cnt, int dir)
+{ return tbg_recodepar(bag, min, max, cnt, dir, 1); }
+                                /* --- recode items sequentially */
+
+/*--------------------------------------------------------------------*/
+
+int tbg_recodepar (TABAG *bag, int min, int max, int cnt, int dir,
+                   int nthd)
 {                               /* --- recode items in transactions */
   int *map;                     /* identifier map for recoding */
 
@@ -1738,10 +2340,10 @@ int tbg_recode (TABAG *bag, int min, int max, int cnt, int dir)
   map = (int*)malloc(ib_cnt(bag->base) *sizeof(int));
   if (!map) return -1;          /* create an item identifier map */
   min = ib_recode(bag->base, min, max, cnt, dir, map);
-  recode(bag, map);             /* recode items and transactions */
+  recode(bag, map, nthd);       /* recode items and transactions */
   free(map);                    /* delete the item identifier map */
   return min;                   /* return the new number of items */
-}  /* tbg_recode() */
+}  /* tbg_recodepar() */
 
 /*--------------------------------------------------------------------*/
 
@@ -1856,33 +2458,59 @@ void tbg_trim (TABAG *bag, int min, const int *marks, double wgt)
 
 /*--------------------------------------------------------------------*/
 
-void tbg_itsort (TABAG *bag, int dir, int heap)
-{                               /* --- sort items in transactions */
-  int    i, n;                  /* loop variable, number of items */
-  TRACT  *t;                    /* to traverse the transactions */
-  WTRACT *x;                    /* to traverse the transactions */
-  void   (*sortfn)(int*, int);  /* transaction sort function */
+static void* tbg_srtrng (void *data)
+{                               /* --- sort items in a range */
+  int      i, n;                /* loop variable, number of items */
+  TRACT    *t;                  /* to traverse the transactions */
+  WTRACT   *x;                  /* to traverse the transactions */
+  void     (*sortfn)(int*, int);/* transaction sort function */
+  TBGRANGE *rng = (TBGRANGE*)data;  /* range to sort */
 
-  assert(bag);                  /* check the function arguments */
-  if (bag->mode & IB_WEIGHTS) { /* if the items carry weights */
-    for (i = bag->cnt; --i >= 0; ) {
-      x = (WTRACT*)bag->tracts[i]; /* traverse the transactions */
+  if (rng->bag->mode & IB_WEIGHTS) {   /* if items carry weights */
+    for (i = rng->beg; i < rng->end; i++) {
+      x = (WTRACT*)rng->bag->tracts[i];   /* traverse the trans. */
       wi_sort(x->items, x->size);
-      if (dir < 0) wi_reverse(x->items, x->size);
+      if (rng->dir < 0) wi_reverse(x->items, x->size);
     } }                         /* sort the items in each transaction */
   else {                        /* if the items do not carry weights */
-    sortfn = (heap) ? int_heapsort : int_qsort;
-    for (i = bag->cnt; --i >= 0; ) {
-      t = (TRACT*)bag->tracts[i];  /* traverse the transactions */
+    sortfn = (rng->heap) ? int_heapsort : int_qsort;
+    for (i = rng->beg; i < rng->end; i++) {
+      t = (TRACT*)rng->bag->tracts[i];    /* traverse the trans. */
       n = t->size;              /* get transaction and its size */
       if (n < 2) continue;      /* do not sort less than two items */
       while ((n > 0) && (t->items[n-1] <= TA_END))
         --n;                    /* skip additional end markers */
-      sortfn(t->items, n);      /* sort the items in the transaction */
-      if (dir < 0) int_reverse(t->items, n);
+      if (n <= TH_ITSORT) int_netsort(t->items, n);
+      else sortfn(t->items, n); /* sort the items in the transaction */
+      if (rng->dir < 0) int_reverse(t->items, n);
     }                           /* reverse the item order */
   }                             /* if the given direction is negative */
-}  /* tbg_itsort() */
+  return NULL;                  /* return a dummy result */
+}  /* tbg_srtrng() */
+
+/*--------------------------------------------------------------------*/
+
+void tbg_itsort (TABAG *bag, int dir, int heap)
+{ tbg_itsortpar(bag, dir, heap, 1); }
+                                /* --- sort items sequentially */
+
+/*--------------------------------------------------------------------*/
+
+void tbg_itsortpar (TABAG *bag, int dir, int heap, int nthd)
+{                               /* --- sort items in transactions */
+  TBGRANGE all;                 /* range of all transactions */
+
+  assert(bag);                  /* check the function arguments */
+  all.bag = bag;   all.map  = NULL;
+  all.dir = dir;   all.heap = heap;
+  tbg_rngall(bag, &all, nthd, tbg_srtrng);
+}  /* tbg_itsortpar() */        /* sort (possibly in parallel ranges) */
+
+/* The transactions are split into ranges of about equal size, one */
+/* per thread (with at least TH_RANGE transactions per range), and */
+/* each range is recoded or sorted by its own thread. Without the  */
+/* compile option TA_THREADS all transactions are processed as one */
+/* range, which is the same as the sequential version.             */
 
 /*--------------------------------------------------------------------*/
 
@@ -2469,6 +3097,219 @@ void taa_show (TRACT **taa, int n, ITEMBASE *base)
 }  /* taa_show() */
 
 #endif
+/*----------------------------------------------------------------------
+  Vertical Index Functions
+----------------------------------------------------------------------*/
+#ifndef __GNUC__
+
+int tix_bitcnt (unsigned int x)
+{                               /* --- count set bits in a word */
+  x = x -((x >> 1) & 0x55555555);
+  x = (x & 0x33333333) +((x >> 2) & 0x33333333);
+  x = (x +(x >> 4)) & 0x0f0f0f0f;
+  return (int)((x *0x01010101) >> 24);
+}  /* tix_bitcnt() */
+
+/*--------------------------------------------------------------------*/
+#endif
+
+static void tix_add (TIDIDX *idx, int item, int tid)
+{                               /* --- add a tid to an item's list */
+  unsigned int *b;              /* to access a bitmap */
+
+  int *d;                       /* to access a tid array */
+
+  if (!TIX_ISBMAP(idx, idx->sizes[item])) {
+    d = idx->tids[item];        /* if the item has a tid array, */
+    if ((idx->fill[item] <= 0) || (d[idx->fill[item]-1] != tid))
+      d[idx->fill[item]++] = tid;    /* store the transaction id */
+    return;                     /* (only once, the transaction may */
+  }                             /* contain the item several times) */
+  b = (unsigned int*)idx->tids[item];  /* set the bit */
+  b[tid >> 5] |= 1u << (tid & 31);     /* in the bitmap */
+}  /* tix_add() */
+
+/*--------------------------------------------------------------------*/
+
+TIDIDX* tix_create (TABAG *bag, int mode)
+{                               /* --- create a vertical index */
+  int          i, k, n;         /* loop variables, number of items */
+  int          max;             /* maximal transaction weight */
+  size_t       z;               /* size of the tid list memory */
+  TIDIDX       *idx;            /* created vertical index */
+  int          *c;              /* number of transactions per item */
+  int          *l;              /* last transaction per item */
+  const int    *s;              /* to traverse the transaction items */
+  const WITEM  *p;              /* to traverse the weighted items */
+  int          *d;              /* to traverse the tid list memory */
+  unsigned int *b;              /* to traverse the weight planes */
+
+  assert(bag && !(bag->mode & TA_PACKED));
+  n = ib_cnt(bag->base);        /* get the number of items */
+  c = (int*)malloc((size_t)(n+n) *sizeof(int));
+  if (!c) return NULL;          /* create the list size counters */
+  l = (int*)memset(c, 0, (size_t)(n+n) *sizeof(int)) +n;
+  for (max = 1, k = 0; k < bag->cnt; k++) {
+    if (bag->mode & IB_WEIGHTS) {  /* traverse the transactions */
+      i = ((WTRACT*)bag->tracts[k])->wgt;
+      for (p = ((WTRACT*)bag->tracts[k])->items; p->id >= 0; p++)
+        if (l[p->id] <= k) { l[p->id] = k+1; c[p->id]++; } }
+    else {                      /* count the transactions per item */
+      i = ((TRACT*)bag->tracts[k])->wgt;
+      for (s = ((TRACT*)bag->tracts[k])->items; *s > TA_END; s++)
+        if (l[*s] <= k) { l[*s] = k+1; c[*s]++; }
+    }                           /* (a sequence may contain an item */
+    if (i > max) max = i;       /* several times, count it once) */
+    if ((i < 0) && (mode & TIX_BITMAP)) { free(c); return NULL; }
+  }                             /* find the maximal weight */
+  idx = (TIDIDX*)malloc(sizeof(TIDIDX) +(size_t)(n-1) *sizeof(int*));
+  if (!idx) { free(c); return NULL; } /* create the base structure */
+  idx->bag   = bag;             /* note the underlying bag */
+  idx->cnt   = n;               /* and the number of items */
+  idx->tacnt = bag->cnt;        /* get the number of transactions */
+  idx->words = (bag->cnt +31) >> 5;
+  idx->dmin  = (mode & TIX_BITMAP) ? 0 : bag->cnt >> 5;
+  idx->unit  = -1;              /* compute the bitmap size */
+  for (idx->wpcnt = 0; (mode & TIX_BITMAP) && (max > 0); max >>= 1)
+    idx->wpcnt++;               /* count the weight planes */
+  z = (size_t)(n+n) +(size_t)(bag->cnt +bag->cnt +idx->words)
+    + (size_t)idx->wpcnt *(size_t)idx->words;
+  for (i = 0; i < n; i++)       /* compute the memory size */
+    z += (size_t)(TIX_ISBMAP(idx, c[i]) ? idx->words : c[i]);
+  idx->sizes = (int*)malloc(z *sizeof(int));
+  if (!idx->sizes) { free(idx); free(c); return NULL; }
+  memcpy(idx->sizes, c, n *sizeof(int));
+  idx->fill = (int*)memset(idx->sizes +n, 0, n *sizeof(int));
+  idx->wgts = idx->fill +n;     /* copy the list sizes and */
+  idx->buf  = idx->wgts +bag->cnt;   /* organize the memory */
+  d = idx->buf +bag->cnt +idx->words;
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    idx->tids[i] = d;           /* and set the list pointers */
+    if (!TIX_ISBMAP(idx, c[i])) d += c[i];
+    else { memset(d, 0, idx->words *sizeof(int)); d += idx->words; }
+  }                             /* clear the bitmaps */
+  free(c);                      /* delete the list size counters */
+  idx->wpls = (unsigned int*)memset(d, 0,
+                (size_t)idx->wpcnt *(size_t)idx->words *sizeof(int));
+  for (k = 0; k < bag->cnt; k++) { /* traverse the transactions */
+    if (bag->mode & IB_WEIGHTS) {  /* if weighted items */
+      idx->wgts[k] = ((WTRACT*)bag->tracts[k])->wgt;
+      for (p = ((WTRACT*)bag->tracts[k])->items; p->id >= 0; p++)
+        tix_add(idx, p->id, k); }
+    else {                      /* if standard transactions */
+      idx->wgts[k] = ((TRACT*)bag->tracts[k])->wgt;
+      for (s = ((TRACT*)bag->tracts[k])->items; *s > TA_END; s++)
+        tix_add(idx, *s, k);    /* store the transaction identifier */
+    }                           /* in the lists of its items */
+    if (idx->wgts[k] != 1) idx->unit = 0;
+    for (b = idx->wpls, i = 0; i < idx->wpcnt; b += idx->words, i++)
+      if (idx->wgts[k] & (1 << i)) b[k >> 5] |= 1u << (k & 31);
+  }                             /* set the weight plane bits */
+  return idx;                   /* return the created index */
+}  /* tix_create() */
+
+/*--------------------------------------------------------------------*/
+
+void tix_delete (TIDIDX *idx)
+{                               /* --- delete a vertical index */
+  assert(idx);                  /* check the function argument */
+  free(idx->sizes);             /* delete the tid list memory */
+  free(idx);                    /* and the base structure */
+}  /* tix_delete() */
+
+/*--------------------------------------------------------------------*/
+
+static int gallop (int *a, int n, const int *b, int m)
+{                               /* --- intersect two tid arrays */
+  int i, k, l, r, x, s;         /* loop variables, step width */
+
+  for (i = k = l = 0; (i < n) && (l < m); i++) {
+    for (s = 1, r = l; (r < m) && (b[r] < a[i]); s += s) {
+      l = r+1; r += s; }        /* gallop over smaller identifiers */
+    if (r > m) r = m;           /* and then find the position */
+    while (l < r) {             /* of the identifier a[i] */
+      x = (l+r) >> 1;           /* by a binary search */
+      if (b[x] < a[i]) l = x+1; else r = x; }
+    if ((l < m) && (b[l] == a[i]))
+      a[k++] = a[i];            /* collect common identifiers */
+  }                             /* (keep them in the first array) */
+  return k;                     /* return the number of identifiers */
+}  /* gallop() */
+
+/*--------------------------------------------------------------------*/
+
+static int isect (TIDIDX *idx, const int *sel, int n)
+{                               /* --- support from sorted items */
+  int          i, k, m, x;      /* loop variables, buffers */
+  const int    *c = idx->sizes; /* list sizes (number of trans.) */
+  unsigned int *a, *b;          /* to traverse the bitmaps */
+  int          *d;              /* to traverse the tid array */
+
+  if (TIX_ISBMAP(idx, c[sel[0]])) {   /* if all lists are bitmaps */
+    a = (unsigned int*)(idx->buf +idx->tacnt);
+    memcpy(a, idx->tids[sel[0]], idx->words *sizeof(int));
+    for (i = 1; i < n; i++) {   /* intersect all bitmaps */
+      b = (unsigned int*)idx->tids[sel[i]];
+      for (k = 0; k < idx->words; k++) a[k] &= b[k];
+    }                           /* (word-parallel intersection) */
+    if (idx->unit) {            /* if all transaction weights are 1, */
+      for (m = k = 0; k < idx->words; k++)
+        m += tix_bitcnt(a[k]);      /* simply count the set bits */
+      return m;                 /* in the intersection bitmap */
+    }
+    for (m = k = 0; k < idx->words; k++) {
+      for (x = k << 5; a[k]; x++, a[k] >>= 1)
+        if (a[k] & 1) m += idx->wgts[x];
+    }                           /* sum the transaction weights */
+    return m;                   /* for the bits in the intersection */
+  }
+  d = (int*)memcpy(idx->buf, idx->tids[sel[0]], c[sel[0]] *sizeof(int));
+  for (m = c[sel[0]], i = 1; (i < n) && (m > 0); i++) {
+    x = sel[i];                 /* traverse the remaining items */
+    if (!TIX_ISBMAP(idx, c[x])) /* if the item has a tid array, */
+      m = gallop(d, m, idx->tids[x], c[x]);     /* intersect */
+    else {                      /* if the item has a bitmap */
+      b = (unsigned int*)idx->tids[x];
+      for (k = x = 0; x < m; x++)
+        if (b[d[x] >> 5] & (1u << (d[x] & 31))) d[k++] = d[x];
+      m = k;                    /* filter the tids with the bitmap */
+    }                           /* and get the new number of tids */
+  }
+  if (idx->unit) return m;      /* if unit weights, return count */
+  for (k = 0; --m >= 0; )       /* otherwise sum the weights */
+    k += idx->wgts[d[m]];       /* of the transactions that */
+  return k;                     /* contain all items */
+}  /* isect() */
+
+/*--------------------------------------------------------------------*/
+
+int tix_supp (TIDIDX *idx, const int *items, int n)
+{                               /* --- support of an item set */
+  int       i, m, x;            /* loop variables, buffers */
+  int       buf[32];            /* buffer for a sorted item array */
+  int       *sel = buf;         /* items sorted by list size */
+  const int *c;                 /* list sizes (number of trans.) */
+
+  assert(idx && (items || (n <= 0)));
+  if (n <= 0) return tbg_wgt(idx->bag); /* empty set: total weight */
+  if ((n > 32)                  /* if the buffer is too small, */
+  &&  !(sel = (int*)malloc((size_t)n *sizeof(int))))
+    return -1;                  /* allocate an item array */
+  c = idx->sizes;               /* sort the items by list size */
+  for (m = 0; m < n; m++) {     /* (insertion sort, few items) */
+    if (((x = items[m]) < 0) || (x >= idx->cnt)) { m = 0; break; }
+    for (i = m; (--i >= 0) && (c[sel[i]] > c[x]); )
+      sel[i+1] = sel[i];        /* shift items with larger lists */
+    sel[i+1] = x;               /* store the item in the place */
+  }                             /* thus found */
+  if ((m <= 0) || (c[sel[0]] <= 0)) /* check items, smallest list */
+    m = 0;                      /* (the support is zero if an item */
+  else                          /* is unknown or never occurs) */
+    m = isect(idx, sel, n);     /* intersect the tid lists */
+  if (sel != buf) free(sel);    /* delete an allocated item array */
+  return m;                     /* return the item set support */
+}  /* tix_supp() */
+
 /*----------------------------------------------------------------------
   Transaction Tree Functions
 ----------------------------------------------------------------------*/
@@ -2812,6 +3653,9 @@ void tat_show (TATREE *tree)
 #ifndef NDEBUG                  /* if debug version */
   #undef  CLEANUP               /* clean up memory and close files */
   #define CLEANUP \
+  if (tidx)  tix_delete(tidx);      \
+  if (qrys)  { while (--nqry >= 0) ta_delete(qrys[nqry]); \
+               free(qrys); }        \
   if (tabag) tbg_delete(tabag, 0); \
   if (tread) trd_delete(tread, 1); \
   if (ibase) ib_delete (ibase);
@@ -2835,7 +3679,10 @@ int main (int argc, char *argv[])
   int     sort     = -2;        /* flag for item sorting and recoding */
   int     pack     =  0;        /* flag for packing 16 items */
   int     repeat   =  1;        /* number of repetitions */
+  int     queries  =  0;        /* number of support queries */
   int     mtar     =  0;        /* mode for transaction reading */
+  int     q[4];                 /* items of a support query */
+  long    s1, s2;               /* sums of query results */
   TRACT   **tracts = NULL;      /* array of transactions */
   clock_t t;                    /* timer for measurements */
 
@@ -2862,6 +3709,8 @@ int main (int argc, char *argv[])
     printf("-p       pack the 16 items with the lowest codes\n");
     printf("-x#      number of repetitions (for benchmarking) "
                     "(default: 1)\n");
+    printf("-Q#      number of random support queries         "
+                    "(default: 0)\n");
     printf("-w       integer transaction weight in last field "
                     "(default: only items)\n");
     printf("-r#      record/transaction separators            "
@@ -2889,6 +3738,7 @@ int main (int argc, char *argv[])
           case 'q': sort   = (int)strtol(s, &s, 0); break;
           case 'p': pack   = -1;                    break;
           case 'x': repeat = (int)strtol(s, &s, 0); break;
+          case 'Q': queries= (int)strtol(s, &s, 0); break;
           case 'w': mtar  |= TA_WEIGHT;             break;
           case 'r': optarg = &recseps;              break;
           case 'f': optarg = &fldseps;              break;
@@ -2962,6 +3812,48 @@ int main (int argc, char *argv[])
   free(tracts);                 /* delete the transaction buffer */
   MSG(stderr, "[%d", k); if (w != k) MSG(stderr, "/%d", w);
   MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
+  if (queries <= 0) { CLEANUP; SHOWMEM; return 0; }
+
+  /* --- build vertical index --- */
+  t = clock();                  /* start timer, print log message */
+  MSG(stderr, "building vertical index ... ");
+  if (pack) tbg_unpack(tabag,1);/* unpack the packed items */
+  tidx = tix_create(tabag, 0);     /* create a vertical index */
+  if (!tidx) error(E_NOMEM);    /* (tid lists per item) */
+  MSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
+
+  /* --- generate support queries --- */
+  qrys = (TRACT**)malloc(queries *sizeof(TRACT*));
+  if (!qrys) error(E_NOMEM);    /* create a query array */
+  srand(1);                     /* and fill it with random queries */
+  for (nqry = 0; nqry < queries; ) {
+    i = rand() % tbg_cnt(tabag);/* choose a random transaction */
+    n = ta_size(tbg_tract(tabag, i));
+    if (n <= 0) continue;       /* skip empty transactions */
+    k = 1 +rand() % 4;          /* select up to four items */
+    for (w = 0; w < k; w++)     /* from the chosen transaction */
+      q[w] = ta_items(tbg_tract(tabag, i))[rand() % n];
+    int_qsort(q, k);            /* sort the selected items and */
+    k = int_unique(q, k);       /* remove duplicate selections */
+    qrys[nqry] = ta_create(q, k, 1);
+    if (!qrys[nqry++]) { nqry--; error(E_NOMEM); }
+  }                             /* create a query transaction */
+
+  /* --- execute support queries --- */
+  t = clock();                  /* start timer, print log message */
+  MSG(stderr, "executing %d queries (scan) ... ", queries);
+  for (s1 = i = 0; i < queries; i++) {
+    for (k = 0; k < tbg_cnt(tabag); k++)
+      if (ta_subset(qrys[i], tbg_tract(tabag, k), 0) >= 0)
+        s1 += ta_wgt(tbg_tract(tabag, k));
+  }                             /* sum the support over all queries */
+  MSG(stderr, "[%ld] done [%.2fs].\n", s1, SEC_SINCE(t));
+  t = clock();                  /* start timer, print log message */
+  MSG(stderr, "executing %d queries (index) ... ", queries);
+  for (s2 = i = 0; i < queries; i++)
+    s2 += tix_supp(tidx, ta_items(qrys[i]), ta_size(qrys[i]));
+  MSG(stderr, "[%ld] done [%.2fs].\n", s2, SEC_SINCE(t));
+  if (s1 != s2) MSG(stderr, "warning: query results differ\n");
 
   /* --- clean up --- */
   CLEANUP;                      /* clean up memory and close files */
@@ -2970,3 +3862,111 @@ int main (int argc, char *argv[])
 }  /* main() */
 
 #endif
+
+/*----------------------------------------------------------------------
+  Main Function for Benchmarking
+----------------------------------------------------------------------*/
+#ifdef TRACT_BENCH
+
+#define SECONDS(t)  ((double)(clock()-(t)) /CLOCKS_PER_SEC)
+#define NTRACT      1024        /* number of test transactions */
+
+static unsigned int seed = 1;   /* state of random number generator */
+
+/*--------------------------------------------------------------------*/
+
+static int randint (int n)
+{                               /* --- xorshift random numbers */
+  seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+  return (int)(seed % (unsigned int)n);
+}  /* randint() */
+
+/*--------------------------------------------------------------------*/
+
+static int randset (int *items, int n, int range)
+{                               /* --- random sorted item set */
+  int i;                        /* loop variable */
+  for (i = 0; i < n; i++)       /* draw random items */
+    items[i] = randint(range);  /* from the given range */
+  int_qsort(items, n);          /* sort the items and */
+  return int_unique(items, n);  /* remove duplicates */
+}  /* randset() */
+
+/*--------------------------------------------------------------------*/
+
+static const char *names[] = { "scalar", "sse2", "avx2", "dispatch" };
+#ifdef TA_SIMD
+static SUBFN  *subs[]  = { subset,  subset4,  subset8,  ta_subset  };
+static SUBWFN *wsubs[] = { wsubset, wsubset4, wsubset8, wta_subset };
+#else
+static SUBFN  *subs[]  = { subset,  NULL, NULL, ta_subset  };
+static SUBWFN *wsubs[] = { wsubset, NULL, NULL, wta_subset };
+#endif
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- benchmark subset tests */
+  static const int sizes[] = { 10, 20, 50, 100, 200, 300, 0 };
+  int     i, k, n, m, r, v, c;  /* loop variables, sizes, counters */
+  int     z, w;                 /* size index, weighted flag */
+  long    res[4];               /* sums of test results */
+  int     items[300];           /* buffer for item sets */
+  TRACT   *dst[NTRACT], *src[NTRACT];   /* destinations and sources */
+  WTRACT  *wdst[NTRACT], *wsrc[NTRACT]; /* (plain/weighted items) */
+  clock_t t;                    /* timer for measurements */
+
+  if (argc > 1) seed = (unsigned int)strtol(argv[1], NULL, 0);
+  #ifdef TA_SIMD                /* check the vector instructions */
+  if (!__builtin_cpu_supports("avx2"))  /* (SSE2 is always */
+    subs[2] = NULL, wsubs[2] = NULL;    /* available if it is */
+  #endif                                /* enabled at compile time) */
+  printf("subset tests of %d transactions (sources: 4 or n/2 items, "
+         "half of them subsets)\n", NTRACT);
+  printf("items   src  weighted    %8s %8s %8s %8s\n",
+         names[0], (subs[1]) ? names[1] : "-",
+         (subs[2]) ? names[2] : "-", names[3]);
+  for (z = 0; (n = sizes[z]) > 0; z++) {
+    for (m = 4; m <= n/2; m = (m < n/2) ? n/2 : n) {
+      for (i = 0; i < NTRACT; i++) {
+        k = randset(items, n, 4*n);       /* create a destination */
+        dst[i]  = ta_create(items, k, 1); /* with up to n items */
+        wdst[i] = wta_create(k, 1);
+        for (c = 0; c < k; c++) wta_add(wdst[i], items[c], 1.0f);
+        if (i & 1) {            /* every other source is a subset */
+          for (c = 0; c < m; c++) items[c] = items[randint(k)];
+          k = m; int_qsort(items, k); k = int_unique(items, k); }
+        else                    /* the others are random item sets */
+          k = randset(items, m, 4*n);
+        src[i]  = ta_create(items, k, 1);
+        wsrc[i] = wta_create(k, 1);
+        for (c = 0; c < k; c++) wta_add(wsrc[i], items[c], 1.0f);
+        if (!dst[i] || !src[i] || !wdst[i] || !wsrc[i]) {
+          printf("not enough memory\n"); return -1; }
+      }                         /* create the test transactions */
+      r = (int)(4e8 /((double)NTRACT *n)) +1;
+      for (w = 0; w < 2; w++) { /* traverse plain and weighted items */
+        printf("%5d %5d  %-8s", n, m, (w) ? "yes" : "no");
+        for (v = 0; v < 4; v++) {
+          if (!subs[v]) { printf("   %6s", "-"); continue; }
+          t = clock(); res[v] = 0;  /* time the subset test variant */
+          for (c = 0; c < r; c++)
+            for (i = 0; i < NTRACT; i++)
+              res[v] += (w) ? wsubs[v](wsrc[i], wdst[i], 0)
+                            :  subs[v]( src[i],  dst[i], 0);
+          printf("   %5.2fs", SECONDS(t));
+          if (res[v] != res[0]) {
+            printf("\nresults differ (%s)\n", names[v]); return -1; }
+        }                       /* check for the same results */
+        printf("\n");           /* terminate the output line */
+      }
+      for (i = 0; i < NTRACT; i++) {
+        ta_delete(dst[i]);  ta_delete(src[i]);
+        wta_delete(wdst[i]); wta_delete(wsrc[i]);
+      }                         /* delete the test transactions */
+    }
+  }
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
@@ -81,10 +81,14 @@
 #define TA_WEIGHT   0x01        /* integer weight in last field */
 #define TA_DUPLICS  0x02        /* allow duplicates of items */
 #define TA_DUPERR   0x04        /* consider duplicates as errors */
+#define TA_MERGE    0x08        /* merge duplicate trans. on reading */
 #define TA_TERM     0x10        /* terminate all trans. with item 0 */
 #define TA_WGTSEP   TRD_OTHER   /* item weight separator */
 #define TA_PAREN    0x02        /* print parentheses around weight */
 
+/* --- vertical index modes --- */
+#define TIX_BITMAP  0x01        /* bitmaps for all items, w. planes */
+
 /* --- idempotent weight modes --- */
 #define TA_NOGAPS   0x40        /* do not allow gaps in matching */
 #define TA_ALLOCC   0x80        /* consider all occurrences */
@@ -181,6 +185,22 @@ typedef struct {                /* --- a transaction bag/multiset --- */
   int      *ifrqs;              /* frequency of the items (weight) */
 } TABAG;                        /* (transaction bag/multiset) */
 
+typedef struct {                /* --- a vertical (tid list) index --- */
+  TABAG    *bag;                /* underlying transaction bag */
+  int      cnt;                 /* number of items */
+  int      tacnt;               /* number of transactions */
+  int      words;               /* number of words per bitmap */
+  int      dmin;                /* minimal list size for a bitmap */
+  int      unit;                /* flag for unit transaction weights */
+  int      wpcnt;               /* number of weight planes */
+  unsigned int *wpls;           /* weight planes (bit slices) */
+  int      *sizes;              /* number of transactions per item */
+  int      *fill;               /* fill counters for tid arrays */
+  int      *wgts;               /* weights of the transactions */
+  int      *buf;                /* buffer for intersections */
+  int      *tids[1];            /* tid arrays or bitmaps per item */
+} TIDIDX;                       /* (vertical index) */
+
 #ifdef TATREEFN
 #ifdef TATCOMPACT
 
@@ -374,6 +394,8 @@ extern int          tbg_addib   (TABAG *bag);
 extern TRACT*       tbg_tract   (TABAG *bag, int index);
 extern WTRACT*      tbg_wtract  (TABAG *bag, int index);
 extern int          tbg_read    (TABAG *bag, TABREAD *trd, int mode);
+extern int          tbg_readpar (TABAG *bag, TABREAD *trd, int mode,
+                                 int nthd);
 extern const char*  tbg_errmsg  (TABAG *bag, char *buf, size_t size);
 #ifdef TA_WRITE
 extern int          tbg_write   (TABAG *bag, TABWRITE *twr,
@@ -382,11 +404,15 @@ extern int          tbg_write   (TABAG *bag, TABWRITE *twr,
 
 extern int          tbg_recode  (TABAG *bag, int min, int max,
                                  int cnt, int dir);
+extern int          tbg_recodepar(TABAG *bag, int min, int max,
+                                 int cnt, int dir, int nthd);
 extern void         tbg_filter  (TABAG *bag, int min,
                                  const int *marks, double wgt);
 extern void         tbg_trim    (TABAG *bag, int min,
                                  const int *marks, double wgt);
 extern void         tbg_itsort  (TABAG *bag, int dir, int heap);
+extern void         tbg_itsortpar(TABAG *bag, int dir, int heap,
+                                 int nthd);
 extern void         tbg_mirror  (TABAG *bag);
 extern void         tbg_sort    (TABAG *bag, int dir, int heap);
 extern void         tbg_sortsz  (TABAG *bag, int dir, int heap);
@@ -416,6 +442,17 @@ extern int          taa_reduce  (TRACT **taa, int n, int end,
 extern void         taa_show    (TRACT **taa, int n, ITEMBASE *base);
 #endif
 
+/*----------------------------------------------------------------------
+  Vertical Index Functions
+----------------------------------------------------------------------*/
+extern TIDIDX*      tix_create  (TABAG *bag, int mode);
+extern void         tix_delete  (TIDIDX *idx);
+extern TABAG*       tix_tabag   (const TIDIDX *idx);
+extern int          tix_supp    (TIDIDX *idx, const int *items, int n);
+#ifndef __GNUC__
+extern int          tix_bitcnt  (unsigned int x);
+#endif
+
 /*----------------------------------------------------------------------
   Transaction Node Functions
 ----------------------------------------------------------------------*/
@@ -520,6 +557,15 @@ extern void         tat_show    (TATREE *tree);
 
 #define taa_dstsize(n,x)  ((n) *sizeof(TRACT) +(x) *sizeof(int))
 
+/*--------------------------------------------------------------------*/
+#define tix_tabag(x)      ((x)->bag)
+#define TIX_ISBMAP(x,n)   ((n) >= (x)->dmin)
+#define tix_words(x)      ((x)->words)
+#define tix_bitmap(x,i)   ((const unsigned int*)(x)->tids[i])
+#ifdef __GNUC__                 /* count the set bits in a word */
+#define tix_bitcnt(x)     __builtin_popcount(x)
+#endif
+
 /*--------------------------------------------------------------------*/
 #ifdef TATREEFN
 #ifdef TATCOMPACT
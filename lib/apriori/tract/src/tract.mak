@@ -66,6 +66,13 @@ tatree.obj: tract.h $(UTILDIR)\symtab.h
 tatree.obj: tract.c tract.mak
 	$(CC) $(CFLAGS) $(INCS) /D NOMAIN /D TATREEFN tract.c /Fo$@
 
+#-----------------------------------------------------------------------
+# Binary Item Set File Reader
+#-----------------------------------------------------------------------
+repbin.obj:  repbin.h
+repbin.obj:  repbin.c tract.mak
+	$(CC) $(CFLAGS) $(INCS) /D NOMAIN repbin.c /Fo$@
+
 #-----------------------------------------------------------------------
 # Item Set Reporter Management
 #-----------------------------------------------------------------------
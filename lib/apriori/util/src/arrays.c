@@ -23,6 +23,8 @@
 ----------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <math.h>
 #include <assert.h>
 #include "arrays.h"
 
@@ -31,6 +33,9 @@
 ----------------------------------------------------------------------*/
 #define BUFSIZE     1024        /* size of fixed buffer for moving */
 #define TH_INSERT   16          /* threshold for insertion sort */
+#define TH_PDQINS   24          /* insertion sort threshold (pdqsort) */
+#define TH_NINTHER  128         /* threshold for pseudo-median of 9 */
+#define TH_PARTINS  8           /* max. moves in partial insert. sort */
 
 /*----------------------------------------------------------------------
   Functions for Arrays of Basic Data Types
@@ -276,6 +281,283 @@ HEAPSORT(dbl, double)
 
 /*--------------------------------------------------------------------*/
 
+#define PDQSORT(name,type) \
+static void name##_ins (type *array, int n, int guard)                 \
+{                               /* --- insertion sort for pdqsort */   \
+  type *l, *r, t;               /* to traverse the array, buffer */    \
+                                                                       \
+  for (r = array; ++r < array +n; ) {                                  \
+    t = *r;                     /* traverse the elements to insert */  \
+    if (guard)                  /* if at the start of the array */     \
+      for (l = r; (l > array) && (l[-1] > t); l--) *l = l[-1];         \
+    else                        /* if the predecessor of the array */  \
+      for (l = r; l[-1] > t; l--) *l = l[-1];  /* is a sentinel */     \
+    *l = t;                     /* shift greater elements right and */ \
+  }                             /* store the element in the gap */     \
+}  /* ins() */                                                        \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static int name##_partins (type *array, int n)                         \
+{                               /* --- partial insertion sort */       \
+  type *l, *r, t;               /* to traverse the array, buffer */    \
+  int  moves = 0;               /* number of moved elements */         \
+                                                                       \
+  for (r = array; ++r < array +n; ) {                                  \
+    if (!(r[-1] > *r)) continue;/* skip elements in proper order */    \
+    t = *r;                     /* note the element to insert */       \
+    for (l = r; (l > array) && (l[-1] > t); l--) *l = l[-1];           \
+    *l = t; moves += (int)(r-l);/* shift greater elements right */     \
+    if (moves > TH_PARTINS) return 0;                                  \
+  }                             /* abort if too many moves needed */   \
+  return 1;                     /* return that the array is sorted */  \
+}  /* partins() */                                                    \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static void name##_sort3 (type *a, type *b, type *c)                   \
+{                               /* --- sort three elements */          \
+  type t;                       /* exchange buffer */                  \
+  if (*b < *a) { t = *a; *a = *b; *b = t; }                            \
+  if (*c < *b) { t = *b; *b = *c; *c = t;                              \
+    if (*b < *a) { t = *a; *a = *b; *b = t; } }                        \
+}  /* sort3() */                                                      \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static int name##_right (type *array, int n, int *done)                \
+{                               /* --- partition, equal to the right */\
+  int  l = 0, r = n;            /* indices of exchange positions */    \
+  type x = array[0], t;         /* pivot element, exchange buffer */   \
+                                                                       \
+  while (array[++l] < x);       /* skip smaller elems. on the left */  \
+  if (l <= 1) while ((l < r) && !(array[--r] < x));                    \
+  else        while (           !(array[--r] < x));                    \
+  *done = (l >= r);             /* skip greater elems. on the right */ \
+  while (l < r) {               /* split and exchange loop */          \
+    t = array[l]; array[l] = array[r]; array[r] = t;                   \
+    while (  array[++l] < x);   /* exchange the elements and */        \
+    while (!(array[--r] < x));  /* skip elements that are */           \
+  }                             /* already in the right section */     \
+  array[0] = array[--l]; array[l] = x;                                 \
+  return l;                     /* move the pivot to its place */      \
+}  /* right() */                /* and return its position */         \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static int name##_left (type *array, int n)                            \
+{                               /* --- partition, equal to the left */ \
+  int  l = 0, r = n;            /* indices of exchange positions */    \
+  type x = array[0], t;         /* pivot element, exchange buffer */   \
+                                                                       \
+  while (x < array[--r]);       /* skip greater elems. on the right */ \
+  if (r+1 >= n) while ((l < r) && !(x < array[++l]));                  \
+  else          while (           !(x < array[++l]));                  \
+  while (l < r) {               /* split and exchange loop */          \
+    t = array[l]; array[l] = array[r]; array[r] = t;                   \
+    while (  x < array[--r]);   /* exchange the elements and */        \
+    while (!(x < array[++l]));  /* skip elements that are */           \
+  }                             /* already in the right section */     \
+  array[0] = array[r]; array[r] = x;                                   \
+  return r;                     /* move the pivot to its place */      \
+}  /* left() */                 /* and return its position */         \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static void name##_swap (type *array, int i, int k)                    \
+{ type t = array[i]; array[i] = array[k]; array[k] = t; }              \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+static void name##_pdqrec (type *array, int n, int bad, int lmost)     \
+{                               /* --- recursive part of pdqsort */    \
+  int  k, p;                    /* offset, position of pivot */        \
+  int  l, r;                    /* sizes of the two sections */        \
+  int  done;                    /* whether no exchange was needed */   \
+                                                                       \
+  while (n >= TH_PDQINS) {      /* sections sort loop */               \
+    k = n/2;                    /* choose a pivot: median of three */  \
+    if (n <= TH_NINTHER)        /* for smaller sections and */         \
+      name##_sort3(array+k, array, array+n-1);  /* pseudo-median */    \
+    else {                      /* of nine for larger sections */      \
+      name##_sort3(array,     array+k,   array+n-1);                   \
+      name##_sort3(array+1,   array+k-1, array+n-2);                   \
+      name##_sort3(array+2,   array+k+1, array+n-3);                   \
+      name##_sort3(array+k-1, array+k,   array+k+1);                   \
+      name##_swap(array, 0, k); /* move the pivot to the front */      \
+    }                                                                  \
+    if (!lmost && !(array[-1] < array[0])) {                           \
+      p = name##_left(array, n);/* if the pivot equals the preceding */\
+      array += p+1; n -= p+1;   /* pivot, put all equal elements to */ \
+      continue;                 /* the left and skip them, since */    \
+    }                           /* they need no further sorting */     \
+    p = name##_right(array, n, &done);                                 \
+    l = p; r = n-p-1;           /* partition the section */            \
+    if ((l < n/8) || (r < n/8)){/* if the partition is unbalanced */   \
+      if (--bad <= 0) {         /* if too many bad partitions, */      \
+        name##_heapsort(array, n); return; }  /* use heap sort */      \
+      if (l >= TH_PDQINS) {     /* break patterns in left section */   \
+        name##_swap(array, 0,   l/4);                                  \
+        name##_swap(array, p-1, p-l/4);                                \
+        if (l > TH_NINTHER) {   /* also the other ninther elements */  \
+          name##_swap(array, 1,   l/4+1);                              \
+          name##_swap(array, 2,   l/4+2);                              \
+          name##_swap(array, p-2, p-l/4-1);                            \
+          name##_swap(array, p-3, p-l/4-2);                            \
+        }                                                              \
+      }                                                                \
+      if (r >= TH_PDQINS) {     /* break patterns in right section */  \
+        name##_swap(array, p+1, p+1+r/4);                              \
+        name##_swap(array, n-1, n-r/4);                                \
+        if (r > TH_NINTHER) {   /* also the other ninther elements */  \
+          name##_swap(array, p+2, p+2+r/4);                            \
+          name##_swap(array, p+3, p+3+r/4);                            \
+          name##_swap(array, n-2, n-1-r/4);                            \
+          name##_swap(array, n-3, n-2-r/4);                            \
+        }                                                              \
+      } }                                                              \
+    else if (done               /* if the section was partitioned, */  \
+    &&  name##_partins(array,     l)      /* try to finish with */     \
+    &&  name##_partins(array+p+1, r))     /* insertion sort */         \
+      return;                   /* (works for almost sorted arrays) */ \
+    name##_pdqrec(array, l, bad, lmost); /* sort left recursively */   \
+    array += p+1; n = r; lmost = 0;      /* and loop for the right */  \
+  }                                                                    \
+  name##_ins(array, n, lmost);  /* sort the rest by insertion sort */  \
+}  /* pdqrec() */                                                     \
+                                                                       \
+/*------------------------------------------------------------------*/ \
+                                                                       \
+void name##_pdqsort (type *array, int n)                               \
+{                               /* --- pattern-defeating quicksort */  \
+  int bad;                      /* number of allowed bad partitions */ \
+                                                                       \
+  assert(array && (n >= 0));    /* check the function arguments */     \
+  if (n < 2) return;            /* do not sort less than two elems. */ \
+  for (bad = 0; n >> bad > 1; bad++);  /* compute log2(n) */           \
+  name##_pdqrec(array, n, bad, 1);     /* and sort recursively */      \
+}  /* pdqsort() */
+
+/*--------------------------------------------------------------------*/
+
+PDQSORT(sht, short)
+PDQSORT(int, int)
+PDQSORT(lng, long)
+PDQSORT(flt, float)
+PDQSORT(dbl, double)
+
+/* Pattern-defeating quicksort (after O. Peters) chooses the pivot   */
+/* as a median of three (or a pseudo-median of nine), detects already */
+/* partitioned (and thus often sorted) sections, collects runs of     */
+/* elements equal to a preceding pivot in a single step, and switches */
+/* to heap sort if too many unbalanced partitions are encountered,    */
+/* so that the worst case time complexity is O(n log n).              */
+
+/*--------------------------------------------------------------------*/
+
+static const unsigned char net4[][2] = {
+  {0,1}, {2,3}, {0,2}, {1,3}, {1,2} };
+static const unsigned char net8[][2] = {
+  {0,1}, {2,3}, {0,2}, {1,3}, {1,2}, {4,5}, {6,7}, {4,6}, {5,7},
+  {5,6}, {0,4}, {2,6}, {2,4}, {1,5}, {3,7}, {3,5}, {1,2}, {3,4},
+  {5,6} };
+static const unsigned char net16[][2] = {
+  {0,1}, {2,3}, {0,2}, {1,3}, {1,2}, {4,5}, {6,7}, {4,6}, {5,7},
+  {5,6}, {0,4}, {2,6}, {2,4}, {1,5}, {3,7}, {3,5}, {1,2}, {3,4},
+  {5,6}, {8,9}, {10,11}, {8,10}, {9,11}, {9,10}, {12,13}, {14,15},
+  {12,14}, {13,15}, {13,14}, {8,12}, {10,14}, {10,12}, {9,13},
+  {11,15}, {11,13}, {9,10}, {11,12}, {13,14}, {0,8}, {4,12}, {4,8},
+  {2,10}, {6,14}, {6,10}, {2,4}, {6,8}, {10,12}, {1,9}, {5,13},
+  {5,9}, {3,11}, {7,15}, {7,11}, {3,5}, {7,9}, {11,13}, {1,2}, {3,4},
+  {5,6}, {7,8}, {9,10}, {11,12}, {13,14} };
+
+/* The sorting networks are Batcher's odd-even merge sort networks */
+/* for 4, 8 and 16 elements (5, 19 and 63 comparators). Arrays with */
+/* fewer elements are padded with maximal elements.                 */
+
+/*--------------------------------------------------------------------*/
+
+#define NETSORT(name,type,max) \
+void name##_netsort (type *array, int n)                               \
+{                               /* --- sort with a sorting network */  \
+  int  i, k;                    /* loop variable, number of comps. */  \
+  const unsigned char (*c)[2];  /* comparators of the network */       \
+  type b[16], x, y;             /* padded buffer, comparison buffers */\
+                                                                       \
+  assert(array && (n >= 0) && (n <= 16)); /* check the arguments */    \
+  if (n < 2) return;            /* do not sort less than two elems. */ \
+  if      (n <= 4) { c = net4; k = (int)(sizeof(net4) /2); i =  4; }   \
+  else if (n <= 8) { c = net8; k = (int)(sizeof(net8) /2); i =  8; }   \
+  else        { c = net16; k = (int)(sizeof(net16)/2); i = 16; }       \
+  while (--i >= n) b[i] = max;  /* pad the buffer with max. elements */\
+  for ( ; i >= 0; i--) b[i] = array[i];  /* and copy the array */      \
+  for ( ; --k >= 0; c++) {      /* traverse the comparators */         \
+    x = b[(*c)[0]]; y = b[(*c)[1]];                                    \
+    b[(*c)[0]] = (y < x) ? y : x;   /* exchange the elements */        \
+    b[(*c)[1]] = (y < x) ? x : y;   /* without branching */            \
+  }                                                                    \
+  for (i = n; --i >= 0; ) array[i] = b[i];                             \
+}  /* netsort() */              /* copy the result to the array */
+
+/*--------------------------------------------------------------------*/
+
+NETSORT(sht, short,  SHRT_MAX)
+NETSORT(int, int,    INT_MAX)
+NETSORT(lng, long,   LONG_MAX)
+NETSORT(flt, float,  (float)HUGE_VAL)
+NETSORT(dbl, double, HUGE_VAL)
+
+/*--------------------------------------------------------------------*/
+
+#define RSORT(name,type,utype) \
+int name##_rsort (type *array, int n, type *buf)                       \
+{                               /* --- LSD radix sort (8 bit digits) */\
+  int   i, k, s, m, o;          /* loop variables, shift, offsets */   \
+  int   cnts[sizeof(type)][256];/* digit counters per byte position */ \
+  int   *c;                     /* to traverse the counters */         \
+  utype x, sgn;                 /* key with flipped sign bit */        \
+  type  *b, *src, *dst, *t;     /* buffer, source and destination */   \
+                                                                       \
+  assert(array && (n >= 0));    /* check the function arguments */     \
+  if (n < 2) return 0;          /* do not sort less than two elems. */ \
+  if (!(b = buf) && !(b = (type*)malloc((size_t)n *sizeof(type))))     \
+    return -1;                  /* allocate a buffer if not given */   \
+  memset(cnts, 0, sizeof(cnts));/* clear the digit counters */         \
+  sgn = (utype)1 << (sizeof(type)*CHAR_BIT-1);                         \
+  for (i = 0; i < n; i++) {     /* count all digits in one pass */     \
+    x = (utype)array[i] ^ sgn;  /* (flip the sign bit so that */       \
+    for (k = 0; k < (int)sizeof(type); k++) { /* negative numbers */   \
+      cnts[k][x & 0xff]++; x >>= 8; }         /* precede positive) */  \
+  }                                                                    \
+  src = array; dst = b;         /* traverse the byte positions */      \
+  for (k = 0; k < (int)sizeof(type); k++) {                            \
+    c = cnts[k]; s = k*8;       /* get the counters and the shift */   \
+    if (c[(((utype)src[0] ^ sgn) >> s) & 0xff] >= n)                   \
+      continue;                 /* skip digits that are all equal */   \
+    for (o = i = 0; i < 256; i++) {                                    \
+      m = c[i]; c[i] = o; o += m; }                                    \
+    for (i = 0; i < n; i++)     /* compute the bucket starts and */    \
+      dst[c[(((utype)src[i] ^ sgn) >> s) & 0xff]++] = src[i];          \
+    t = src; src = dst; dst = t;/* distribute the elements */          \
+  }                             /* into the buckets */                 \
+  if (src != array)             /* if the result is in the buffer, */  \
+    memcpy(array, src, (size_t)n *sizeof(type));  /* copy it back */   \
+  if (!buf) free(b);            /* delete an allocated buffer */       \
+  return 0;                     /* return 'ok' */                      \
+}  /* rsort() */
+
+/*--------------------------------------------------------------------*/
+
+RSORT(int, int,  unsigned int)
+RSORT(lng, long, unsigned long)
+
+/* The radix sort needs a buffer of the same size as the array and  */
+/* one counting pass over the array; byte positions in which all    */
+/* keys agree (e.g. the high bytes of item identifiers) are skipped */
+/* in the distribution passes.                                      */
+
+/*--------------------------------------------------------------------*/
+
 #define UNIQUE(name,type) \
 int name##_unique (type *array, int n) \
 {                               /* --- remove duplicate elements */    \
@@ -301,14 +583,16 @@ UNIQUE(dbl, double)
 #define BSEARCH(name,type) \
 int name##_bsearch (type key, const type *array, int n) \
 {                               /* --- do a binary search */           \
-  int l, r, m;                  /* array indices */                    \
+  int        l, h;              /* result index, half range size */    \
+  const type *p;                /* to traverse the array */            \
                                                                        \
   assert(array && (n >= 0));    /* check the function arguments */     \
-  for (l = 0, r = n; l < r; ) { /* while search range is not empty */  \
-    m = (l+r) /2;               /* compare the given key */            \
-    if (key > array[m]) l = m+1;/* to the middle element */            \
-    else                r = m;  /* adapt the search range */           \
-  }                             /* according to the result */          \
+  if (n <= 0) return -1;        /* check for an empty array */         \
+  for (p = array, l = n; l > 1; l -= h) {                              \
+    h = l >> 1;                 /* halve the search range and */       \
+    p = (p[h] < key) ? p+h : p; /* move the range start without */     \
+  }                             /* branching (conditional move) */     \
+  l = (int)(p -array) +((*p < key) ? 1 : 0);                           \
   return ((l >= n) || (key != array[l])) ? -1-l : l;                   \
 }  /* bsearch() */              /* return the (insertion) position */
 
@@ -320,6 +604,79 @@ BSEARCH(lng, long)
 BSEARCH(flt, float)
 BSEARCH(dbl, double)
 
+/*--------------------------------------------------------------------*/
+
+#define LSEARCH(name,type) \
+int name##_lsearch (type key, const type *array, int n) \
+{                               /* --- do a linear search */           \
+  int i, l;                     /* loop variable, result index */      \
+                                                                       \
+  assert(array && (n >= 0));    /* check the function arguments */     \
+  for (l = i = 0; i < n; i++)   /* count the smaller elements */       \
+    l += (array[i] < key) ? 1 : 0;   /* (vectorizable loop) */         \
+  return ((l >= n) || (key != array[l])) ? -1-l : l;                   \
+}  /* lsearch() */              /* return the (insertion) position */
+
+/*--------------------------------------------------------------------*/
+
+LSEARCH(sht, short)
+LSEARCH(int, int)
+LSEARCH(lng, long)
+LSEARCH(flt, float)
+LSEARCH(dbl, double)
+
+/* The binary search functions replace the comparison branches by a */
+/* conditional move of the range start, so that they do not suffer  */
+/* from branch mispredictions. The linear search functions have no  */
+/* early exit, so that the compiler can use SIMD instructions; they */
+/* are faster than a binary search for small arrays (up to about 32 */
+/* elements), since they need no data dependent memory accesses.    */
+
+/*--------------------------------------------------------------------*/
+
+static int eytz (int *eyt, int *rank, const int *array,
+                 int i, int k, int n)
+{                               /* --- build an Eytzinger layout */
+  if (k > n) return i;          /* if beyond the array, abort */
+  i = eytz(eyt, rank, array, i, k+k,   n);
+  eyt[k] = array[i];            /* fill the left subtree, */
+  if (rank) rank[k] = i;        /* then the current element, */
+  return eytz(eyt, rank, array, i+1, k+k+1, n);
+}  /* eytz() */                 /* finally the right subtree */
+
+/*--------------------------------------------------------------------*/
+
+void int_eytzinger (int *eyt, int *rank, const int *array, int n)
+{                               /* --- build an Eytzinger layout */
+  assert(eyt && array && (n >= 0));  /* check the function arguments */
+  eyt[0] = INT_MAX;             /* element 0 is not used, except as */
+  if (rank) rank[0] = n;        /* a marker for "no greater element" */
+  eytz(eyt, rank, array, 0, 1, n);
+}  /* int_eytzinger() */        /* build the layout recursively */
+
+/*--------------------------------------------------------------------*/
+
+int int_esearch (int key, const int *eyt, int n)
+{                               /* --- search in Eytzinger layout */
+  int k;                        /* index in the Eytzinger layout */
+
+  assert(eyt && (n >= 0));      /* check the function arguments */
+  for (k = 1; k <= n; )         /* descend in the implicit tree */
+    k = k+k +((eyt[k] < key) ? 1 : 0);
+  while (k & 1) k >>= 1;        /* remove the right turns below */
+  return k >> 1;                /* the lower bound and return */
+}  /* int_esearch() */          /* the index of the lower bound */
+
+/* In an Eytzinger layout the elements of a sorted array are stored */
+/* in breadth-first order of the implicit balanced search tree (the */
+/* children of the element at index k are at 2k and 2k+1), so that  */
+/* the first levels of the search share a few cache lines and the   */
+/* memory accesses are predictable. This pays for large arrays that */
+/* do not fit into the first level cache. int_esearch() returns the */
+/* layout index of the first element that is not less than the key */
+/* (0 if there is no such element); the optional rank array maps it */
+/* to the index in the sorted array.                                */
+
 /*----------------------------------------------------------------------
   Functions for Pointer Arrays
 ----------------------------------------------------------------------*/
@@ -520,6 +877,164 @@ void ptr_heapsort (void *array, int n, CMPFN *cmp, void *data)
 
 /*--------------------------------------------------------------------*/
 
+static void ins (void **array, int n, int guard, CMPFN *cmp, void *data)
+{                               /* --- insertion sort for pdqsort */
+  void **l, **r, *t;            /* to traverse the array, buffer */
+
+  for (r = array; ++r < array +n; ) {
+    t = *r;                     /* traverse the elements to insert */
+    if (guard)                  /* if at the start of the array */
+      for (l = r; (l > array) && (cmp(l[-1], t, data) > 0); l--)
+        *l = l[-1];             /* shift greater elements right */
+    else                        /* if predecessor is a sentinel */
+      for (l = r; cmp(l[-1], t, data) > 0; l--)
+        *l = l[-1];             /* shift greater elements right */
+    *l = t;                     /* store the element to insert */
+  }                             /* in the place thus found */
+}  /* ins() */
+
+/*--------------------------------------------------------------------*/
+
+static int partins (void **array, int n, CMPFN *cmp, void *data)
+{                               /* --- partial insertion sort */
+  void **l, **r, *t;            /* to traverse the array, buffer */
+  int  moves = 0;               /* number of moved elements */
+
+  for (r = array; ++r < array +n; ) {
+    if (cmp(r[-1], *r, data) <= 0)
+      continue;                 /* skip elements in proper order */
+    t = *r;                     /* note the element to insert */
+    for (l = r; (l > array) && (cmp(l[-1], t, data) > 0); l--)
+      *l = l[-1];               /* shift greater elements right */
+    *l = t; moves += (int)(r-l);/* and store the element */
+    if (moves > TH_PARTINS) return 0;
+  }                             /* abort if too many moves needed */
+  return 1;                     /* return that the array is sorted */
+}  /* partins() */
+
+/*--------------------------------------------------------------------*/
+
+static void sort3 (void **a, void **b, void **c, CMPFN *cmp, void *data)
+{                               /* --- sort three elements */
+  void *t;                      /* exchange buffer */
+  if (cmp(*b, *a, data) < 0) { t = *a; *a = *b; *b = t; }
+  if (cmp(*c, *b, data) < 0) { t = *b; *b = *c; *c = t;
+    if (cmp(*b, *a, data) < 0) { t = *a; *a = *b; *b = t; } }
+}  /* sort3() */
+
+/*--------------------------------------------------------------------*/
+
+static int right (void **array, int n, int *done,
+                  CMPFN *cmp, void *data)
+{                               /* --- partition, equal to the right */
+  int  l = 0, r = n;            /* indices of exchange positions */
+  void *x = array[0], *t;       /* pivot element, exchange buffer */
+
+  while (cmp(array[++l], x, data) < 0)
+    ;                           /* skip smaller elems. on the left */
+  if (l <= 1) while ((l < r) && (cmp(array[--r], x, data) >= 0));
+  else        while (            cmp(array[--r], x, data) >= 0);
+  *done = (l >= r);             /* skip greater elems. on the right */
+  while (l < r) {               /* split and exchange loop */
+    t = array[l]; array[l] = array[r]; array[r] = t;
+    while (cmp(array[++l], x, data) <  0);  /* exchange elements */
+    while (cmp(array[--r], x, data) >= 0);  /* and skip elements */
+  }                             /* already in the right section */
+  array[0] = array[--l]; array[l] = x;
+  return l;                     /* move the pivot to its place */
+}  /* right() */                /* and return its position */
+
+/*--------------------------------------------------------------------*/
+
+static int left (void **array, int n, CMPFN *cmp, void *data)
+{                               /* --- partition, equal to the left */
+  int  l = 0, r = n;            /* indices of exchange positions */
+  void *x = array[0], *t;       /* pivot element, exchange buffer */
+
+  while (cmp(x, array[--r], data) < 0)
+    ;                           /* skip greater elems. on the right */
+  if (r+1 >= n) while ((l < r) && (cmp(x, array[++l], data) >= 0));
+  else          while (            cmp(x, array[++l], data) >= 0);
+  while (l < r) {               /* split and exchange loop */
+    t = array[l]; array[l] = array[r]; array[r] = t;
+    while (cmp(x, array[--r], data) <  0);  /* exchange elements */
+    while (cmp(x, array[++l], data) >= 0);  /* and skip elements */
+  }                             /* already in the right section */
+  array[0] = array[r]; array[r] = x;
+  return r;                     /* move the pivot to its place */
+}  /* left() */                 /* and return its position */
+
+/*--------------------------------------------------------------------*/
+
+static void swap (void **array, int i, int k)
+{ void *t = array[i]; array[i] = array[k]; array[k] = t; }
+
+/*--------------------------------------------------------------------*/
+
+static void pdqrec (void **array, int n, int bad, int lmost,
+                    CMPFN *cmp, void *data)
+{                               /* --- recursive part of pdqsort */
+  int  k, p;                    /* offset, position of pivot */
+  int  l, r;                    /* sizes of the two sections */
+  int  done;                    /* whether no exchange was needed */
+
+  while (n >= TH_PDQINS) {      /* sections sort loop */
+    k = n/2;                    /* choose a pivot: median of three */
+    if (n <= TH_NINTHER)        /* for smaller sections */
+      sort3(array+k, array, array+n-1, cmp, data);
+    else {                      /* pseudo-median of nine otherwise */
+      sort3(array,     array+k,   array+n-1, cmp, data);
+      sort3(array+1,   array+k-1, array+n-2, cmp, data);
+      sort3(array+2,   array+k+1, array+n-3, cmp, data);
+      sort3(array+k-1, array+k,   array+k+1, cmp, data);
+      swap(array, 0, k);        /* move the pivot to the front */
+    }
+    if (!lmost && (cmp(array[-1], array[0], data) >= 0)) {
+      p = left(array, n, cmp, data);  /* if the pivot equals the */
+      array += p+1; n -= p+1;   /* preceding pivot, put all equal */
+      continue;                 /* elements to the left and skip */
+    }                           /* them (they need no sorting) */
+    p = right(array, n, &done, cmp, data);
+    l = p; r = n-p-1;           /* partition the section */
+    if ((l < n/8) || (r < n/8)){/* if the partition is unbalanced */
+      if (--bad <= 0) {         /* if too many bad partitions, */
+        ptr_heapsort(array, n, cmp, data); return; }  /* heap sort */
+      if (l >= TH_PDQINS) {     /* break patterns in left section */
+        swap(array, 0,   l/4);   swap(array, p-1, p-l/4);
+        if (l > TH_NINTHER) {   /* also the other ninther elements */
+          swap(array, 1,   l/4+1);   swap(array, 2,   l/4+2);
+          swap(array, p-2, p-l/4-1); swap(array, p-3, p-l/4-2); }
+      }
+      if (r >= TH_PDQINS) {     /* break patterns in right section */
+        swap(array, p+1, p+1+r/4); swap(array, n-1, n-r/4);
+        if (r > TH_NINTHER) {   /* also the other ninther elements */
+          swap(array, p+2, p+2+r/4); swap(array, p+3, p+3+r/4);
+          swap(array, n-2, n-1-r/4); swap(array, n-3, n-2-r/4); }
+      } }
+    else if (done               /* if the section was partitioned, */
+    &&  partins(array,     l, cmp, data)  /* try to finish with */
+    &&  partins(array+p+1, r, cmp, data)) /* insertion sort */
+      return;                   /* (works for almost sorted arrays) */
+    pdqrec(array, l, bad, lmost, cmp, data);   /* sort left section */
+    array += p+1; n = r; lmost = 0;  /* and loop for the right one */
+  }
+  ins(array, n, lmost, cmp, data);  /* sort the rest by insertion */
+}  /* pdqrec() */
+
+/*--------------------------------------------------------------------*/
+
+void ptr_pdqsort (void *array, int n, CMPFN *cmp, void *data)
+{                               /* --- pattern-defeating quicksort */
+  int bad;                      /* number of allowed bad partitions */
+
+  assert(array && (n >= 0) && cmp); /* check the function arguments */
+  if (n < 2) return;            /* do not sort less than two elements */
+  for (bad = 0; n >> bad > 1; bad++);  /* compute log2(n) */
+  pdqrec((void**)array, n, bad, 1, cmp, data);  /* sort recursively */
+}  /* ptr_pdqsort() */
+
+/*--------------------------------------------------------------------*/
+
 static void mrgsort (void **array, void **buf, int n,
                      CMPFN *cmp, void *data)
 {                               /* --- merge sort for pointer arrays */
@@ -583,7 +1098,7 @@ int ptr_mrgsort (void *array, int n, CMPFN *cmp, void *data, void *buf)
   if (n < 2) return 0;          /* do not sort less than two objects */
   if (!(b = (void**)buf) && !(b = (void**)malloc(n *sizeof(void*))))
     return -1;                  /* allocate a buffer if not given */
-  mrgsort(array, buf, n, cmp, data);
+  mrgsort(array, b,   n, cmp, data);
   if (!buf) free(b);            /* sort the array recursively */
   return 0;                     /* return 'ok' */
 }  /* ptr_mrgsort() */
@@ -1040,3 +1555,179 @@ int main (int argc, char *argv[])
 }  /* main() */
 
 #endif
+
+/*----------------------------------------------------------------------
+  Main Function for Benchmarking
+----------------------------------------------------------------------*/
+#ifdef ARRAYS_BENCH
+#include <time.h>
+
+#define SECONDS(t)  ((double)(clock()-(t)) /CLOCKS_PER_SEC)
+
+typedef void SORTFN (int *array, int n);
+
+static unsigned int seed = 1;   /* state of random number generator */
+
+/*--------------------------------------------------------------------*/
+
+static int randint (int n)
+{                               /* --- xorshift random numbers */
+  seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+  return (int)(seed % (unsigned int)n);
+}  /* randint() */
+
+/*--------------------------------------------------------------------*/
+
+static int numcmp (const void *p1, const void *p2, void *data)
+{                               /* --- compare integers via pointers */
+  int a = *(const int*)p1, b = *(const int*)p2;
+  return (a > b) - (a < b);     /* compare the referenced numbers */
+}  /* numcmp() */
+
+/*--------------------------------------------------------------------*/
+
+static void rsort (int *array, int n)
+{ int_rsort(array, n, NULL); }
+
+static void hybrid (int *array, int n)
+{ if (n <= 16) int_netsort(array, n); else int_pdqsort(array, n); }
+
+static void inssort (int *array, int n)
+{                               /* --- plain insertion sort */
+  int i, k, x;                  /* (as used for transactions) */
+  for (i = 1; i < n; i++) {
+    x = array[k = i];
+    while ((k > 0) && (array[k-1] > x)) { array[k] = array[k-1]; k--; }
+    array[k] = x;
+  }
+}  /* inssort() */
+
+static const char *names[] = { "qsort", "heapsort", "pdqsort",
+  "rsort", "inssort", "netsort", "hybrid" };
+static SORTFN *sorts[] = { int_qsort, int_heapsort, int_pdqsort,
+  rsort, inssort, int_netsort, hybrid };
+
+/*--------------------------------------------------------------------*/
+
+static void fill (int *array, int n, int pat, int range)
+{                               /* --- fill an array with a pattern */
+  int i;                        /* loop variable */
+  for (i = 0; i < n; i++) {     /* traverse the array elements */
+    switch (pat) {              /* evaluate the pattern */
+      case 1:  array[i] = i;                      break;
+      case 2:  array[i] = n-i;                    break;
+      case 3:  array[i] = randint(16);            break;
+      case 4:  array[i] = (i < n/2) ? i : n-i;    break;
+      case 5:  array[i] = (randint(100) < 2) ? randint(n) : i; break;
+      default: array[i] = randint(range) -range/4; break;
+    }                           /* random, sorted, reversed, */
+  }                             /* few distinct, organ pipe, */
+}  /* fill() */                 /* almost sorted */
+
+/*--------------------------------------------------------------------*/
+
+static int check (const int *array, const int *ref, int n)
+{                               /* --- check a sorted array */
+  return memcmp(array, ref, (size_t)n *sizeof(int)) == 0;
+}  /* check() */
+
+/*--------------------------------------------------------------------*/
+
+static void many (const char *title, int total, int min, int max,
+                  int range, int first, int last)
+{                               /* --- benchmark many small arrays */
+  int     i, k, n, m;           /* loop variables, array sizes */
+  int     *data, *work, *ref;   /* data, work and reference arrays */
+  int     *sizes;               /* sizes of the individual arrays */
+  clock_t t;                    /* timer for measurements */
+
+  m = total /((min+max)/2) +1;  /* estimate the number of arrays */
+  sizes = (int*)malloc((size_t)m *sizeof(int));
+  data  = (int*)malloc((size_t)(3*total+3*max) *sizeof(int));
+  if (!sizes || !data) { fprintf(stderr, "out of memory\n"); exit(1); }
+  work = data +total +max; ref = work +total +max;
+  for (n = i = 0; (i < m) && (n < total); i++) {
+    sizes[i] = k = min +randint(max-min+1);
+    fill(data+n, k, 0, range); n += k;
+  }                             /* generate the arrays to sort */
+  m = i; memcpy(ref, data, (size_t)n *sizeof(int));
+  for (n = i = 0; i < m; n += sizes[i++])
+    int_heapsort(ref+n, sizes[i]);  /* compute the reference result */
+  printf("%-24s", title);       /* print the benchmark title */
+  for (k = first; k <= last; k++) {
+    memcpy(work, data, (size_t)n *sizeof(int));
+    t = clock();                /* traverse the sort functions */
+    for (n = i = 0; i < m; n += sizes[i++])
+      sorts[k](work+n, sizes[i]);
+    printf(" %s %.3f%s", names[k], SECONDS(t),
+           check(work, ref, n) ? "" : "(!)");
+  }                             /* sort all arrays and */
+  printf("\n");                 /* print the execution times */
+  free(data); free(sizes);      /* deallocate the work memory */
+}  /* many() */
+
+/*--------------------------------------------------------------------*/
+
+static void large (int n, int pat)
+{                               /* --- benchmark a large array */
+  static const char *pats[] = { "random", "sorted", "reversed",
+    "few distinct", "organ pipe", "almost sorted" };
+  int     i, k;                 /* loop variable, sort function */
+  int     *data, *work, *ref;   /* data, work and reference arrays */
+  void    **ptrs;               /* pointer array for pointer sorts */
+  clock_t t;                    /* timer for measurements */
+
+  data = (int*)malloc((size_t)(3*n) *sizeof(int));
+  ptrs = (void**)malloc((size_t)n *sizeof(void*));
+  if (!data || !ptrs) { fprintf(stderr, "out of memory\n"); exit(1); }
+  work = data +n; ref = work +n;/* get the work and reference arrays */
+  fill(data, n, pat, n);        /* fill the array with the pattern */
+  memcpy(ref, data, (size_t)n *sizeof(int));
+  int_heapsort(ref, n);         /* compute the reference result */
+  printf("%-13s %9d  ", pats[pat], n);
+  for (k = 0; k <= 3; k++) {    /* traverse the sort functions */
+    memcpy(work, data, (size_t)n *sizeof(int));
+    t = clock(); sorts[k](work, n);
+    printf(" %s %.3f%s", names[k], SECONDS(t),
+           check(work, ref, n) ? "" : "(!)");
+  }                             /* sort and print execution times */
+  for (k = 0; k < 3; k++) {     /* traverse the pointer sorts */
+    for (i = 0; i < n; i++) ptrs[i] = data +i;
+    t = clock();                /* sort pointers to the numbers */
+    if      (k == 0) ptr_qsort  (ptrs, n, numcmp, NULL);
+    else if (k == 1) ptr_pdqsort(ptrs, n, numcmp, NULL);
+    else             ptr_mrgsort(ptrs, n, numcmp, NULL, NULL);
+    printf(" %s %.3f", (k == 0) ? "ptr_qsort" : (k == 1)
+           ? "ptr_pdqsort" : "ptr_mrgsort", SECONDS(t));
+    for (i = 0; i < n; i++) work[i] = *(int*)ptrs[i];
+    if (!check(work, ref, n)) printf("(!)");
+  }                             /* check the sorted pointers */
+  printf("\n");                 /* terminate the output line */
+  free(ptrs); free(data);       /* deallocate the work memory */
+}  /* large() */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- benchmark sorting functions */
+  int n = 10000000;             /* total number of elements */
+  int p;                        /* loop variable for patterns */
+
+  if (argc > 1) n    = atoi(argv[1]);
+  if (argc > 2) seed = (unsigned int)atoi(argv[2]);
+  if ((n <= 0) || (seed == 0)) {
+    printf("usage: %s [n [seed]]\n", argv[0]); return -1; }
+  printf("arrays with 2..16 elements (filtered transactions):\n");
+  many("item ids < 1000",   n, 2, 16, 1000, 0, 6);
+  many("item ids < 100000", n, 2, 16, 100000, 0, 6);
+  printf("arrays with 2..64 elements (raw transactions):\n");
+  many("item ids < 1000",   n, 2, 64, 1000, 0, 4);
+  printf("arrays with 17..256 elements (dense transactions):\n");
+  many("item ids < 1000",   n, 17, 256, 1000, 0, 3);
+  printf("large arrays (item frequencies, report sorting):\n");
+  for (p = 0; p < 6; p++) large(n/10, p);
+  large(n, 0);                  /* benchmark different patterns */
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
@@ -31,8 +31,11 @@ extern void sht_shuffle  (short  *array, int n,        RANDFN *rand);
 extern void sht_reverse  (short  *array, int n);
 extern void sht_qsort    (short  *array, int n);
 extern void sht_heapsort (short  *array, int n);
+extern void sht_pdqsort  (short  *array, int n);
+extern void sht_netsort  (short  *array, int n);
 extern int  sht_unique   (short  *array, int n);
 extern int  sht_bsearch  (short  key, const short *array, int n);
+extern int  sht_lsearch  (short  key, const short *array, int n);
 
 /*--------------------------------------------------------------------*/
 
@@ -44,8 +47,15 @@ extern void int_shuffle  (int    *array, int n,        RANDFN *rand);
 extern void int_reverse  (int    *array, int n);
 extern void int_qsort    (int    *array, int n);
 extern void int_heapsort (int    *array, int n);
+extern void int_pdqsort  (int    *array, int n);
+extern void int_netsort  (int    *array, int n);
+extern int  int_rsort    (int    *array, int n, int *buf);
 extern int  int_unique   (int    *array, int n);
 extern int  int_bsearch  (int    key, const int *array, int n);
+extern int  int_lsearch  (int    key, const int *array, int n);
+extern void int_eytzinger (int *eyt, int *rank,
+                           const int *array, int n);
+extern int  int_esearch  (int    key, const int *eyt, int n);
 
 /*--------------------------------------------------------------------*/
 
@@ -57,8 +67,12 @@ extern void lng_shuffle  (long   *array, int n,        RANDFN *rand);
 extern void lng_reverse  (long   *array, int n);
 extern void lng_qsort    (long   *array, int n);
 extern void lng_heapsort (long   *array, int n);
+extern void lng_pdqsort  (long   *array, int n);
+extern void lng_netsort  (long   *array, int n);
+extern int  lng_rsort    (long   *array, int n, long *buf);
 extern int  lng_unique   (long   *array, int n);
 extern int  lng_bsearch  (long   key, const long *array, int n);
+extern int  lng_lsearch  (long   key, const long *array, int n);
 
 /*--------------------------------------------------------------------*/
 
@@ -70,8 +84,11 @@ extern void flt_shuffle  (float  *array, int n,        RANDFN *rand);
 extern void flt_reverse  (float  *array, int n);
 extern void flt_qsort    (float  *array, int n);
 extern void flt_heapsort (float  *array, int n);
+extern void flt_pdqsort  (float  *array, int n);
+extern void flt_netsort  (float  *array, int n);
 extern int  flt_unique   (float  *array, int n);
 extern int  flt_bsearch  (float  key, const float *array, int n);
+extern int  flt_lsearch  (float  key, const float *array, int n);
 
 /*--------------------------------------------------------------------*/
 
@@ -83,8 +100,11 @@ extern void dbl_shuffle  (double *array, int n,        RANDFN *rand);
 extern void dbl_reverse  (double *array, int n);
 extern void dbl_qsort    (double *array, int n);
 extern void dbl_heapsort (double *array, int n);
+extern void dbl_pdqsort  (double *array, int n);
+extern void dbl_netsort  (double *array, int n);
 extern int  dbl_unique   (double *array, int n);
 extern int  dbl_bsearch  (double key, const double *array, int n);
+extern int  dbl_lsearch  (double key, const double *array, int n);
 
 /*----------------------------------------------------------------------
   Functions for Pointer Arrays
@@ -97,6 +117,7 @@ extern void ptr_shuffle  (void *array, int n,        RANDFN *rand);
 extern void ptr_reverse  (void *array, int n);
 extern void ptr_qsort    (void *array, int n, CMPFN *cmp, void *data);
 extern void ptr_heapsort (void *array, int n, CMPFN *cmp, void *data);
+extern void ptr_pdqsort  (void *array, int n, CMPFN *cmp, void *data);
 extern int  ptr_mrgsort  (void *array, int n, CMPFN *cmp, void *data,
                           void *buf);
 extern int  ptr_bsearch  (const void *key, const
@@ -0,0 +1,320 @@
+/*----------------------------------------------------------------------
+  File    : cidmap.c
+  Contents: concurrent (sharded) key/identifier map management
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "arrays.h"
+#include "cidmap.h"
+#ifdef CIM_MAIN
+#include <time.h>
+#include "tabread.h"
+#endif
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- key/identifier map entry --- */
+  int    id;                    /* local identifier (in shard) */
+  int    shd;                   /* index of the shard */
+  double ord;                   /* ordering value (e.g. position) */
+} CIMENT;                       /* (key/identifier map entry) */
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static int shard (CIDMAP *cim, const void *key)
+{                               /* --- get the shard for a key */
+  unsigned int h;               /* hash value of the key */
+
+  if (cim->bits <= 0) return 0; /* check for a single shard */
+  h = cim->hashfn(key, 0) *0x9e3779b1U;
+  return (int)((h & 0xffffffffU) >> (32 -cim->bits));
+}  /* shard() */                /* use the high bits of the product */
+
+/* The shard is selected with the high bits of a multiplicative  */
+/* hash, because the identifier map of the shard uses the low bits */
+/* of the same hash value to select a hash bin or slot.            */
+
+/*--------------------------------------------------------------------*/
+
+static int entcmp (const void *p1, const void *p2, void *data)
+{                               /* --- compare two map entries */
+  const CIMENT *a = (const CIMENT*)p1;  /* entries to compare */
+  const CIMENT *b = (const CIMENT*)p2;
+  CIDMAP       *cim = (CIDMAP*)data;    /* concurrent id map */
+
+  if (a->ord < b->ord) return -1; /* compare the ordering values */
+  if (a->ord > b->ord) return +1; /* and break ties by the keys */
+  return cim->cmpfn(idm_key(a), idm_key(b), cim->data);
+}  /* entcmp() */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+CIDMAP* cim_create (int shards, int init, HASHFN hashfn,
+                    CMPFN cmpfn, void *data)
+{                               /* --- create a concurrent id map */
+  int    i, n, b;               /* loop variable, number of shards */
+  CIDMAP *cim;                  /* created concurrent id map */
+  CIMSHD *shd;                  /* to traverse the shards */
+
+  if (shards > CIM_MAXSHD) shards = CIM_MAXSHD;
+  for (n = 1, b = 0; n < shards; b++)
+    n <<= 1;                    /* number of shards is a power of 2 */
+  cim = (CIDMAP*)malloc(sizeof(CIDMAP) +(size_t)(n-1) *sizeof(CIMSHD));
+  if (!cim) return NULL;        /* allocate the base structure */
+  cim->cnt    = n;              /* and initialize the fields */
+  cim->bits   = b;
+  cim->hashfn = (hashfn) ? hashfn : st_strhash;
+  cim->cmpfn  = (cmpfn)  ? cmpfn  : st_strcmp;
+  cim->data   = data;
+  cim->total  = cim->size = 0;
+  cim->keys   = NULL;           /* there are no global ids yet */
+  if (init > 0) init = (init +n-1) /n;
+  for (i = 0; i < n; i++) {     /* traverse the shards */
+    shd = cim->shds +i;         /* and create their id maps */
+    shd->idm = idm_create(init, 0, cim->hashfn, cim->cmpfn, data,
+                          (OBJFN*)0);
+    if (!shd->idm) break;       /* (each shard is a sequential */
+    pthread_mutex_init(&shd->lock, NULL);  /* id map with a lock) */
+    shd->num  = shd->gsize = 0;
+    shd->gids = NULL;           /* there are no global ids yet */
+  }
+  if (i >= n) return cim;       /* if all shards were created, */
+  cim->cnt = i;                 /* return the created id map, */
+  cim_delete(cim);              /* otherwise delete the shards */
+  return NULL;                  /* created so far and abort */
+}  /* cim_create() */
+
+/*--------------------------------------------------------------------*/
+
+void cim_delete (CIDMAP *cim)
+{                               /* --- delete a concurrent id map */
+  int i;                        /* loop variable */
+
+  assert(cim);                  /* check the function argument */
+  for (i = 0; i < cim->cnt; i++) {
+    idm_delete(cim->shds[i].idm);
+    pthread_mutex_destroy(&cim->shds[i].lock);
+    if (cim->shds[i].gids) free(cim->shds[i].gids);
+  }                             /* delete the shards */
+  if (cim->keys) free((void*)cim->keys);
+  free(cim);                    /* delete the key array */
+}  /* cim_delete() */           /* and the base structure */
+
+/*--------------------------------------------------------------------*/
+
+int cim_add (CIDMAP *cim, const void *key, size_t keysize, double ord)
+{                               /* --- add a key (thread-safe) */
+  int    s, id;                 /* index of shard, local id */
+  CIMSHD *shd;                  /* shard the key belongs to */
+  CIMENT *e;                    /* entry for the key */
+
+  assert(cim && key);           /* check the function arguments */
+  shd = cim->shds +(s = shard(cim, key));
+  pthread_mutex_lock(&shd->lock);
+  e = (CIMENT*)idm_bykey(shd->idm, key);
+  if (!e) {                     /* if the key is new, add it */
+    e = (CIMENT*)idm_add(shd->idm, key, keysize, sizeof(CIMENT));
+    if (!e) { pthread_mutex_unlock(&shd->lock); return -1; }
+    e->shd = s; e->ord = ord; } /* note the shard and the order */
+  else if (ord < e->ord)        /* if the key exists, */
+    e->ord = ord;               /* keep the smallest ordering value */
+  id = e->id;                   /* get the local identifier */
+  pthread_mutex_unlock(&shd->lock);
+  return (id << cim->bits) | s; /* return the provisional id */
+}  /* cim_add() */
+
+/* A provisional identifier combines the local identifier in the    */
+/* shard with the shard index. It is stable, but not dense, and is   */
+/* mapped to a dense global identifier by cim_number() and then     */
+/* cim_global(). Only the shard a key belongs to is locked, so that */
+/* threads adding keys of different shards do not wait for each    */
+/* other.                                                           */
+
+/*--------------------------------------------------------------------*/
+
+int cim_getid (CIDMAP *cim, const void *key)
+{                               /* --- get a provisional id */
+  int    s, id = -1;            /* index of shard, local id */
+  CIMSHD *shd;                  /* shard the key belongs to */
+  CIMENT *e;                    /* entry for the key */
+
+  assert(cim && key);           /* check the function arguments */
+  shd = cim->shds +(s = shard(cim, key));
+  pthread_mutex_lock(&shd->lock);
+  e = (CIMENT*)idm_bykey(shd->idm, key);
+  if (e) id = (e->id << cim->bits) | s;
+  pthread_mutex_unlock(&shd->lock);
+  return id;                    /* return the provisional id */
+}  /* cim_getid() */            /* or -1 if the key does not exist */
+
+/*--------------------------------------------------------------------*/
+
+int cim_number (CIDMAP *cim)
+{                               /* --- assign dense global ids */
+  int        i, k, n;           /* loop variables, number of keys */
+  CIMSHD     *shd;              /* to traverse the shards */
+  CIMENT     **ents;            /* entries without global ids */
+  const void **keys;            /* (new) key array */
+  int        *gids;             /* (new) global id array */
+
+  assert(cim);                  /* check the function argument */
+  for (n = i = 0; i < cim->cnt; i++)
+    n += idm_cnt(cim->shds[i].idm) -cim->shds[i].num;
+  if (n <= 0) return cim->total;/* count the keys without global ids */
+  ents = (CIMENT**)malloc((size_t)n *sizeof(CIMENT*));
+  if (!ents) return -1;         /* create an entry array */
+  if (cim->total +n > cim->size) {
+    keys = (const void**)realloc((void*)cim->keys,
+                          (size_t)(cim->total +n) *sizeof(void*));
+    if (!keys) { free(ents); return -1; }
+    cim->keys = keys; cim->size = cim->total +n;
+  }                             /* enlarge the key array */
+  for (n = i = 0; i < cim->cnt; i++) {
+    shd = cim->shds +i;         /* traverse the shards */
+    k   = idm_cnt(shd->idm);    /* get the number of keys */
+    if (k > shd->gsize) {       /* if the global id array is full */
+      gids = (int*)realloc(shd->gids, (size_t)k *sizeof(int));
+      if (!gids) { free(ents); return -1; }
+      shd->gids = gids; shd->gsize = k;
+    }                           /* enlarge the global id array */
+    for (k = shd->num; k < idm_cnt(shd->idm); k++)
+      ents[n++] = (CIMENT*)idm_byid(shd->idm, k);
+  }                             /* collect the new entries */
+  ptr_qsort(ents, n, entcmp, cim);
+  for (k = 0; k < n; k++) {     /* sort the new entries and */
+    cim->shds[ents[k]->shd].gids[ents[k]->id] = cim->total;
+    cim->keys[cim->total++] = idm_key(ents[k]);
+  }                             /* assign global ids in this order */
+  for (i = 0; i < cim->cnt; i++)
+    cim->shds[i].num = idm_cnt(cim->shds[i].idm);
+  free(ents);                   /* note the numbered keys */
+  return cim->total;            /* return the number of global ids */
+}  /* cim_number() */
+
+/* This function must not be called while keys are added. Keys that */
+/* already have a global id keep it, so that keys may be added (and */
+/* numbered) incrementally. New keys are numbered in the order of    */
+/* their ordering values: if this is the position of the first      */
+/* occurrence in the input, the global ids are the same as with a   */
+/* sequential identifier map.                                       */
+
+/*--------------------------------------------------------------------*/
+#ifdef CIM_MAIN
+
+typedef struct {                /* --- reader thread data --- */
+  CIDMAP  *cim;                 /* concurrent id map to fill */
+  TABREAD *trd;                 /* table reader for a part */
+  double  base;                 /* base of the ordering values */
+  int     err;                  /* error indicator */
+} CIMTHD;                       /* (reader thread data) */
+
+/*--------------------------------------------------------------------*/
+
+static void* reader (void *data)
+{                               /* --- read a part of a file */
+  CIMTHD *thd = (CIMTHD*)data;  /* reader thread data */
+  double n    = thd->base;      /* ordering value of next field */
+  int    d;                     /* delimiter of current field */
+
+  do {                          /* field read loop */
+    d = trd_read(thd->trd);     /* read the next field */
+    if (d <= TRD_ERR) { thd->err = -1; break; }
+    if ((trd_len(thd->trd) > 0)
+    &&  (cim_add(thd->cim, trd_field(thd->trd),
+                 (size_t)trd_len(thd->trd)+1, n++) < 0)) {
+      thd->err = -1; break; }   /* add the field to the id map */
+  } while (d >= 0);             /* while not at end of file */
+  return NULL;                  /* terminate the reader thread */
+}  /* reader() */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char* argv[])
+{                               /* --- main function for testing */
+  int       i, k, n, d;         /* loop variables, number of parts */
+  int       thds = 4;           /* number of reader threads */
+  int       shds = 64;          /* number of shards */
+  TABREAD   *trd;               /* table reader for the file */
+  TABREAD   *parts[CIM_MAXSHD]; /* table readers for the parts */
+  CIMTHD    data [CIM_MAXSHD];  /* reader thread data */
+  pthread_t thread[CIM_MAXSHD]; /* reader threads */
+  CIDMAP    *cim;               /* concurrent id map */
+  IDMAP     *idm;               /* sequential id map (for checking) */
+  clock_t   t;                  /* timer for measurements */
+
+  if (argc < 2) {               /* if no arguments given, abort */
+    printf("usage: %s file [threads [shards]]\n", argv[0]);
+    return 0;                   /* print a usage message */
+  }                             /* and abort the program */
+  if (argc > 2) thds = (int)strtol(argv[2], NULL, 0);
+  if (argc > 3) shds = (int)strtol(argv[3], NULL, 0);
+  if      (thds < 1)          thds = 1;
+  else if (thds > CIM_MAXSHD) thds = CIM_MAXSHD;
+  trd = trd_create();           /* create a table reader */
+  cim = cim_create(shds, 0, ST_STRFN);
+  if (!trd || !cim) { printf("not enough memory\n"); return -1; }
+  if (trd_open(trd, NULL, argv[1]) != 0) {
+    printf("cannot open %s\n", trd_name(trd)); return -1; }
+
+  /* --- fill the concurrent id map --- */
+  t = clock();                  /* split the file into parts */
+  n = (thds > 1) ? trd_split(trd, parts, thds) : 0;
+  if (n < 0) { printf("not enough memory\n"); return -1; }
+  if (n == 0) { parts[0] = trd; n = 1; }
+  for (k = 0; k < n; k++) {     /* traverse the parts */
+    data[k].cim  = cim; data[k].trd = parts[k];
+    data[k].base = (double)k *1099511627776.0; /* 2^40 per part */
+    data[k].err  = 0;           /* start a reader thread */
+    if (pthread_create(thread+k, NULL, reader, data+k) != 0) {
+      printf("cannot create thread\n"); return -1; }
+  }
+  for (k = 0; k < n; k++) {     /* wait for the reader threads */
+    pthread_join(thread[k], NULL);
+    if (data[k].err) { printf("read error/not enough memory\n");
+                       return -1; }
+  }
+  if (cim_number(cim) < 0) {    /* assign the global ids */
+    printf("not enough memory\n"); return -1; }
+  printf("%d key(s) read with %d thread(s), %d shard(s) [%.2fs]\n",
+         cim_cnt(cim), n, cim->cnt, (clock()-t)/(double)CLOCKS_PER_SEC);
+  if (n > 1) {                  /* delete the part readers */
+    for (k = 0; k < n; k++) trd_delete(parts[k], 0); }
+
+  /* --- compare with a sequential id map --- */
+  idm = idm_create(0, 0, ST_STRFN, (OBJFN*)0);
+  if (!idm) { printf("not enough memory\n"); return -1; }
+  trd_open(trd, NULL, argv[1]); /* reopen the file and */
+  t = clock();                  /* read it sequentially */
+  do {                          /* field read loop */
+    d = trd_read(trd);          /* read the next field */
+    if ((trd_len(trd) > 0)      /* add the field to the id map */
+    &&  !idm_add(idm, trd_field(trd), (size_t)trd_len(trd)+1,
+                 sizeof(int))) {
+      printf("not enough memory\n"); return -1; }
+  } while (d >= 0);             /* while not at end of file */
+  printf("%d key(s) read sequentially [%.2fs]\n",
+         idm_cnt(idm), (clock()-t)/(double)CLOCKS_PER_SEC);
+  k = (idm_cnt(idm) == cim_cnt(cim)) ? 0 : -1;
+  for (i = 0; (k == 0) && (i < idm_cnt(idm)); i++)
+    if (strcmp(idm_name(idm_byid(idm, i)),
+               (const char*)cim_key(cim, i)) != 0) k = -1;
+  printf("global ids %s sequential ids\n", (k == 0) ? "==" : "!=");
+  idm_delete(idm);              /* compare the identifiers and */
+  cim_delete(cim);              /* delete the id maps */
+  trd_delete(trd, 1);           /* and the table reader */
+  return k;                     /* return the comparison result */
+}  /* main() */
+
+#endif
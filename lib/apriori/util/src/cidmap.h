@@ -0,0 +1,65 @@
+/*----------------------------------------------------------------------
+  File    : cidmap.h
+  Contents: concurrent (sharded) key/identifier map management
+  Author  : agent
+  History : 2026.10.18 file created
+----------------------------------------------------------------------*/
+#ifndef __CIDMAP__
+#define __CIDMAP__
+#include <pthread.h>
+#ifndef IDMAPFN
+#define IDMAPFN
+#endif
+#include "symtab.h"
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define CIM_MAXSHD    1024      /* maximal number of shards */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- shard of an identifier map --- */
+  pthread_mutex_t lock;         /* lock for adding and looking up */
+  IDMAP           *idm;         /* key/identifier map of the shard */
+  int             num;          /* number of keys with global ids */
+  int             gsize;        /* size of the global id array */
+  int             *gids;        /* global ids (indexed by local id) */
+} CIMSHD;                       /* (shard of an identifier map) */
+
+typedef struct {                /* --- concurrent identifier map --- */
+  int             cnt;          /* number of shards (power of 2) */
+  int             bits;         /* number of bits of shard index */
+  HASHFN          *hashfn;      /* hash function */
+  CMPFN           *cmpfn;       /* comparison function */
+  void            *data;        /* comparison data */
+  int             total;        /* number of global identifiers */
+  int             size;         /* size of the key array */
+  const void      **keys;       /* keys indexed by global id */
+  CIMSHD          shds[1];      /* shards (lock-striped id maps) */
+} CIDMAP;                       /* (concurrent identifier map) */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern CIDMAP*     cim_create (int shards, int init, HASHFN hashfn,
+                               CMPFN cmpfn, void *data);
+extern void        cim_delete (CIDMAP *cim);
+extern int         cim_add    (CIDMAP *cim, const void *key,
+                               size_t keysize, double ord);
+extern int         cim_getid  (CIDMAP *cim, const void *key);
+extern int         cim_number (CIDMAP *cim);
+extern int         cim_global (CIDMAP *cim, int pid);
+extern const void* cim_key    (CIDMAP *cim, int gid);
+extern int         cim_cnt    (CIDMAP *cim);
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define cim_global(m,p)   ((m)->shds[(p) & ((m)->cnt-1)] \
+                            .gids[(p) >> (m)->bits])
+#define cim_key(m,g)      ((m)->keys[g])
+#define cim_cnt(m)        ((m)->total)
+
+#endif
@@ -47,6 +47,12 @@
 #define DFLT_INIT    65535      /* default initial hash table size */
 #define DFLT_MAX   4194303      /* default maximal hash table size */
 #define BLKSIZE       4096      /* block size for identifier array */
+#ifdef ST_OPENADDR
+#define STBLKSIZE  1048576      /* size of a symbol memory block */
+#define STBLKALN         8      /* alignment of symbols in a block */
+#define ST_DEL   ((STE*)-1)     /* marker for a deleted slot */
+#define MAXFILL(n)  (((n) >> 1) +((n) >> 2))  /* max. fill: 75% */
+#endif
 
 #ifdef ALIGN8
 #define ALIGN            8      /* alignment to addresses that are */
@@ -54,6 +60,16 @@
 #define ALIGN            4      /* alignment to addresses that are */
 #endif                          /* divisible by 8 (32 bit) */
 
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+#ifdef ST_OPENADDR
+typedef union stblk {           /* --- symbol memory block --- */
+  union stblk *prev;            /* previous block in list */
+  double      align;            /* (for the alignment of the symbols) */
+} STBLK;                        /* (symbol memory block) */
+#endif
+
 /*----------------------------------------------------------------------
   Name/Key Functions
 ----------------------------------------------------------------------*/
@@ -65,6 +81,30 @@ int st_strcmp (const void *a, const void *b, void *data)
 
 /*--------------------------------------------------------------------*/
 
+#ifdef ST_OPENADDR
+
+unsigned int st_strhash (const void *s, int type)
+{                               /* --- string hash function */
+  const char         *p = (const char*)s;  /* to traverse the key */
+  size_t             n  = strlen(p);       /* length of the key */
+  unsigned long long h, w;      /* hash value, block of characters */
+
+  h = ((unsigned long long)n *0x9e3779b97f4a7c15ULL) ^ (unsigned)type;
+  for ( ; n >= sizeof(w); n -= sizeof(w), p += sizeof(w)) {
+    memcpy(&w, p, sizeof(w));   /* process blocks of characters */
+    h = (h ^ w) *0xbf58476d1ce4e5b9ULL; h ^= h >> 31;
+  }                             /* (multiply and shift mixing) */
+  w = 0; memcpy(&w, p, n);      /* process the remaining characters */
+  h = (h ^ w) *0x94d049bb133111ebULL; h ^= h >> 29;
+  return (unsigned int)(h ^ (h >> 32));
+}  /* st_strhash() */           /* fold and return the hash value */
+
+/* With open addressing a collision costs more than with hash bins, */
+/* so a stronger hash function is used, which still processes the   */
+/* key in blocks of 8 characters rather than character by character. */
+
+#else
+
 unsigned int st_strhash (const void *s, int type)
 {                               /* --- string hash function */
   register const char  *p = (const char*)s;  /* to traverse the key */
@@ -83,6 +123,8 @@ unsigned int st_strhash (const void *s, int type)
   return h;                     /* compute and return hash value */
 }  /* st_strhash() */
 
+#endif
+
 /*--------------------------------------------------------------------*/
 
 size_t st_strsize (const void *s)
@@ -111,6 +153,312 @@ unsigned int st_inthash (const void *i, int type)
 size_t st_intsize (const void *i)
 { return sizeof(int); }         /* --- integer size function */
 
+/*----------------------------------------------------------------------
+  Auxiliary Functions (open addressing)
+----------------------------------------------------------------------*/
+#ifdef ST_OPENADDR
+
+static unsigned int mix (unsigned int h)
+{                               /* --- finalize a hash value */
+  h ^= h >> 16; h *= 0x85ebca6bU;
+  h ^= h >> 13; h *= 0xc2b2ae35U;
+  h ^= h >> 16; return h;       /* spread all bits of the hash value */
+}  /* mix() */                  /* (slot indices are its low bits) */
+
+/*--------------------------------------------------------------------*/
+
+static STE* stalloc (SYMTAB *tab, size_t size)
+{                               /* --- allocate memory for a symbol */
+  STBLK *b;                     /* new symbol memory block */
+  size_t z;                     /* size of the new block */
+  char   *p;                    /* allocated memory */
+
+  size = ((size +STBLKALN-1) /STBLKALN) *STBLKALN;
+  if (size > tab->rest) {       /* if the current block is full */
+    z = (size > STBLKSIZE) ? size : STBLKSIZE;
+    b = (STBLK*)malloc(sizeof(STBLK) +z);
+    if (!b) return NULL;        /* allocate a new block and */
+    b->prev   = tab->blks;      /* add it to the block list */
+    tab->blks = b;              /* (the rest of the old block */
+    tab->next = (char*)(b+1);   /* is simply abandoned) */
+    tab->rest = z;
+  }
+  p = tab->next;                /* take the memory from the block */
+  tab->next += size; tab->rest -= size;
+  return (STE*)p;               /* return the allocated memory */
+}  /* stalloc() */
+
+/*--------------------------------------------------------------------*/
+
+static void delsym (SYMTAB *tab)
+{                               /* --- delete all symbols */
+  int   i;                      /* loop variable */
+  STE   *e, *t;                 /* to traverse the symbols */
+  STBLK *b;                     /* to traverse the memory blocks */
+
+  assert(tab);                  /* check the function argument */
+  for (i = tab->size; --i >= 0; ) {
+    e = tab->slots[i].ste;      /* traverse the slot array */
+    tab->slots[i].ste = NULL;   /* and clear the current slot */
+    if (e == ST_DEL) continue;  /* skip deleted slots */
+    for ( ; e; e = t) {         /* traverse the shadowed symbols */
+      t = e->succ;              /* and call the deletion function */
+      if (tab->delfn) tab->delfn(e+1);
+    }                           /* (memory is freed per block) */
+  }
+  while (tab->blks) {           /* delete the memory blocks */
+    b = tab->blks; tab->blks = b->prev; free(b); }
+  tab->next = NULL; tab->rest = 0;
+  tab->fill = tab->used = 0;    /* clear the block and slot counters */
+}  /* delsym() */
+
+/*--------------------------------------------------------------------*/
+
+static int grow (SYMTAB *tab)
+{                               /* --- reorganize a hash table */
+  int    i, k, m, size;         /* loop variables, new table size */
+  STSLOT *p;                    /* new slot array */
+  STE    *e;                    /* symbol in current slot */
+
+  assert(tab);                  /* check the function argument */
+  size = tab->size;             /* if there are few deleted slots, */
+  if ((tab->used >= (size >> 1)) && (size < (INT_MAX >> 1)))
+    size <<= 1;                 /* double the table size, otherwise */
+  p = (STSLOT*)calloc((size_t)size, sizeof(STSLOT));
+  if (!p) return -1;            /* only remove the deleted slots */
+  for (m = size-1, i = tab->size; --i >= 0; ) {
+    e = tab->slots[i].ste;      /* traverse the old slots */
+    if (!e || (e == ST_DEL)) continue;
+    for (k = (int)(tab->slots[i].hash & (unsigned int)m); p[k].ste; )
+      k = (k+1) & m;            /* find a free slot in the new table */
+    p[k] = tab->slots[i];       /* (the stored hash value need */
+  }                             /* not be recomputed) */
+  free(tab->slots);             /* delete the old slot array */
+  tab->slots = p;               /* and set the new slot array */
+  tab->size  = size;            /* and its size */
+  tab->fill  = tab->used;       /* (there are no deleted slots) */
+  return 0;                     /* return 'ok' */
+}  /* grow() */
+
+/*--------------------------------------------------------------------*/
+
+static int find (SYMTAB *tab, const void *key, int type, unsigned int h)
+{                               /* --- find the slot of a symbol */
+  int m = tab->size-1;          /* mask for slot indices */
+  int i;                        /* index of the current slot */
+  STE *e;                       /* symbol in current slot */
+
+  for (i = (int)(h & (unsigned int)m); (e = tab->slots[i].ste) != NULL;
+       i = (i+1) & m) {         /* linear probing */
+    if ((e != ST_DEL) && (tab->slots[i].hash == h) && (e->type == type)
+    &&  (tab->cmpfn(key, e->key, tab->data) == 0))
+      return i;                 /* if the symbol was found, */
+  }                             /* return the index of its slot */
+  return -1;                    /* otherwise return 'not found' */
+}  /* find() */
+
+/*----------------------------------------------------------------------
+  Symbol Table Functions (open addressing)
+----------------------------------------------------------------------*/
+
+SYMTAB* st_create (int init, int max, HASHFN hashfn,
+                   CMPFN cmpfn, void *data, OBJFN delfn)
+{                               /* --- create a symbol table */
+  SYMTAB *tab;                  /* created symbol table */
+  int    size;                  /* size of the slot array */
+
+  if (init <= 0) init = DFLT_INIT;  /* check and adapt the initial */
+  if (max  <= 0) max  = DFLT_MAX;   /* and maximal table size */
+  for (size = 64; (size < init) && (size < (INT_MAX >> 1)); )
+    size <<= 1;                 /* slot array size is a power of 2 */
+  tab = (SYMTAB*)malloc(sizeof(SYMTAB));
+  if (!tab) return NULL;        /* allocate symbol table body */
+  tab->slots = (STSLOT*)calloc((size_t)size, sizeof(STSLOT));
+  if (!tab->slots) { free(tab); return NULL; }
+  tab->level  = tab->cnt = 0;   /* allocate the slot array */
+  tab->size   = size;           /* and initialize fields */
+  tab->max    = max;            /* of symbol table body */
+  tab->fill   = tab->used = 0;  /* (the maximal size is ignored, */
+  tab->blks   = NULL;           /* since the table must grow */
+  tab->next   = NULL;           /* with the number of symbols) */
+  tab->rest   = 0;
+  tab->hashfn = (hashfn) ? hashfn : st_strhash;
+  tab->cmpfn  = (cmpfn)  ? cmpfn  : st_strcmp;
+  tab->data   = data;
+  tab->delfn  = delfn;
+  tab->idsize = INT_MAX;
+  tab->ids    = NULL;
+  return tab;                   /* return created symbol table */
+}  /* st_create() */
+
+/*--------------------------------------------------------------------*/
+
+void st_delete (SYMTAB *tab)
+{                               /* --- delete a symbol table */
+  assert(tab && tab->slots);    /* check argument */
+  delsym(tab);                  /* delete all symbols, */
+  free(tab->slots);             /* the slot array, */
+  if (tab->ids) free(tab->ids); /* the identifier array, */
+  free(tab);                    /* and the symbol table body */
+}  /* st_delete() */
+
+/*--------------------------------------------------------------------*/
+
+void* st_insert (SYMTAB *tab, const void *key, int type,
+                 size_t keysize, size_t datasize)
+{                               /* --- insert a symbol (name/key) */
+  unsigned int h;               /* hash value */
+  int          i, d, m;         /* slot indices, mask for indices */
+  STE          *e, *n;          /* existing and new symbol */
+
+  assert(tab && key             /* check the function arguments */
+  &&    ((datasize >= sizeof(int)) || (tab->idsize == INT_MAX)));
+  if ((tab->fill >= MAXFILL(tab->size))
+  &&  (grow(tab) != 0)          /* if the table is rather full, */
+  &&  (tab->fill >= tab->size-1))    /* reorganize the hash table */
+    return NULL;                /* (keep at least one empty slot) */
+
+  h = mix(tab->hashfn(key, type));   /* compute the hash value */
+  m = tab->size-1; d = -1;      /* and traverse the probe sequence */
+  for (i = (int)(h & (unsigned int)m); (e = tab->slots[i].ste) != NULL;
+       i = (i+1) & m) {         /* (note first deleted slot) */
+    if (e == ST_DEL) { if (d < 0) d = i; continue; }
+    if ((tab->slots[i].hash == h) && (e->type == type)
+    &&  (tab->cmpfn(key, e->key, tab->data) == 0))
+      break;                    /* check whether symbol exists */
+  }
+  if (e && (e->level == tab->level))
+    return EXISTS;              /* if symbol found on current level */
+
+  #ifdef IDMAPFN                /* if key/identifier map management */
+  if (tab->cnt >= tab->idsize){ /* if the identifier array is full */
+    int **p, s = tab->idsize;   /* (new) id array and its size */
+    s += (s > BLKSIZE) ? s >> 1 : BLKSIZE;
+    p  = (int**)realloc(tab->ids, s *sizeof(int*));
+    if (!p) return NULL;        /* resize the identifier array and */
+    tab->ids = p; tab->idsize = s;   /* set new array and its size */
+  }                             /* (no resizing for symbol tables */
+  #endif                        /* since then tab->idsize = MAX_INT) */
+  datasize = ((datasize +ALIGN-1) /ALIGN) *ALIGN;
+  n = stalloc(tab, sizeof(STE) +datasize +keysize);
+  if (!n) return NULL;          /* allocate memory for new symbol */
+  memcpy(n->key = (char*)(n+1) +datasize, key, keysize);
+  n->type  = type;              /* note the symbol name/key, type, */
+  n->level = tab->level;        /* and the current visibility level */
+  n->succ  = e;                 /* shadow a symbol of a lower level */
+  if (!e) {                     /* if the symbol is new, */
+    if (d >= 0) i = d;          /* reuse a deleted slot */
+    else tab->fill++;           /* or occupy an empty one */
+    tab->slots[i].hash = h;     /* and note the hash value */
+    tab->used++;                /* (the slot of a shadowed symbol */
+  }                             /* is simply taken over) */
+  tab->slots[i].ste = n++;      /* store the new symbol */
+  #ifdef IDMAPFN                /* if key/identifier maps are */
+  if (tab->ids) {               /* supported and this is such a map */
+    tab->ids[tab->cnt] = (int*)n;
+    *(int*)n = tab->cnt;        /* store the new symbol */
+  }                             /* in the identifier array */
+  #endif                        /* and set the symbol identifier */
+  tab->cnt++;                   /* increment the symbol counter */
+  return n;                     /* return pointer to data field */
+}  /* st_insert() */
+
+/*--------------------------------------------------------------------*/
+
+int st_remove (SYMTAB *tab, const void *key, int type)
+{                               /* --- remove a symbol/all symbols */
+  int i;                        /* index of slot */
+  STE *e;                       /* symbol to remove */
+
+  assert(tab);                  /* check the function arguments */
+  if (!key) {                   /* if no symbol name/key given */
+    delsym(tab);                /* delete all symbols */
+    tab->cnt = tab->level = 0;  /* reset visibility level */
+    return 0;                   /* and symbol counter */
+  }                             /* and return 'ok' */
+  i = find(tab, key, type, mix(tab->hashfn(key, type)));
+  if (i < 0) return -1;         /* find the symbol or abort */
+  e = tab->slots[i].ste;        /* remove the symbol from its slot */
+  if (e->succ) tab->slots[i].ste = e->succ;
+  else       { tab->slots[i].ste = ST_DEL; tab->used--; }
+  if (tab->delfn) tab->delfn(e+1);      /* delete user data */
+  tab->cnt--;                   /* decrement symbol counter */
+  return 0;                     /* return 'ok' */
+}  /* st_remove() */            /* (memory is freed per block) */
+
+/*--------------------------------------------------------------------*/
+
+void* st_lookup (SYMTAB *tab, const void *key, int type)
+{                               /* --- look up a symbol */
+  int i;                        /* index of slot */
+
+  assert(tab && key);           /* check the function arguments */
+  i = find(tab, key, type, mix(tab->hashfn(key, type)));
+  return (i < 0) ? NULL : tab->slots[i].ste +1;
+}  /* st_lookup() */            /* return the symbol data */
+
+/*--------------------------------------------------------------------*/
+
+void st_endblk (SYMTAB *tab)
+{                               /* --- remove one visibility level */
+  int i;                        /* loop variable */
+  STE *e;                       /* to traverse the symbols */
+
+  assert(tab);                  /* check for a valid symbol table */
+  if (tab->level <= 0) return;  /* if on level 0, abort */
+  for (i = tab->size; --i >= 0; ) {  /* traverse the slot array */
+    e = tab->slots[i].ste;      /* remove all symbols of higher level */
+    if (!e || (e == ST_DEL)) continue;
+    while (e && (e->level >= tab->level)) {
+      if (tab->delfn) tab->delfn(e+1);
+      tab->cnt--; e = e->succ;  /* delete user data and */
+    }                           /* decrement symbol counter */
+    if (!e) { e = ST_DEL; tab->used--; }
+    tab->slots[i].ste = e;      /* set the shadowed symbol */
+  }                             /* or mark the slot as deleted */
+  tab->level--;                 /* go up one level */
+}  /* st_endblk() */
+
+/*--------------------------------------------------------------------*/
+#ifndef NDEBUG
+
+void st_stats (const SYMTAB *tab)
+{                               /* --- compute and print statistics */
+  int i;                        /* loop variable */
+  int len;                      /* length of current probe sequence */
+  int max;                      /* maximal probe sequence length */
+  double sum;                   /* sum of probe sequence lengths */
+  int cnts[10];                 /* counter for probe lengths */
+
+  assert(tab);                  /* check for a valid symbol table */
+  max = 0; sum = 0;             /* initialize variables */
+  for (i = 10; --i >= 0; ) cnts[i] = 0;
+  for (i = tab->size; --i >= 0; ) { /* traverse the slot array */
+    if (!tab->slots[i].ste || (tab->slots[i].ste == ST_DEL))
+      continue;                 /* skip empty and deleted slots */
+    len = (i -(int)(tab->slots[i].hash & (unsigned int)(tab->size-1)))
+        & (tab->size-1);        /* compute the probe length */
+    if (len > max) max = len;   /* determine the maximal length */
+    sum += len;                 /* sum the probe lengths */
+    cnts[(len >= 9) ? 9 : len]++;
+  }                             /* count probe length */
+  printf("number of symbols  : %d\n", tab->cnt);
+  printf("number of slots    : %d\n", tab->size);
+  printf("used slots         : %d\n", tab->used);
+  printf("deleted slots      : %d\n", tab->fill -tab->used);
+  printf("maximal probe dist.: %d\n", max);
+  printf("average probe dist.: %g\n", (tab->used > 0)
+                                      ? sum/tab->used : 0.0);
+  printf("distance distribution:\n");
+  for (i = 0; i < 9; i++) printf("%6d ", i);
+  printf("    >8\n");
+  for (i = 0; i < 9; i++) printf("%6d ", cnts[i]);
+  printf("%6d\n", cnts[9]);
+}  /* st_stats() */
+
+#endif
+/*--------------------------------------------------------------------*/
+#else   /* #ifdef ST_OPENADDR */
 /*----------------------------------------------------------------------
   Auxiliary Functions
 ----------------------------------------------------------------------*/
@@ -381,6 +729,7 @@ void st_stats (const SYMTAB *tab)
 }  /* st_stats() */
 
 #endif
+#endif  /* #ifdef ST_OPENADDR ... #else ... */
 /*----------------------------------------------------------------------
   Name/Identifier Map Functions
 ----------------------------------------------------------------------*/
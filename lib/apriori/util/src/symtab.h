@@ -47,6 +47,13 @@ typedef struct ste {            /* --- symbol table element --- */
   int        level;             /* visibility level */
 } STE;                          /* (symbol table element) */
 
+#ifdef ST_OPENADDR
+typedef struct {                /* --- hash table slot --- */
+  unsigned int hash;            /* (mixed) hash value of the symbol */
+  STE          *ste;            /* symbol (NULL if slot is empty) */
+} STSLOT;                       /* (hash table slot) */
+#endif
+
 typedef struct {                /* --- symbol table --- */
   int        cnt;               /* current number of symbols */
   int        level;             /* current visibility level */
@@ -56,7 +63,16 @@ typedef struct {                /* --- symbol table --- */
   CMPFN      *cmpfn;            /* comparison function */
   void       *data;             /* comparison data */
   OBJFN      *delfn;            /* symbol deletion function */
+  #ifdef ST_OPENADDR            /* if open addressing is used */
+  STSLOT     *slots;            /* array of hash slots */
+  int        fill;              /* number of non-empty slots */
+  int        used;              /* number of slots with symbols */
+  union stblk *blks;            /* list of symbol memory blocks */
+  char       *next;             /* next free byte in current block */
+  size_t     rest;              /* number of free bytes in block */
+  #else                         /* if hash bin lists are used */
   STE        **bins;            /* array of hash bins */
+  #endif
   int        idsize;            /* size of identifier array */
   int        **ids;             /* identifier array */
 } SYMTAB;                       /* (symbol table) */
@@ -26,9 +26,31 @@
             2010.10.15 bug in function trd_open() fixed (name assignm.)
             2011.03.20 order of arguments of trd_istype() changed
 ----------------------------------------------------------------------*/
+#if !defined TRD_NOMMAP && (defined __unix__ || defined __APPLE__)
+#define TRD_MMAP                /* memory map regular input files */
+#endif
+#if (defined TRD_MMAP || defined TRD_THREADS || defined TRD_ZLIB) \
+ && !defined _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* needed for fileno(), mmap() etc. */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#ifdef TRD_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+#ifdef TRD_THREADS
+#include <pthread.h>
+#endif
+#ifdef TRD_ZLIB
+#include <unistd.h>
+#include <zlib.h>
+#endif
+#if defined __SSE2__ && defined __GNUC__
+#include <emmintrin.h>
+#endif
 #include "tabread.h"
 #include "escape.h"
 #ifdef STORAGE
@@ -50,6 +72,346 @@
   if ((c = trd_getc(t)) < 0) { (t)->last = EOF; \
     return (t)->delim = (c <= TRD_ERR) ? TRD_ERR : (d); }
 
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+#ifdef TRD_THREADS
+typedef struct trdring {        /* --- read-ahead buffers --- */
+  pthread_t       thread;       /* reader thread */
+  pthread_mutex_t lock;         /* lock for the shared variables */
+  pthread_cond_t  cond;         /* condition for state changes */
+  int             cnt;          /* number of buffers */
+  size_t          size;         /* size of each buffer */
+  int             head;         /* buffer to be parsed next */
+  int             tail;         /* buffer to be filled next */
+  int             full;         /* number of filled buffers */
+  int             held;         /* whether parser holds head buffer */
+  int             done;         /* end of input (1) or error (-1) */
+  int             quit;         /* whether reader is to terminate */
+  size_t          *lens;        /* number of characters per buffer */
+  char            *bufs;        /* buffers (cnt *size characters) */
+} TRDRING;                      /* (read-ahead buffers) */
+#endif
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static void sepset (TABREAD *trd)
+{                               /* --- collect the separators */
+  int c;                        /* loop variable, character */
+
+  for (trd->nsep = c = 0; c < 256; c++) {
+    if (!issep(c)) continue;    /* traverse the separators */
+    if (trd->nsep >= TRD_SEPMAX) { trd->nsep = -1; return; }
+    trd->seps[trd->nsep++] = (char)c;
+  }                             /* (too many separators: scan */
+}  /* sepset() */               /* with the character flags) */
+
+/*--------------------------------------------------------------------*/
+
+static long fill (TABREAD *trd, char *buf, size_t size)
+{                               /* --- fill a buffer from the input */
+  size_t n;                     /* number of characters read */
+
+  #ifdef TRD_ZLIB               /* if compressed input is possible */
+  if (trd->gz) {                /* if to read through zlib */
+    int e = Z_OK;               /* zlib error code */
+    int k = gzread((gzFile)trd->gz, buf, (unsigned int)size);
+    if (k == 0) gzerror((gzFile)trd->gz, &e);
+    return ((k < 0) || (e < 0)) ? -1 : (long)k;
+  }                             /* (a truncated stream is an error, */
+  #endif                        /* uncompressed input is read as is) */
+  n = fread(buf, sizeof(char), size, trd->file);
+  return ((n <= 0) && ferror(trd->file)) ? -1 : (long)n;
+}  /* fill() */                 /* return the number of characters */
+
+/*--------------------------------------------------------------------*/
+#ifdef TRD_THREADS
+
+static void* prefetch (void *data)
+{                               /* --- read-ahead thread */
+  TABREAD *trd  = (TABREAD*)data;  /* table reader to fill */
+  TRDRING *ring = trd->ring;    /* read-ahead buffers */
+  char    *buf;                 /* buffer to fill */
+  long    n;                    /* number of characters read */
+
+  pthread_mutex_lock(&ring->lock);
+  while (1) {                   /* reader loop */
+    while ((ring->full >= ring->cnt) && !ring->quit)
+      pthread_cond_wait(&ring->cond, &ring->lock);
+    if (ring->quit) break;      /* wait for a free buffer */
+    buf = ring->bufs +(size_t)ring->tail *ring->size;
+    pthread_mutex_unlock(&ring->lock);
+    n = fill(trd, buf, ring->size);
+    pthread_mutex_lock(&ring->lock);
+    if (n <= 0) {               /* if end of input or error, */
+      ring->done = (n < 0) ? -1 : 1;  /* note the final state */
+      pthread_cond_signal(&ring->cond); break;
+    }                           /* and terminate the thread */
+    ring->lens[ring->tail] = (size_t)n;
+    ring->tail = (ring->tail +1) % ring->cnt;
+    ring->full++;               /* pass the filled buffer */
+    pthread_cond_signal(&ring->cond);
+  }                             /* to the parser */
+  pthread_mutex_unlock(&ring->lock);
+  return NULL;                  /* terminate the reader thread */
+}  /* prefetch() */
+
+/*--------------------------------------------------------------------*/
+
+static void ringstart (TABREAD *trd)
+{                               /* --- start a read-ahead thread */
+  TRDRING *ring;                /* read-ahead buffers */
+
+  ring = (TRDRING*)malloc(sizeof(TRDRING));
+  if (!ring) return;            /* create the base structure */
+  ring->lens = (size_t*)malloc((size_t)trd->rcnt *sizeof(size_t));
+  ring->bufs = (char*)  malloc((size_t)trd->rcnt *trd->rsize);
+  if (!ring->lens || !ring->bufs) {
+    free(ring->bufs); free(ring->lens); free(ring); return; }
+  ring->cnt  = trd->rcnt;       /* create the buffers */
+  ring->size = trd->rsize;      /* and note their number and size */
+  ring->head = ring->tail = ring->full = 0;
+  ring->held = ring->done = ring->quit = 0;
+  pthread_mutex_init(&ring->lock, NULL);
+  pthread_cond_init (&ring->cond, NULL);
+  trd->ring = ring;             /* start the reader thread */
+  if (pthread_create(&ring->thread, NULL, prefetch, trd) == 0)
+    return;                     /* on failure clean up and */
+  pthread_mutex_destroy(&ring->lock);  /* fall back to reading */
+  pthread_cond_destroy (&ring->cond);  /* with the internal buffer */
+  free(ring->bufs); free(ring->lens); free(ring);
+  trd->ring = NULL;
+}  /* ringstart() */
+
+/*--------------------------------------------------------------------*/
+
+static void ringstop (TABREAD *trd)
+{                               /* --- stop a read-ahead thread */
+  TRDRING *ring = trd->ring;    /* read-ahead buffers */
+
+  if (!ring) return;            /* check for a reader thread */
+  pthread_mutex_lock(&ring->lock);
+  ring->quit = 1;               /* tell the reader to terminate */
+  pthread_cond_signal(&ring->cond);
+  pthread_mutex_unlock(&ring->lock);
+  pthread_join(ring->thread, NULL);
+  pthread_mutex_destroy(&ring->lock);
+  pthread_cond_destroy (&ring->cond);
+  free(ring->bufs); free(ring->lens); free(ring);
+  trd->ring = NULL;             /* delete the buffers and */
+  trd->beg  = trd->next = trd->end = trd->buf;
+}  /* ringstop() */             /* return to the internal buffer */
+
+/*--------------------------------------------------------------------*/
+
+static int ringnext (TABREAD *trd)
+{                               /* --- get the next filled buffer */
+  TRDRING *ring = trd->ring;    /* read-ahead buffers */
+  int     r;                    /* result of the function */
+
+  pthread_mutex_lock(&ring->lock);
+  if (ring->held) {             /* if the parser holds a buffer, */
+    ring->held = 0;             /* pass it back to the reader */
+    ring->head = (ring->head +1) % ring->cnt;
+    ring->full--; pthread_cond_signal(&ring->cond);
+    trd->beg = trd->next = trd->end = trd->buf;
+  }                             /* (it may be refilled now) */
+  while (!ring->full && !ring->done)
+    pthread_cond_wait(&ring->cond, &ring->lock);
+  if (ring->full) {             /* if there is a filled buffer, */
+    ring->held = 1;             /* parse it in place */
+    trd->beg = trd->next = ring->bufs +(size_t)ring->head *ring->size;
+    trd->end = trd->next +ring->lens[ring->head];
+    r = 0; }                    /* otherwise report the end of the */
+  else r = (ring->done < 0) ? TRD_ERR : TRD_EOF;  /* input or error */
+  pthread_mutex_unlock(&ring->lock);
+  return r;                     /* return whether a buffer is filled */
+}  /* ringnext() */
+
+/* The parser holds at most one buffer (the one it is reading from), */
+/* all other buffers are filled by the reader thread as long as they */
+/* are free. Hence reading (and decompressing) the input overlaps    */
+/* with parsing it, which also helps if the input comes from a pipe. */
+
+#endif
+/*--------------------------------------------------------------------*/
+#ifdef TRD_MMAP
+
+static void unmap (TABREAD *trd)
+{                               /* --- unmap the input file */
+  if (!trd->map) return;        /* check for a mapped file */
+  if (trd->msize > 0)           /* unmap the file (parts of a split */
+    munmap(trd->map, trd->msize);    /* file do not own the map) */
+  trd->map = NULL;              /* return to buffered reading */
+  trd->beg  = trd->next = trd->end = trd->buf;
+}  /* unmap() */
+
+/*--------------------------------------------------------------------*/
+
+static void map (TABREAD *trd)
+{                               /* --- map a regular input file */
+  struct stat st;               /* status of the input file */
+  void        *p;               /* mapped file contents */
+
+  if ((fstat(fileno(trd->file), &st) != 0)
+  ||  !S_ISREG(st.st_mode)      /* only regular (non-empty) files */
+  ||  (st.st_size <= 0)         /* can be mapped, pipes etc. */
+  ||  ((off_t)(size_t)st.st_size != st.st_size))
+    return;                     /* are read through the buffer */
+  p = mmap(NULL, (size_t)st.st_size, PROT_READ,
+           MAP_PRIVATE, fileno(trd->file), 0);
+  if (p == MAP_FAILED) return;  /* map the file read-only */
+  #ifdef TRD_ZLIB               /* if compressed input is possible */
+  if ((st.st_size >= 2)         /* check for the gzip magic number */
+  &&  (((unsigned char*)p)[0] == 0x1f)
+  &&  (((unsigned char*)p)[1] == 0x8b)) {
+    munmap(p, (size_t)st.st_size); return; }
+  #endif                        /* (compressed files are not mapped) */
+  posix_madvise(p, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+  trd->map   = (char*)p;        /* note the mapped file */
+  trd->msize = (size_t)st.st_size;
+  trd->beg   = trd->next = trd->map; /* use it as the read buffer */
+  trd->end   = trd->map +trd->msize;
+}  /* map() */
+
+/* The file is mapped read-only, so that its pages are shared with */
+/* the page cache and never copied. The map replaces the read      */
+/* buffer: separators are found in the map and only the fields     */
+/* (at most TRD_MAXLEN characters) are copied to the field buffer, */
+/* where they can be terminated.                                   */
+
+/*--------------------------------------------------------------------*/
+
+static char* scan (TABREAD *trd, char *s, char *e)
+{                               /* --- find the next separator */
+  #if defined __SSE2__ && defined __GNUC__
+  int     i, m;                 /* loop variable, match mask */
+  __m128i v, x, seps[TRD_SEPMAX];  /* block of characters, matches */
+
+  if (trd->nsep > 0) {          /* if there are only few separators */
+    for (i = 0; i < trd->nsep; i++)
+      seps[i] = _mm_set1_epi8(trd->seps[i]);
+    for ( ; s +16 <= e; s += 16) {
+      v = _mm_loadu_si128((const __m128i*)s);
+      x = _mm_cmpeq_epi8(v, seps[0]);
+      for (i = 1; i < trd->nsep; i++)
+        x = _mm_or_si128(x, _mm_cmpeq_epi8(v, seps[i]));
+      m = _mm_movemask_epi8(x); /* compare a block of characters */
+      if (m) return s +__builtin_ctz((unsigned int)m);
+    }                           /* return the first separator */
+  }                             /* in the block (if any) */
+  #endif
+  while ((s < e) && !issep((unsigned char)*s))
+    s++;                        /* scan the remaining characters */
+  return s;                     /* return the separator position */
+}  /* scan() */
+
+/*--------------------------------------------------------------------*/
+
+static int mapread (TABREAD *trd)
+{                               /* --- read a field (mapped file) */
+  int  c, d;                    /* character read, delimiter type */
+  char *s, *e, *p;              /* to traverse the field */
+
+  /* --- initialize --- */
+  trd->pos = (trd->delim == TRD_FLD) ? trd->pos+1 : 1;
+  trd->fld = trd->field;        /* clear the current field */
+  trd->field[0] = trd->len = 0; /* (point to the field buffer) */
+  s = trd->next;                /* get the next character */
+  if (s >= trd->end) { trd->last = EOF; return trd->delim = TRD_EOF; }
+  c = (unsigned char)*s;
+
+  /* --- skip comment records --- */
+  if (trd->delim != TRD_FLD) {  /* if at the start of a record */
+    while (iscomment(c)) {      /* while the record is a comment */
+      while (!isrecsep(c)) {    /* while not at end of record, */
+        if (++s >= trd->end) {  /* get the next character */
+          trd->next = s; trd->last = EOF; return trd->delim = TRD_EOF; }
+        c = (unsigned char)*s;
+      }
+      trd->rec++;               /* count the comment record */
+      if (++s >= trd->end) {    /* get the first character */
+        trd->next = s; trd->last = EOF; return trd->delim = TRD_EOF; }
+      c = (unsigned char)*s;    /* after the comment record */
+    }                           /* (comment records are skipped) */
+  }
+
+  /* --- skip leading blanks --- */
+  while (isblank(c)) {          /* while the character is blank, */
+    if (++s >= trd->end) {      /* get the next character */
+      trd->next = s; trd->last = EOF; return trd->delim = TRD_REC; }
+    c = (unsigned char)*s;
+  }
+  if (issep(c)) {               /* check for field/record separator */
+    trd->next = s+1; trd->last = c;
+    if (isfldsep(c)) return trd->delim = TRD_FLD;
+    trd->rec++;      return trd->delim = TRD_REC;
+  }                             /* if at end of record, count record */
+
+  /* --- read the field --- */
+  e = scan(trd, s+1, trd->end); /* find the end of the field */
+  if (e >= trd->end) { c = EOF; d = TRD_REC; }
+  else { c = (unsigned char)*e; d = (isfldsep(c)) ? TRD_FLD : TRD_REC; }
+  trd->last = c;                /* store the last character read */
+  p = (e -s > TRD_MAXLEN) ? s +TRD_MAXLEN : e;
+
+  /* --- remove trailing blanks --- */
+  while (isblank((unsigned char)p[-1])) p--;
+  trd->len = (int)(p -s);       /* store number of characters read */
+  memcpy(trd->field, s, (size_t)trd->len);
+  trd->field[trd->len] = 0;     /* copy the field to the buffer */
+
+  /* --- check for a null value --- */
+  while (--p >= s)              /* check for only null value chars. */
+    if (!isnull((unsigned char)*p)) break;
+  if (p < s)                    /* clear field if null value */
+    trd->field[0] = trd->len = 0;
+
+  /* --- check for end of line --- */
+  if (d != TRD_FLD) {           /* if not at a field separator, */
+    trd->next = (e < trd->end) ? e+1 : e; /* consume the separator */
+    trd->rec++;                 /* count the record */
+    return trd->delim = d;      /* and then abort the function */
+  }
+
+  /* --- skip trailing blanks --- */
+  while (isblank(c)) {          /* while character is blank, */
+    trd->last = c;              /* note the last character */
+    if (++e >= trd->end) {      /* and get the next character */
+      trd->next = e; trd->last = EOF; return trd->delim = TRD_REC; }
+    c = (unsigned char)*e;
+  }
+  if (isrecsep(c)) {            /* check for a record separator */
+    trd->next = e+1; trd->last = c; trd->rec++;
+    return trd->delim = TRD_REC;
+  }                             /* note the field separator or */
+  if (isfldsep(c)) { trd->next = e+1; trd->last = c; }
+  else               trd->next = e;  /* leave the last character */
+  return trd->delim = TRD_FLD;  /* return the delimiter type */
+}  /* mapread() */
+
+/* This function mirrors trd_read() (see below), but works directly */
+/* on the mapped file: separators are located with a block scan     */
+/* (SSE2 if available) instead of reading character by character.  */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+static void release (TABREAD *trd)
+{                               /* --- release the current input */
+  #ifdef TRD_THREADS            /* if read-ahead is possible, */
+  ringstop(trd);                /* stop the reader thread */
+  #endif
+  #ifdef TRD_ZLIB               /* if compressed input is possible, */
+  if (trd->gz) { gzclose((gzFile)trd->gz); trd->gz = NULL; }
+  #endif                        /* close the zlib stream */
+  #ifdef TRD_MMAP               /* if memory mapping is possible, */
+  unmap(trd);                   /* unmap the input file */
+  #endif
+}  /* release() */
+
 /*----------------------------------------------------------------------
   Functions
 ----------------------------------------------------------------------*/
@@ -63,8 +425,15 @@ TABREAD* trd_create (void)
   trd->file  = NULL;            /* clear the file */
   trd->name  = NULL;            /* and   its name */
   trd->delim = trd->last = TRD_EOF;
-  trd->next  = trd->end  = trd->buf;
-  trd->len   = trd->field[0] = 0;    /* current field is empty */
+  trd->beg   = trd->next = trd->end = trd->buf;
+  trd->map   = NULL;            /* no memory mapped file yet */
+  trd->msize = 0;
+  trd->ring  = NULL;            /* no read-ahead buffers */
+  trd->rcnt  = 0;
+  trd->rsize = TRD_RINGSIZE;
+  trd->gz    = NULL;            /* no compressed input */
+  trd->fld   = trd->field;      /* current field is empty */
+  trd->len   = trd->field[0] = 0;
   trd->rec   = 1;               /* current record is the first */
   trd->pos   = 0;               /* position is before first field */
   memset(trd->flags, 0, sizeof(trd->flags));
@@ -74,7 +443,8 @@ TABREAD* trd_create (void)
   trd->flags[',' ] = TRD_FLDSEP;
   trd->flags['?' ] = trd->flags['*'] = TRD_NULL;
   trd->flags['#' ] = TRD_COMMENT;
-  return trd;                   /* set default character flags */
+  sepset(trd);                  /* set default character flags */
+  return trd;                   /* and collect the separators */
 }  /* trd_create() */           /* return created table reader */
 
 /*--------------------------------------------------------------------*/
@@ -84,6 +454,7 @@ int trd_delete (TABREAD *trd, int close)
   int r = 0;                    /* result of fclose() */
 
   assert(trd);                  /* check the function argument */
+  release(trd);                 /* release the input file */
   if (close && trd->file && (trd->file != stdin))
     r = fclose(trd->file);      /* close the input file and */
   free(trd);                    /* delete the table reader */
@@ -94,7 +465,10 @@ int trd_delete (TABREAD *trd, int close)
 
 int trd_open (TABREAD *trd, FILE *file, const char *name)
 {                               /* --- open a new file */
+  int m = 0;                    /* whether to map the file */
+
   assert(trd);                  /* check the function arguments */
+  release(trd);                 /* release a previous input file */
   if (file) {                   /* if a file is given directly, */
     if      (name)          trd->name = name; /* store the name */
     else if (file == stdin) trd->name = "<stdin>";
@@ -104,11 +478,34 @@ int trd_open (TABREAD *trd, FILE *file, const char *name)
   else {                        /* if a proper file name is given */
     file = fopen(trd->name = name, "rb");
     if (!file) return -2;       /* open file with given name */
-  }                             /* and check for an error */
+    m = 1;                      /* and check for an error */
+  }                             /* (only own files are mapped) */
   trd->file  = file;            /* store the new input file */
   trd->delim = trd->last = TRD_EOF;
-  trd->next  = trd->end  = trd->buf;
-  trd->len   = trd->field[0] = 0;    /* current field is empty */
+  trd->beg   = trd->next = trd->end = trd->buf;
+  #ifdef TRD_MMAP               /* if memory mapping is possible, */
+  if (m) map(trd);              /* try to map a regular file */
+  #endif
+  (void)m;                      /* (otherwise read with buffer) */
+  #ifdef TRD_ZLIB               /* if compressed input is possible */
+  if (!trd->map) {              /* and the file is not mapped */
+    int fd = dup(fileno(file)); /* read through a zlib stream */
+    if (fd >= 0) {              /* on a copy of the descriptor */
+      trd->gz = gzdopen(fd, "rb");
+      if (!trd->gz) close(fd);  /* (on failure read the file */
+    }                           /* without zlib) */
+    #if ZLIB_VERNUM >= 0x1240   /* if the buffer size can be set, */
+    if (trd->gz) gzbuffer((gzFile)trd->gz, TRD_BUFSIZE);
+    #endif                      /* use a larger input buffer */
+  }
+  #endif
+  #ifdef TRD_THREADS            /* if read-ahead is possible */
+  if (!trd->map && (trd->rcnt > 0))
+    ringstart(trd);             /* start a reader thread */
+  #endif                        /* (a mapped file needs none) */
+  sepset(trd);                  /* collect the separators */
+  trd->fld   = trd->field;      /* current field is empty */
+  trd->len   = trd->field[0] = 0;
   trd->rec   = 1;               /* current record is the first */
   trd->pos   = 0;               /* before first field */
   return 0;                     /* return 'ok' */
@@ -121,6 +518,7 @@ int trd_close (TABREAD *trd)
   int r;                        /* result of fclose() */
 
   assert(trd);                  /* check the function arguments */
+  release(trd);                 /* release the input file */
   if (!trd->file) return 0;     /* close the current input file */
   r = (trd->file != stdin) ? fclose(trd->file) : 0;
   trd->file = NULL;             /* clear the file (but keep the name) */
@@ -142,6 +540,7 @@ void trd_chars (TABREAD *trd, int type, const char *chars)
   type &= ~TRD_ADD;             /* remove the flag for adding */
   for (s = (char*)chars; *s; )  /* set the character flags */
     trd->flags[esc_decode(s, &s)] |= type;
+  sepset(trd);                  /* collect the separators */
 }  /* trd_chars() */
 
 /*--------------------------------------------------------------------*/
@@ -160,15 +559,43 @@ void trd_allchs (TABREAD *trd,        const char *recseps,
 
 /*--------------------------------------------------------------------*/
 
+int trd_prefetch (TABREAD *trd, int cnt, size_t size)
+{                               /* --- set read-ahead buffers */
+  assert(trd);                  /* check the function arguments */
+  trd->rcnt  = (cnt > 0) ? ((cnt < 2) ? 2 : cnt) : 0;
+  trd->rsize = (size > 0) ? size : TRD_RINGSIZE;
+  #ifdef TRD_THREADS            /* note number and size of buffers */
+  return 0;                     /* (used on the next trd_open()) */
+  #else                         /* if there are no threads, */
+  return (cnt > 0) ? 1 : 0;     /* read-ahead is not available */
+  #endif
+}  /* trd_prefetch() */
+
+/* A reader thread is only started for input that is not memory  */
+/* mapped, that is, for pipes and other non-regular files as well */
+/* as for compressed files. It has no effect on trd_split().      */
+
+/*--------------------------------------------------------------------*/
+
 int trd_getc (TABREAD *trd)
 {                               /* --- get the next character */
   assert(trd && trd->file);     /* check the function arguments */
   if (trd->next >= trd->end) {  /* if no more characters available */
-    int n = fread(trd->buf, sizeof(char), TRD_BUFSIZE, trd->file);
-    if (n <= 0) return ferror(trd->file) ? TRD_ERR : TRD_EOF;
+    long n;                     /* number of characters read */
+    if (trd->map) return TRD_EOF;    /* (mapped file is complete) */
+    #ifdef TRD_THREADS          /* if there is a reader thread, */
+    if (trd->ring) {            /* get the next filled buffer */
+      if ((n = ringnext(trd)) < 0) return (int)n; }
+    else {                      /* if there is no reader thread */
+    #endif
+    n = fill(trd, trd->buf, TRD_BUFSIZE);
+    if (n <= 0) return (n < 0) ? TRD_ERR : TRD_EOF;
     trd->next = trd->buf;       /* read a new block from the file */
     trd->end  = trd->buf +n;    /* set pointer to next character */
-  }                             /* and to the end of the buffer */
+    #ifdef TRD_THREADS          /* and to the end of the buffer */
+    }
+    #endif
+  }
   return (unsigned char)*trd->next++;
 }  /* trd_getc() */             /* return the next character */
 
@@ -177,8 +604,83 @@ int trd_getc (TABREAD *trd)
 int trd_ungetc (TABREAD *trd, int c)
 {                               /* --- push back a character */
   assert(trd);                  /* check the function arguments */
-  return (trd->next > trd->buf) ? *--trd->next = c : EOF;
-}  /* trd_ungetc() */
+  if (trd->next <= trd->beg) return EOF;
+  if (!trd->map) return *--trd->next = (char)c;
+  return (trd->next[-1] == (char)c) ? *--trd->next : EOF;
+}  /* trd_ungetc() */           /* (a mapped file is read-only) */
+
+/*--------------------------------------------------------------------*/
+
+int trd_split (TABREAD *trd, TABREAD **parts, int n)
+{                               /* --- split input into parts */
+  #ifdef TRD_MMAP               /* if memory mapping is possible */
+  int     i, k;                 /* loop variables */
+  size_t  z;                    /* size of the remaining input */
+  char    *s, *e;               /* start and end of a part */
+  TABREAD *p;                   /* to traverse the parts */
+
+  assert(trd && parts && (n > 0));   /* check the function arguments */
+  if (!trd->map                 /* only a mapped file can be split */
+  ||  (trd->delim == TRD_FLD))  /* and only at the start of a record */
+    return 0;
+  z = (size_t)(trd->end -trd->next);
+  if (z /(size_t)n < TRD_BUFSIZE)   /* do not create parts */
+    n = (int)(z /TRD_BUFSIZE);  /* that are smaller than a buffer */
+  if (n < 2) return 0;          /* check for a sensible split */
+  for (s = trd->next, k = 0; k < n; k++) {
+    if (k >= n-1) e = trd->end; /* the last part takes the rest */
+    else {                      /* find the end of the other parts */
+      e = trd->next +(size_t)((double)z *(k+1) /n);
+      if (e < s) e = s;         /* start at the proportional size */
+      while ((e < trd->end) && !isrecsep((unsigned char)*e))
+        e++;                    /* and go to the end of the record */
+      if (e < trd->end) e++;    /* (parts start at a record, */
+    }                           /* so that comments are recognized) */
+    parts[k] = p = (TABREAD*)malloc(sizeof(TABREAD));
+    if (!p) {                   /* create a reader for the part */
+      for (i = 0; i < k; i++) free(parts[i]);
+      return -1;                /* on failure delete the readers */
+    }                           /* and abort the function */
+    p->file  = trd->file;       /* share the file and its name */
+    p->name  = trd->name;       /* (a part does not own the file) */
+    p->delim = p->last = TRD_EOF;
+    p->map   = p->beg = p->next = s;  /* refer to part of the map */
+    p->end   = e;  s = e;       /* (since the size is zero, */
+    p->msize = 0;               /* the part is never unmapped) */
+    p->ring  = NULL; p->rcnt = 0; p->rsize = trd->rsize;
+    p->gz    = NULL;            /* a part is never read ahead */
+    p->fld   = p->field;        /* current field is empty */
+    p->len   = p->field[0] = 0;
+    p->rec   = 1;               /* record numbers are relative */
+    p->pos   = 0;               /* to the start of the part */
+    memcpy(p->flags, trd->flags, sizeof(trd->flags));
+    memcpy(p->seps,  trd->seps,  sizeof(trd->seps));
+    p->nsep  = trd->nsep;       /* copy the character flags */
+  }                             /* and the separators */
+  trd->next = trd->end;         /* the input is passed to the parts */
+  return n;                     /* return the number of parts */
+  #else                         /* if only buffered reading, */
+  return 0;                     /* the input cannot be split */
+  #endif
+}  /* trd_split() */
+
+/* The parts are read with trd_read() like any other reader and are */
+/* deleted with trd_delete(part, 0). They must not outlive the file */
+/* reader, because they refer to its memory map.                   */
+
+/*--------------------------------------------------------------------*/
+
+void trd_join (TABREAD *trd, TABREAD *part, int recs)
+{                               /* --- take over the state of a part */
+  assert(trd && part && (recs >= 0));
+  trd->rec   = part->rec +recs; /* make the record number absolute */
+  trd->pos   = part->pos;       /* and copy the field position */
+  trd->delim = part->delim;     /* and the last delimiter/character */
+  trd->last  = part->last;
+  trd->len   = part->len;       /* copy the current field */
+  memcpy(trd->field, part->fld, (size_t)part->len+1);
+  trd->fld   = trd->field;
+}  /* trd_join() */             /* (e.g. for error messages) */
 
 /*--------------------------------------------------------------------*/
 
@@ -189,8 +691,12 @@ int trd_read (TABREAD *trd)
 
   /* --- initialize --- */
   assert(trd && trd->file);     /* check the function arguments */
+  #ifdef TRD_MMAP               /* if the input file is mapped, */
+  if (trd->map) return mapread(trd);   /* use the fast version */
+  #endif
   trd->pos = (trd->delim == TRD_FLD) ? trd->pos+1 : 1;
-  trd->field[0] = trd->len = 0; /* clear the current field */
+  trd->fld = trd->field;        /* clear the current field */
+  trd->field[0] = trd->len = 0;
   GETC(trd, c, TRD_EOF);        /* get the first character */
 
   /* --- skip comment records --- */
@@ -50,6 +50,8 @@
 /* --- buffer size --- */
 #define TRD_BUFSIZE  65536      /* size of internal read buffer */
 #define TRD_MAXLEN    1024      /* maximum length of a field */
+#define TRD_SEPMAX       8      /* maximum number of separators */
+#define TRD_RINGSIZE (1 << 20)  /* size of a read-ahead buffer */
 
 #define TRD_FPOS(r)  trd_name(r), trd_rec(r), trd_pos(r)
 #define TRD_INFO(r)  trd_name(r), trd_rec(r), trd_pos(r), trd_field(r)
@@ -67,8 +69,18 @@ typedef struct {                /* --- table reader --- */
   int   pos;                    /* number of current field */
   char  *next;                  /* next character to read */
   char  *end;                   /* current end of the buffer */
+  char  *beg;                   /* start of the current buffer */
+  char  *map;                   /* memory mapped file (if any) */
+  size_t msize;                 /* size of the memory mapped file */
+  struct trdring *ring;         /* read-ahead buffers (if any) */
+  int   rcnt;                   /* number of read-ahead buffers */
+  size_t rsize;                 /* size of a read-ahead buffer */
+  void  *gz;                    /* compressed input (if any) */
+  char  *fld;                   /* current field (buffer or map) */
+  int   nsep;                   /* number of separator characters */
+  char  seps[TRD_SEPMAX];       /* separators (for fast scanning) */
   int   flags[256];             /* character flags */
-  char  field[TRD_MAXLEN+4];    /* current field */
+  char  field[TRD_MAXLEN+4];    /* buffer for the current field */
   char  buf  [TRD_BUFSIZE];     /* read buffer */
 } TABREAD;                      /* (table reader) */
 
@@ -90,9 +102,14 @@ extern void     trd_copy   (TABREAD *dst, const TABREAD *src);
 extern int      trd_istype (const TABREAD *trd, int c, int type);
 extern int      trd_type   (const TABREAD *trd, int c);
 
+extern int      trd_prefetch (TABREAD *trd, int cnt, size_t size);
+
 extern int      trd_getc   (TABREAD *trd);
 extern int      trd_ungetc (TABREAD *trd, int c);
 
+extern int      trd_split  (TABREAD *trd, TABREAD **parts, int n);
+extern void     trd_join   (TABREAD *trd, TABREAD *part, int recs);
+
 extern int      trd_read   (TABREAD *trd);
 extern char*    trd_field  (TABREAD *trd);
 extern int      trd_len    (TABREAD *trd);
@@ -112,7 +129,7 @@ extern int      trd_pos    (TABREAD *trd);
 #define trd_istype(r,c,t)  ((r)->flags[(unsigned char)(c)] & (t))
 #define trd_type(r,c)      ((r)->flags[(unsigned char)(c)])
 
-#define trd_field(r)       ((r)->field)
+#define trd_field(r)       ((r)->fld)
 #define trd_len(r)         ((r)->len)
 #define trd_last(r)        ((r)->last)
 #define trd_delim(r)       ((r)->delim)